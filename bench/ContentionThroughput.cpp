@@ -0,0 +1,99 @@
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <cxxopts.hpp>
+
+#include <afina/Storage.h>
+
+#include "storage/FlatCombinedLRU.h"
+#include "storage/SharedClockLRU.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+
+namespace {
+
+// Runs ops operations from every thread, returns operations per second of all threads together
+double run(Afina::Storage &storage, size_t n_threads, size_t ops, size_t keys, size_t writes) {
+    std::atomic<bool> go(false);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < n_threads; t++) {
+        threads.emplace_back([&, t]() {
+            std::string value(32, 'v');
+            std::string out;
+            while (!go.load()) {
+            }
+            for (size_t i = 0; i < ops; i++) {
+                std::string key = "key" + std::to_string((i * 7919 + t * 104729) % keys);
+                if (i % 100 < writes) {
+                    storage.Put(key, value);
+                } else {
+                    storage.Get(key, out);
+                }
+            }
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    go.store(true);
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return n_threads * ops / elapsed.count();
+}
+
+} // namespace
+
+/**
+ * Hammers a single SimpleLRU from growing number of threads, through the global mutex (mt_lru), through
+ * flat combining (mt_fc_lru) and through reader-writer lock (mt_shared_clock), and prints operations per second
+ * of each. With one or two threads mutex is cheaper, once threads start to queue up on it the combiner wins.
+ * Reader-writer lock pays off on read mostly load only.
+ *
+ * ./bench/contentionThroughput --writes 100 --threads 16
+ * ./bench/contentionThroughput --writes 5 --threads 16
+ */
+int main(int argc, char **argv) {
+    cxxopts::Options options("contentionThroughput", "Compares global mutex, flat combining and rw lock under contention");
+    options.add_options()("threads", "Maximum number of threads", cxxopts::value<size_t>()->default_value("16"));
+    options.add_options()("ops", "Number of operations per thread", cxxopts::value<size_t>()->default_value("200000"));
+    options.add_options()("keys", "Number of distinct keys", cxxopts::value<size_t>()->default_value("10000"));
+    options.add_options()("writes", "Percent of writes", cxxopts::value<size_t>()->default_value("50"));
+    options.add_options()("h,help", "Print usage info");
+
+    try {
+        options.parse(argc, argv);
+        if (options.count("help") > 0) {
+            std::cerr << options.help() << std::endl;
+            return 0;
+        }
+
+        size_t max_threads = options["threads"].as<size_t>();
+        size_t ops = options["ops"].as<size_t>();
+        size_t keys = options["keys"].as<size_t>();
+        size_t writes = options["writes"].as<size_t>();
+        size_t memory = keys * 256;
+
+        std::cerr << std::setw(10) << "threads" << std::setw(14) << "mutex ops/s" << std::setw(14) << "fc ops/s"
+                  << std::setw(14) << "rw ops/s" << std::endl;
+        for (size_t n = 1; n <= max_threads; n *= 2) {
+            Afina::Backend::ThreadSafeSimplLRU locked(memory);
+            Afina::Backend::FlatCombinedLRU combined(memory);
+            Afina::Backend::SharedClockLRU shared(memory);
+            double mutex_rate = run(locked, n, ops, keys, writes);
+            double fc_rate = run(combined, n, ops, keys, writes);
+            double rw_rate = run(shared, n, ops, keys, writes);
+            std::cerr << std::setw(10) << n << std::setw(14) << std::fixed << std::setprecision(0) << mutex_rate
+                      << std::setw(14) << fc_rate << std::setw(14) << rw_rate << std::endl;
+        }
+    } catch (std::exception &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <cxxopts.hpp>
+
+#include <afina/Storage.h>
+
+#include "storage/RCUClock.h"
+#include "storage/SimpleLRU.h"
+#include "storage/TinyLFU.h"
+
+/**
+ * Replays trace of requests against each storage in cache-aside manner: get the key, on miss put it
+ * with value of the requested size. Prints share of requests served from cache.
+ *
+ * Trace is a text file, one request per line: "<key> [<value size>]". Without trace synthetic one
+ * with zipfian key popularity is generated.
+ *
+ * Note that rcu_clock budget counts key and value bytes only, while SimpleLRU pays for node headers
+ * and allocator slack as well.
+ */
+struct Request {
+    std::string key;
+    size_t size;
+};
+
+std::vector<Request> load_trace(const std::string &path, size_t default_size) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Failed to open trace " + path);
+    }
+
+    std::vector<Request> trace;
+    std::string key;
+    while (in >> key) {
+        size_t size = default_size;
+        if (in.peek() == ' ') {
+            in >> size;
+        }
+        trace.push_back(Request{key, size});
+    }
+    return trace;
+}
+
+std::vector<Request> zipf_trace(size_t keys, size_t requests, double skew, size_t size) {
+    // Cumulative distribution of key ranks
+    std::vector<double> cdf(keys);
+    double sum = 0;
+    for (size_t i = 0; i < keys; i++) {
+        sum += 1.0 / std::pow(i + 1, skew);
+        cdf[i] = sum;
+    }
+
+    std::mt19937_64 rnd(42);
+    std::uniform_real_distribution<double> uniform(0, sum);
+    std::vector<Request> trace;
+    trace.reserve(requests);
+    for (size_t i = 0; i < requests; i++) {
+        size_t rank = std::lower_bound(cdf.begin(), cdf.end(), uniform(rnd)) - cdf.begin();
+        trace.push_back(Request{"key" + std::to_string(rank), size});
+    }
+    return trace;
+}
+
+double replay(Afina::Storage &storage, const std::vector<Request> &trace) {
+    size_t hits = 0;
+    std::string value;
+    for (auto &request : trace) {
+        if (storage.Get(request.key, value)) {
+            hits++;
+        } else {
+            storage.Put(request.key, std::string(request.size, 'v'));
+        }
+    }
+    return trace.empty() ? 0 : double(hits) / trace.size();
+}
+
+int main(int argc, char **argv) {
+    cxxopts::Options options("hitRatio", "Compares hit ratio of eviction policies on a trace");
+    options.add_options()("t,trace", "Trace file, synthetic zipf trace is used if not given",
+                          cxxopts::value<std::string>());
+    options.add_options()("m,memory", "Memory budget of each storage in bytes",
+                          cxxopts::value<size_t>()->default_value("1048576"));
+    options.add_options()("size", "Value size for requests without one",
+                          cxxopts::value<size_t>()->default_value("100"));
+    options.add_options()("keys", "Number of keys in synthetic trace",
+                          cxxopts::value<size_t>()->default_value("100000"));
+    options.add_options()("requests", "Number of requests in synthetic trace",
+                          cxxopts::value<size_t>()->default_value("1000000"));
+    options.add_options()("skew", "Zipf skew of synthetic trace", cxxopts::value<double>()->default_value("0.99"));
+    options.add_options()("h,help", "Print usage info");
+
+    try {
+        options.parse(argc, argv);
+        if (options.count("help") > 0) {
+            std::cerr << options.help() << std::endl;
+            return 0;
+        }
+
+        size_t memory = options["memory"].as<size_t>();
+        size_t size = options["size"].as<size_t>();
+
+        std::vector<Request> trace;
+        if (options.count("trace") > 0) {
+            trace = load_trace(options["trace"].as<std::string>(), size);
+        } else {
+            trace = zipf_trace(options["keys"].as<size_t>(), options["requests"].as<size_t>(),
+                               options["skew"].as<double>(), size);
+        }
+
+        using Afina::Backend::EvictionPolicy;
+        std::vector<std::pair<std::string, std::unique_ptr<Afina::Storage>>> storages;
+        storages.emplace_back("lru", std::unique_ptr<Afina::Storage>(
+                                         new Afina::Backend::SimpleLRU(memory, EvictionPolicy::Type::kLRU)));
+        storages.emplace_back("clock", std::unique_ptr<Afina::Storage>(
+                                           new Afina::Backend::SimpleLRU(memory, EvictionPolicy::Type::kCLOCK)));
+        storages.emplace_back("tinylfu", std::unique_ptr<Afina::Storage>(new Afina::Backend::TinyLFU(memory)));
+        storages.emplace_back("rcu_clock", std::unique_ptr<Afina::Storage>(new Afina::Backend::RCUClock(memory)));
+
+        std::cout << "requests: " << trace.size() << ", memory: " << memory << std::endl;
+        for (auto &storage : storages) {
+            std::cout << std::setw(10) << storage.first << " hit ratio: " << std::fixed << std::setprecision(4)
+                      << replay(*storage.second, trace) << std::endl;
+        }
+    } catch (std::exception &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
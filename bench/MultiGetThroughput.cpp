@@ -0,0 +1,104 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <cxxopts.hpp>
+
+#include <afina/Storage.h>
+
+#include "storage/RCUClock.h"
+#include "storage/ShardedLRU.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+
+/**
+ * Looks up batches of 1 to 1000 keys and prints keys per second of two ways to do it: Get of every key
+ * one by one, that takes a lock per key, and MultiGet of the whole batch, that groups keys by lock and
+ * prefetches index slots ahead of lookups.
+ *
+ * ./bench/multiGetThroughput --storage sharded --shards 16
+ */
+int main(int argc, char **argv) {
+    cxxopts::Options options("multiGetThroughput", "Compares per-key Get and MultiGet for different batch sizes");
+    options.add_options()("s,storage", "Storage to use: sharded, locked or rcu",
+                          cxxopts::value<std::string>()->default_value("sharded"));
+    options.add_options()("shards", "Number of shards of the sharded storage",
+                          cxxopts::value<size_t>()->default_value("16"));
+    options.add_options()("keys", "Number of distinct keys", cxxopts::value<size_t>()->default_value("100000"));
+    options.add_options()("lookups", "Number of keys looked up per batch size",
+                          cxxopts::value<size_t>()->default_value("2000000"));
+    options.add_options()("h,help", "Print usage info");
+
+    try {
+        options.parse(argc, argv);
+        if (options.count("help") > 0) {
+            std::cerr << options.help() << std::endl;
+            return 0;
+        }
+
+        std::string type = options["storage"].as<std::string>();
+        size_t keys = options["keys"].as<size_t>();
+        size_t lookups = options["lookups"].as<size_t>();
+
+        // Room for every key, so that all lookups hit
+        size_t memory = keys * 256;
+        std::unique_ptr<Afina::Storage> storage;
+        if (type == "sharded") {
+            storage.reset(new Afina::Backend::ShardedLRU(memory, options["shards"].as<size_t>()));
+        } else if (type == "locked") {
+            storage.reset(new Afina::Backend::ThreadSafeSimplLRU(memory));
+        } else if (type == "rcu") {
+            storage.reset(new Afina::Backend::RCUClock(memory));
+        } else {
+            throw std::runtime_error("Unknown storage " + type);
+        }
+
+        std::vector<std::string> names;
+        names.reserve(keys);
+        for (size_t i = 0; i < keys; i++) {
+            names.push_back("key" + std::to_string(i * 7919 % keys));
+            storage->Put(names.back(), "value of the key\r\n");
+        }
+
+        size_t hits = 0;
+        Afina::Storage::MultiGetCallback found = [&hits](size_t, Afina::ValueRef &, const Afina::ItemMeta &) {
+            hits++;
+        };
+
+        std::cerr << std::setw(10) << "batch" << std::setw(14) << "get keys/s" << std::setw(16) << "multiget keys/s"
+                  << std::endl;
+        for (size_t batch : {1, 10, 100, 1000}) {
+            size_t batches = lookups / batch;
+
+            auto start = std::chrono::steady_clock::now();
+            Afina::ValueRef value;
+            Afina::ItemMeta meta;
+            for (size_t b = 0; b < batches; b++) {
+                const std::string *first = &names[b * batch % (keys - batch + 1)];
+                for (size_t i = 0; i < batch; i++) {
+                    hits += storage->Get(first[i], value, meta);
+                }
+            }
+            std::chrono::duration<double> single = std::chrono::steady_clock::now() - start;
+
+            start = std::chrono::steady_clock::now();
+            for (size_t b = 0; b < batches; b++) {
+                storage->MultiGet(&names[b * batch % (keys - batch + 1)], batch, found);
+            }
+            std::chrono::duration<double> multi = std::chrono::steady_clock::now() - start;
+
+            std::cerr << std::setw(10) << batch << std::setw(14) << std::fixed << std::setprecision(0)
+                      << batches * batch / single.count() << std::setw(16) << batches * batch / multi.count()
+                      << std::endl;
+        }
+        if (hits != 2 * (lookups / 1 + lookups / 10 * 10 + lookups / 100 * 100 + lookups / 1000 * 1000)) {
+            std::cerr << "Some lookups missed: " << hits << std::endl;
+        }
+    } catch (std::exception &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include <cxxopts.hpp>
+
+#include "protocol/Parser.h"
+
+/**
+ * Parses a pipelined stream of set and get commands the way connections do and prints parser throughput
+ * in bytes per second. Values are skipped without being looked at, so only command lines are measured.
+ *
+ * Input is fed in pieces of --chunk bytes. Command lines that arrive completely go through the vectorized
+ * fast path, split ones through the byte by byte state machine, so --chunk 1 shows the state machine alone:
+ *
+ * ./bench/parserThroughput --chunk 1
+ */
+int main(int argc, char **argv) {
+    cxxopts::Options options("parserThroughput", "Measures memcached parser throughput");
+    options.add_options()("chunk", "Bytes given to the parser at once",
+                          cxxopts::value<size_t>()->default_value("4096"));
+    options.add_options()("key", "Key size in bytes", cxxopts::value<size_t>()->default_value("32"));
+    options.add_options()("get-keys", "Keys per get command", cxxopts::value<size_t>()->default_value("4"));
+    options.add_options()("commands", "Number of commands in the stream",
+                          cxxopts::value<size_t>()->default_value("100000"));
+    options.add_options()("rounds", "Number of times stream is parsed", cxxopts::value<size_t>()->default_value("20"));
+    options.add_options()("h,help", "Print usage info");
+
+    try {
+        options.parse(argc, argv);
+        if (options.count("help") > 0) {
+            std::cerr << options.help() << std::endl;
+            return 0;
+        }
+
+        size_t chunk = std::max<size_t>(1, options["chunk"].as<size_t>());
+        size_t key_size = options["key"].as<size_t>();
+        size_t get_keys = options["get-keys"].as<size_t>();
+        size_t commands = options["commands"].as<size_t>();
+        size_t rounds = options["rounds"].as<size_t>();
+
+        // Half sets with short values, half multi-key gets
+        std::string stream;
+        for (size_t i = 0; i < commands; i++) {
+            std::string key = std::to_string(i);
+            key.resize(std::max(key_size, key.size()), 'k');
+            if (i % 2 == 0) {
+                stream += "set " + key + " 0 0 5\r\nvalue\r\n";
+            } else {
+                stream += "get";
+                for (size_t k = 0; k < get_keys; k++) {
+                    stream += " " + key;
+                }
+                stream += "\r\n";
+            }
+        }
+
+        Afina::Protocol::Parser parser;
+        size_t parsed_commands = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t round = 0; round < rounds; round++) {
+            size_t arg_remains = 0;
+            for (size_t pos = 0; pos < stream.size();) {
+                size_t size = std::min(chunk, stream.size() - pos);
+                if (arg_remains > 0) {
+                    size_t skip = std::min(arg_remains, size);
+                    arg_remains -= skip;
+                    pos += skip;
+                    continue;
+                }
+
+                size_t parsed = 0;
+                if (parser.Parse(stream.data() + pos, size, parsed)) {
+                    parser.Build(arg_remains);
+                    if (arg_remains > 0) {
+                        arg_remains += 2;
+                    }
+                    parser.Reset();
+                    parsed_commands++;
+                }
+                pos += parsed;
+            }
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        double bytes = double(stream.size()) * rounds;
+        std::cerr << std::setw(10) << "chunk" << std::setw(14) << "commands/s" << std::setw(12) << "MB/s"
+                  << std::endl;
+        std::cerr << std::setw(10) << chunk << std::setw(14) << std::fixed << std::setprecision(0)
+                  << parsed_commands / elapsed.count() << std::setw(12) << std::setprecision(1)
+                  << bytes / elapsed.count() / (1 << 20) << std::endl;
+    } catch (std::exception &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
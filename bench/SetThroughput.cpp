@@ -0,0 +1,80 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <cxxopts.hpp>
+
+#include <afina/execute/Set.h>
+
+#include "storage/SimpleLRU.h"
+
+/**
+ * Runs set command against SimpleLRU for values of growing size and prints throughput of each size.
+ * Without logging on the path the cost of the command is the storage work, so that requests per second
+ * barely move until memcpy of the value starts to matter.
+ *
+ * With --legacy every command also prints itself to stdout the way commands used to do, that shows how
+ * logging of the value made throughput depend on its size. Results go to stderr, so redirect stdout:
+ *
+ * ./bench/setThroughput --legacy > /dev/null
+ */
+int main(int argc, char **argv) {
+    cxxopts::Options options("setThroughput", "Measures set command throughput for different value sizes");
+    options.add_options()("m,memory", "Memory budget of the storage in bytes",
+                          cxxopts::value<size_t>()->default_value("67108864"));
+    options.add_options()("keys", "Number of distinct keys", cxxopts::value<size_t>()->default_value("1000"));
+    options.add_options()("requests", "Number of set commands per value size",
+                          cxxopts::value<size_t>()->default_value("200000"));
+    options.add_options()("legacy", "Print every command to stdout with the value, as commands used to do");
+    options.add_options()("h,help", "Print usage info");
+
+    try {
+        options.parse(argc, argv);
+        if (options.count("help") > 0) {
+            std::cerr << options.help() << std::endl;
+            return 0;
+        }
+
+        size_t memory = options["memory"].as<size_t>();
+        size_t keys = options["keys"].as<size_t>();
+        size_t requests = options["requests"].as<size_t>();
+        bool legacy = options.count("legacy") > 0;
+
+        // Commands reference keys, so those are kept aside
+        std::vector<std::string> names;
+        std::vector<Afina::Execute::Set> commands;
+        names.reserve(keys);
+        commands.reserve(keys);
+        for (size_t i = 0; i < keys; i++) {
+            names.push_back("key" + std::to_string(i));
+            commands.emplace_back(names.back(), 0, 0);
+        }
+
+        std::cerr << std::setw(10) << "size" << std::setw(14) << "requests/s" << std::setw(12) << "MB/s" << std::endl;
+        for (size_t size = 16; size <= 65536; size *= 4) {
+            Afina::Backend::SimpleLRU storage(memory);
+            std::string value(size, 'v');
+            std::string out;
+
+            auto start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < requests; i++) {
+                Afina::Execute::Set &command = commands[i % keys];
+                if (legacy) {
+                    std::cout << "Set(" << command.key() << "): " << value << std::endl;
+                }
+                command.Execute(storage, value, out);
+            }
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+            double rate = requests / elapsed.count();
+            std::cerr << std::setw(10) << size << std::setw(14) << std::fixed << std::setprecision(0) << rate
+                      << std::setw(12) << std::setprecision(1) << rate * size / (1 << 20) << std::endl;
+        }
+    } catch (std::exception &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
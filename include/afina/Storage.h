@@ -1,15 +1,53 @@
 #ifndef AFINA_STORAGE_H
 #define AFINA_STORAGE_H
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <string>
 
+#include <afina/ValueRef.h>
+
 namespace Afina {
 
+/**
+ * # Metadata of the stored item
+ * Storage keeps it in the fixed size header next to the key and value
+ */
+struct ItemMeta {
+    ItemMeta() : flags(0), deadline(0), cas(0) {}
+
+    // Opaque client flags
+    uint32_t flags;
+
+    // Absolute unix time item expires at, 0 if it never expires. Could be passed back as exptime
+    uint32_t deadline;
+
+    // Version of the item, changes on every update of the key
+    uint64_t cas;
+};
+
 /**
  *
  */
 class Storage {
 public:
+    /**
+     * Receives items found by MultiGet: position of the key in the batch, reference to the value and
+     * metadata. Value could be moved out
+     */
+    using MultiGetCallback = std::function<void(size_t index, ValueRef &value, const ItemMeta &meta)>;
+
+    /**
+     * Gets copy of the value found by Modify and changes it in place, returns false to leave the item as is
+     */
+    using ModifyCallback = std::function<bool(std::string &value)>;
+
+    /**
+     * Outcome of CompareAndSet
+     */
+    enum class CasResult { kStored, kExists, kNotFound, kNotStored };
+
     Storage() {}
     virtual ~Storage() {}
 
@@ -56,6 +94,36 @@ public:
      */
     virtual bool Set(const std::string &key, const std::string &value) = 0;
 
+    /**
+     * Same as Put, but association carries metadata. Storage that doesn't support some of it ignores
+     * the rest: flags are returned as 0, association is kept until it gets evicted.
+     *
+     * @param key to be associated with value
+     * @param value to be assigned for the key
+     * @param flags opaque client flags, returned by Get as is
+     * @param expire memcached exptime: 0 means never, up to 30 days it is number of seconds from now,
+     * otherwise absolute unix time. Negative or past time makes association expired immediately
+     */
+    virtual bool Put(const std::string &key, const std::string &value, uint32_t flags, int32_t expire) {
+        return Put(key, value);
+    }
+
+    /**
+     * Same as PutIfAbsent, but association carries metadata, see Put above. Expired association is
+     * treated as absent
+     */
+    virtual bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t flags, int32_t expire) {
+        return PutIfAbsent(key, value);
+    }
+
+    /**
+     * Same as Set, but association carries metadata, see Put above. Expired association is treated
+     * as absent
+     */
+    virtual bool Set(const std::string &key, const std::string &value, uint32_t flags, int32_t expire) {
+        return Set(key, value);
+    }
+
     /**
      * Removes association for the given key
      * If requested key doesn't present in storage method returns false and
@@ -84,6 +152,123 @@ public:
      * @param value output parameter to copy value to
      */
     virtual bool Get(const std::string &key, std::string &value) = 0;
+
+    /**
+     * Same as Get, but copies metadata of the association as well
+     *
+     * @param key to retrive value for
+     * @param value output parameter to copy value to
+     * @param meta output parameter to copy metadata to
+     */
+    virtual bool Get(const std::string &key, std::string &value, ItemMeta &meta) {
+        meta = ItemMeta();
+        return Get(key, value);
+    }
+
+    /**
+     * Same as Get with metadata, but instead of copying value out returns reference to the storage
+     * memory, so that value could be sent as is. Storage that can't pin its memory returns a copy: of the
+     * storages here only RCUClock references its items, slab based ones reuse chunks once lock is released
+     *
+     * @param key to retrive value for
+     * @param value output parameter to put reference to
+     * @param meta output parameter to copy metadata to
+     */
+    virtual bool Get(const std::string &key, ValueRef &value, ItemMeta &meta) {
+        std::string copy;
+        if (!Get(key, copy, meta)) {
+            return false;
+        }
+        value = ValueRef::Copy(copy.data(), copy.size());
+        return true;
+    }
+
+    /**
+     * Same as Set with metadata, but only if version of the association is still the given one. Check and
+     * update are a single step, nothing could be stored in between. Default implementation is not, storage
+     * shared by threads must override it
+     *
+     * @param cas version of the association caller has seen
+     * @return kNotFound if there is no association, kExists if version differs, kNotStored if there is no
+     * room for the new value
+     */
+    virtual CasResult CompareAndSet(const std::string &key, const std::string &value, uint32_t flags,
+                                    int32_t expire, uint64_t cas) {
+        std::string current;
+        ItemMeta meta;
+        if (!Get(key, current, meta)) {
+            return CasResult::kNotFound;
+        }
+        if (meta.cas != cas) {
+            return CasResult::kExists;
+        }
+        return Set(key, value, flags, expire) ? CasResult::kStored : CasResult::kNotStored;
+    }
+
+    /**
+     * Read-modify-write of the value in a single step, so that concurrent modifications of the key are never
+     * lost. Association keeps its flags and expiration time and gets new version. Callback runs under the
+     * storage lock, possibly on another thread, same as the one of MultiGet. Default implementation is not
+     * atomic, storage shared by threads must override it
+     *
+     * @param key to modify value of
+     * @param modify callback changing the value
+     * @return false if there is no association or new value could not be stored
+     */
+    virtual bool Modify(const std::string &key, const ModifyCallback &modify) {
+        std::string value;
+        ItemMeta meta;
+        if (!Get(key, value, meta)) {
+            return false;
+        }
+        return !modify(value) || Set(key, value, meta.flags, static_cast<int32_t>(meta.deadline));
+    }
+
+    /**
+     * Changes expiration time of the association, value, flags and version stay the same. Expiration time
+     * in the past removes the association, but it is still reported as found. Default implementation stores
+     * the value again, so it is neither atomic nor keeps the version
+     *
+     * @param key to change expiration time of
+     * @param expire new expiration time, see Put
+     * @param value optional output parameter to put reference to the value to, as Get does
+     * @param meta optional output parameter to copy updated metadata to
+     */
+    virtual bool Touch(const std::string &key, int32_t expire, ValueRef *value, ItemMeta *meta) {
+        std::string copy;
+        ItemMeta current;
+        if (!Get(key, copy, current) || !Set(key, copy, current.flags, expire)) {
+            return false;
+        }
+        if (value != nullptr) {
+            *value = ValueRef::Copy(copy.data(), copy.size());
+        }
+        if (meta != nullptr && !Get(key, copy, *meta)) {
+            *meta = current;
+        }
+        return true;
+    }
+
+    /**
+     * Looks up batch of keys at once. Callback is called for every key found, but not necessary in
+     * the order of keys: storage is free to group keys the way it takes less locks and cache misses.
+     * Key appearing in the batch twice is reported twice. Callback could be called under the storage lock,
+     * so it must not access the storage. It could also be called by another thread while the caller waits
+     * (see FlatCombinedLRU), so it must reach caller's state through its captures, never through thread_local
+     *
+     * @param keys to retrive values for
+     * @param count number of keys in the batch
+     * @param found callback to pass found items to
+     */
+    virtual void MultiGet(const std::string *keys, size_t count, const MultiGetCallback &found) {
+        ValueRef value;
+        ItemMeta meta;
+        for (size_t i = 0; i < count; i++) {
+            if (Get(keys[i], value, meta)) {
+                found(i, value, meta);
+            }
+        }
+    }
 };
 
 } // namespace Afina
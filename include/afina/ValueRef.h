@@ -0,0 +1,82 @@
+#ifndef AFINA_VALUE_REF_H
+#define AFINA_VALUE_REF_H
+
+#include <cstddef>
+#include <cstring>
+#include <utility>
+
+namespace Afina {
+
+/**
+ * # Reference to the value owned by storage
+ * Storage keeps memory of the value alive for as long as reference exists, so that value could be
+ * sent to the client right from there. Reference holds one count of the owner and drops it by the
+ * owner's callback once destroyed. References could be moved but not copied.
+ */
+class ValueRef {
+public:
+    // Drops one reference to the owner
+    using Release = void (*)(void *owner);
+
+    ValueRef() : _data(nullptr), _size(0), _owner(nullptr), _release(nullptr) {}
+    ValueRef(const char *data, size_t size, void *owner, Release release)
+        : _data(data), _size(size), _owner(owner), _release(release) {}
+    ~ValueRef() { Reset(); }
+
+    ValueRef(const ValueRef &) = delete;
+    ValueRef &operator=(const ValueRef &) = delete;
+
+    ValueRef(ValueRef &&other)
+        : _data(other._data), _size(other._size), _owner(other._owner), _release(other._release) {
+        other._owner = nullptr;
+        other.Reset();
+    }
+
+    ValueRef &operator=(ValueRef &&other) {
+        if (this != &other) {
+            Reset();
+            std::swap(_data, other._data);
+            std::swap(_size, other._size);
+            std::swap(_owner, other._owner);
+            std::swap(_release, other._release);
+        }
+        return *this;
+    }
+
+    /**
+     * Makes reference to the private copy of given bytes, for storages that can't pin their memory
+     */
+    static ValueRef Copy(const char *data, size_t size) {
+        char *copy = new char[size];
+        std::memcpy(copy, data, size);
+        return ValueRef(copy, size, copy, [](void *owner) { delete[] static_cast<char *>(owner); });
+    }
+
+    const char *data() const { return _data; }
+    size_t size() const { return _size; }
+
+    // Excludes last n bytes from the referenced range
+    void RemoveSuffix(size_t n) { _size -= n; }
+
+    // Drops reference, if there is any
+    void Reset() {
+        if (_owner != nullptr) {
+            _release(_owner);
+        }
+        _data = nullptr;
+        _size = 0;
+        _owner = nullptr;
+        _release = nullptr;
+    }
+
+private:
+    const char *_data;
+    size_t _size;
+
+    void *_owner;
+    Release _release;
+};
+
+} // namespace Afina
+
+#endif // AFINA_VALUE_REF_H
@@ -7,6 +7,13 @@ namespace Allocator {
 // to avoid expensive macros calculations and increase compile speed
 class Simple;
 
+/**
+ * Handle of the memory allocated by Simple. Handle points to the cell inside of the
+ * allocator's memory that keeps actual address of the chunk, so allocator is free to move
+ * chunk around (see Simple::defrag) and all copies of the pointer observe new location.
+ *
+ * Address returned by get() is valid up to the next call of defrag/realloc/free
+ */
 class Pointer {
 public:
     Pointer();
@@ -17,7 +24,15 @@ public:
     Pointer &operator=(const Pointer &);
     Pointer &operator=(Pointer &&);
 
-    void *get() const { return 0; }
+    void *get() const { return _cell == nullptr ? nullptr : *_cell; }
+
+private:
+    friend class Simple;
+
+    explicit Pointer(void **cell) : _cell(cell) {}
+
+    // Cell of the handle table, nullptr if pointer doesn't point anything
+    void **_cell;
 };
 
 } // namespace Allocator
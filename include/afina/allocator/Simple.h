@@ -1,8 +1,11 @@
 #ifndef AFINA_ALLOCATOR_SIMPLE_H
 #define AFINA_ALLOCATOR_SIMPLE_H
 
-#include <string>
 #include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <vector>
 
 namespace Afina {
 namespace Allocator {
@@ -18,6 +21,18 @@ class Pointer;
  * Allocator instance doesn't take ownership of wrapped memmory and do not delete it
  * on destruction. So caller must take care of resource cleaup after allocator stop
  * being needs
+ *
+ * # Slab allocator
+ * Memory is split into equal pages, each page once taken serves chunks of a single size class,
+ * sizes of classes grow geometrically (memcached style). Each class keeps list of pages that have free
+ * chunks, so allocation and free are O(1) and never touch neighbour chunks. Page which has no more
+ * chunks in use returns back to the pool and could be taken by any other class. Requests larger
+ * than a page are served by runs of consecutive pages.
+ *
+ * Handles (see Pointer) are the chunks of a special size class, those pages are taken from the end of
+ * the area and never moved.
+ *
+ * Metadata about pages lives outside of the wrapped area and is allocated once in constructor.
  */
 // TODO: Implements interface to allow usage as C++ allocators
 class Simple {
@@ -25,37 +40,164 @@ public:
     Simple(void *base, const size_t size);
 
     /**
-     * TODO: semantics
+     * Allocates chunk of at least N bytes.
+     * Throws AllocError(NoMemory) if there is no free chunk of required size class and no free page
+     * to create one
+     *
      * @param N size_t
      */
     Pointer alloc(size_t N);
 
     /**
-     * TODO: semantics
+     * Same as above, but returns empty pointer instead of throwing if memory is exhausted
+     *
+     * @param N size_t
+     */
+    Pointer alloc(size_t N, const std::nothrow_t &);
+
+    /**
+     * Changes size of the allocated chunk to be at least N bytes. If chunk is big enough already
+     * then nothing happens, otherwise content is moved into the chunk of the larger class. Empty pointer
+     * gets a fresh chunk.
+     *
+     * All copies of the pointer observe new location. Throws AllocError(NoMemory) if there is no room
+     * for the larger chunk, in a such case pointer isn't changed
+     *
      * @param p Pointer
      * @param N size_t
      */
     void realloc(Pointer &p, size_t N);
 
     /**
-     * TODO: semantics
+     * Same as above, but returns false instead of throwing if memory is exhausted
+     *
+     * @param p Pointer
+     * @param N size_t
+     */
+    bool realloc(Pointer &p, size_t N, const std::nothrow_t &);
+
+    /**
+     * Returns chunk back to the allocator and resets pointer. Free of empty pointer does nothing.
+     * Throws AllocError(InvalidFree) if pointer doesn't point to alive chunk of this allocator
+     *
      * @param p Pointer
      */
     void free(Pointer &p);
 
     /**
-     * TODO: semantics
+     * Compacts each size class: chunks of the least used pages are moved into the free slots of the
+     * most used ones, so pages that get empty return back to the pool and become available for any
+     * other size class. Large allocations are never moved
      */
     void defrag();
 
     /**
-     * TODO: semantics
+     * Returns how many bytes chunk allocated for N bytes request really takes, 0 if such
+     * request could never be satisfied
+     *
+     * @param N size_t
+     */
+    size_t chunk_size(size_t N) const;
+
+    /**
+     * Returns index of the size class that serves N bytes request, chunk freed in the class could serve any
+     * request of the same class. Requests larger than a page share the last index, size_classes() - 1
+     *
+     * @param N size_t
+     */
+    size_t size_class(size_t N) const { return N > _page_size ? _classes.size() : class_for(N); }
+
+    /**
+     * Returns number of indexes size_class could return, index 0 is never returned
+     */
+    size_t size_classes() const { return _classes.size() + 1; }
+
+    /**
+     * Finds the pages that would serve N bytes request once free and have the least chunks in use, returns
+     * addresses of those chunks. Owner frees them to make room when size class of the request has nothing
+     * to free: the rest of the area isn't touched. Chunk of the large allocation is reported by its first
+     * page. Pages of handles are never picked, so result is empty if there are no other pages
+     *
+     * @param N size_t
+     */
+    std::vector<void *> reclaim(size_t N) const;
+
+    /**
+     * Dumps state of each size class in human readable form
      */
     std::string dump() const;
 
 private:
+    // Page metadata
+    struct Page {
+        // Size class the page serves, or one of kPage* constants
+        uint16_t klass;
+
+        // Number of chunks in use, for large allocation number of pages in run
+        uint32_t used;
+
+        // Number of chunks carved out of the page so far, chunks beyond never been used yet
+        uint32_t carved;
+
+        // Chunks freed after being carved
+        void *free_list;
+
+        // Siblings in the list of the pages with free chunks of the same class
+        Page *prev;
+        Page *next;
+    };
+
+    struct SizeClass {
+        size_t size;
+        uint32_t per_page;
+
+        // Pages of the class that has free chunks
+        Page *partial;
+    };
+
+    static const uint16_t kPageFree = 0xFFFF;
+    static const uint16_t kPageLarge = 0xFFFE;
+    static const uint16_t kPageLargeTail = 0xFFFD;
+
+    // Class of handle cells, see Pointer
+    static const uint16_t kHandleClass = 0;
+
+    char *page_address(const Page *page) const { return _pages_base + ((page - &_pages[0]) << _page_shift); }
+    Page *page_of(const void *chunk) {
+        return &_pages[(static_cast<const char *>(chunk) - _pages_base) >> _page_shift];
+    }
+    bool is_data_page(const Page *page) const {
+        return page->klass != kHandleClass && page->klass != kPageFree && page->klass != kPageLargeTail;
+    }
+
+    void *alloc_chunk(size_t N);
+    void free_chunk(void *chunk);
+    size_t capacity(void *chunk);
+
+    void *class_pop(uint16_t klass);
+    void *page_pop(Page *page);
+    void page_push(Page *page, void *chunk);
+
+    Page *claim_page(bool from_top);
+    void release_page(Page *page);
+    void link_partial(SizeClass &klass, Page *page);
+    void unlink_partial(SizeClass &klass, Page *page);
+
+    void *alloc_large(size_t n_pages);
+
+    uint16_t class_for(size_t N) const;
+    void **check_handle(Pointer &p);
+
     void *_base;
     const size_t _base_len;
+
+    // Aligned begin of the first page
+    char *_pages_base;
+    size_t _page_size;
+    size_t _page_shift;
+
+    std::vector<Page> _pages;
+    std::vector<SizeClass> _classes;
 };
 
 } // namespace Allocator
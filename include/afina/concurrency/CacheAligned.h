@@ -0,0 +1,42 @@
+#ifndef AFINA_CONCURRENCY_CACHE_ALIGNED_H
+#define AFINA_CONCURRENCY_CACHE_ALIGNED_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Heap allocation aligned to cache line
+ * Operator new of C++11 knows nothing about alignas beyond max_align_t, so new of a type declared
+ * alignas(64) gets whatever malloc returns and neighbours end up sharing cache lines anyway. Types
+ * deriving from this one are allocated by posix_memalign instead, both one by one and in arrays: array
+ * cookie, if any, is padded by compiler to the alignment of the type, so elements stay aligned too.
+ *
+ * Only heap allocation of the derived type itself is covered, type embedding it must derive as well.
+ */
+struct CacheAligned {
+    static const size_t kAlignment = 64;
+
+    static void *operator new(size_t size) { return allocate(size); }
+    static void *operator new[](size_t size) { return allocate(size); }
+
+    static void operator delete(void *ptr) noexcept { std::free(ptr); }
+    static void operator delete[](void *ptr) noexcept { std::free(ptr); }
+
+private:
+    static void *allocate(size_t size) {
+        void *ptr = nullptr;
+        if (::posix_memalign(&ptr, kAlignment, size == 0 ? 1 : size) != 0) {
+            throw std::bad_alloc();
+        }
+        return ptr;
+    }
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_CACHE_ALIGNED_H
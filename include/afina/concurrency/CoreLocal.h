@@ -1,10 +1,101 @@
 #ifndef AFINA_CONCURRENCY_CORE_LOCAL_H
 #define AFINA_CONCURRENCY_CORE_LOCAL_H
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include <afina/concurrency/CacheAligned.h>
+
 namespace Afina {
 namespace Concurrency {
 
-template <typename T> class CoreLocal {};
+/**
+ * Number of the CPU calling thread runs on. Read from the rseq area glibc registers for the thread if there is
+ * one, otherwise asked by sched_getcpu. If neither works, threads get spread over CPUs by their number
+ */
+size_t CurrentCore();
+
+/**
+ * Number of CPUs configured in the system
+ */
+size_t NumberOfCores();
+
+/**
+ * # Per-CPU slots
+ * Keeps a copy of T for every CPU, each one in its own cache lines, so that threads running on different CPUs
+ * never touch the same line. Thread works with the slot of the CPU it runs on right now, reader walks through
+ * all of them to get the total.
+ *
+ * Thread could migrate to another CPU right after its slot is picked, so two threads may work with the same
+ * slot at times. That is rare and T must tolerate it: slot of atomics changed by relaxed RMW stays correct and
+ * its cache line stays local almost always.
+ */
+template <typename T> class CoreLocal {
+public:
+    CoreLocal() : _size(NumberOfCores()), _slots(new Slot[_size]()) {}
+
+    /**
+     * Slot of the CPU calling thread runs on
+     */
+    T &Local() { return _slots[CurrentCore() % _size].value; }
+
+    /**
+     * Calls f for each slot, concurrent updates may or may not be seen
+     */
+    template <typename F> void ForEach(F f) {
+        for (size_t i = 0; i < _size; i++) {
+            f(_slots[i].value);
+        }
+    }
+
+    template <typename F> void ForEach(F f) const {
+        for (size_t i = 0; i < _size; i++) {
+            f(static_cast<const T &>(_slots[i].value));
+        }
+    }
+
+    /**
+     * Folds all slots into a single value: result = f(result, slot)
+     */
+    template <typename R, typename F> R Aggregate(R init, F f) const {
+        ForEach([&init, &f](const T &value) { init = f(init, value); });
+        return init;
+    }
+
+    size_t Size() const { return _size; }
+
+private:
+    // No copy/move/assign allowed
+    CoreLocal(const CoreLocal &);            // = delete;
+    CoreLocal &operator=(const CoreLocal &); // = delete;
+
+    struct alignas(64) Slot : CacheAligned {
+        T value;
+    };
+
+    const size_t _size;
+    std::unique_ptr<Slot[]> _slots;
+};
+
+/**
+ * # Counter spread over CPUs
+ * Add is a relaxed increment of the slot of the current CPU, Get sums all of them up
+ */
+class CoreCounter {
+public:
+    void Add(uint64_t n = 1) { _counts.Local().fetch_add(n, std::memory_order_relaxed); }
+
+    uint64_t Get() const {
+        return _counts.Aggregate(uint64_t(0), [](uint64_t sum, const std::atomic<uint64_t> &count) {
+            return sum + count.load(std::memory_order_relaxed);
+        });
+    }
+
+private:
+    CoreLocal<std::atomic<uint64_t>> _counts;
+};
 
 } // namespace Concurrency
 } // namespace Afina
@@ -0,0 +1,129 @@
+#ifndef AFINA_CONCURRENCY_EPOCH_H
+#define AFINA_CONCURRENCY_EPOCH_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <afina/concurrency/CacheAligned.h>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Epoch based reclamation
+ * Allows readers to traverse shared structure without locks while writers unlink nodes from it. Reader
+ * pins itself into the current global epoch for the time of traversal (see Guard), writer hands unlinked
+ * memory over to Retire. Memory retired in epoch E is released only once the global epoch reaches E + 2,
+ * that happens after every thread pinned at the moment of retire leaves its critical section.
+ *
+ * Each thread gets its own record on the first Enter and keeps it until exit, so pin and unpin are a
+ * couple of stores into a cache line that no other reader touches.
+ */
+class Epoch {
+private:
+    struct Record;
+
+public:
+    /**
+     * Critical section of the reader: memory reachable from shared structure at the moment guard
+     * was created stays valid until guard is destroyed. Guards could be nested.
+     */
+    class Guard {
+    public:
+        Guard(Guard &&other) : _record(other._record) { other._record = nullptr; }
+        ~Guard();
+
+    private:
+        friend class Epoch;
+        explicit Guard(Record *record) : _record(record) {}
+
+        Guard(const Guard &);            // = delete;
+        Guard &operator=(const Guard &); // = delete;
+
+        Record *_record;
+    };
+
+    Epoch();
+    ~Epoch();
+
+    /**
+     * Pins calling thread into the current epoch
+     */
+    Guard Enter();
+
+    /**
+     * Schedules ptr to be released with deleter once no reader could observe it anymore. Caller must
+     * make ptr unreachable for new readers before retire. Thread safe.
+     */
+    void Retire(void *ptr, void (*deleter)(void *));
+
+    template <typename T> void Retire(T *ptr) {
+        Retire(static_cast<void *>(ptr), [](void *p) { delete static_cast<T *>(p); });
+    }
+
+    /**
+     * Tries to advance global epoch and releases everything that became safe to release.
+     * Returns number of released objects
+     */
+    size_t Collect();
+
+private:
+    // No copy/move/assign allowed
+    Epoch(const Epoch &);            // = delete;
+    Epoch &operator=(const Epoch &); // = delete;
+
+    // Participant of the reclamation, owned by a single thread for a time
+    struct alignas(64) Record : CacheAligned {
+        // (epoch << 1) | 1 if owner is inside of critical section, 0 otherwise
+        std::atomic<uint64_t> state;
+
+        // Depth of nested guards, touched by owner only
+        uint32_t nesting;
+
+        // Record is taken by some thread
+        std::atomic<bool> taken;
+
+        // Next record in registry
+        Record *next;
+    };
+
+    // Records outlive epoch instance while threads keep them, so registry is shared with them
+    struct Registry {
+        ~Registry();
+
+        std::atomic<uint64_t> global;
+        std::atomic<Record *> head;
+    };
+
+    struct Retired {
+        uint64_t epoch;
+        void *ptr;
+        void (*deleter)(void *);
+    };
+
+    // Records taken by the current thread
+    struct Local;
+
+    Record *record();
+    Record *acquire_record();
+
+    // Number of retires between automatic collections
+    static const size_t kCollectPeriod = 64;
+
+    // Unique id of the instance, allows threads to find their record
+    const uint64_t _id;
+    std::shared_ptr<Registry> _registry;
+
+    std::mutex _retired_lock;
+    std::vector<Retired> _retired;
+    size_t _since_collect;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_EPOCH_H
@@ -1,21 +1,37 @@
 #ifndef AFINA_CONCURRENCY_EXECUTOR_H
 #define AFINA_CONCURRENCY_EXECUTOR_H
 
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
-#include <queue>
 #include <string>
-#include <thread>
+#include <vector>
+
+#include <afina/concurrency/CacheAligned.h>
 
 namespace Afina {
 namespace Concurrency {
 
 /**
  * # Thread pool
+ * Every thread owns a Chase-Lev deque: tasks submitted from inside of the pool go to the bottom of the
+ * submitting thread's deque and are taken back from there LIFO, without any lock. Thread that runs out of
+ * own tasks steals from the top of deques of the others. Tasks submitted from outside go through the
+ * shared queue guarded by the mutex.
+ *
+ * Pool keeps at least low_watermark threads. If a task comes while there is no idle thread, one more
+ * thread is started, up to high_watermark. Thread that stays idle for idle_time exits unless pool would
+ * go below low_watermark. Once all threads are busy, up to max_queue_size tasks wait in the shared queue,
+ * the rest are rejected.
  */
 class Executor {
+public:
     enum class State {
         // Threadpool is fully operational, tasks could be added and get executed
         kRun,
@@ -28,7 +44,8 @@ class Executor {
         kStopped
     };
 
-    Executor(std::string name, int size);
+    Executor(std::string name, size_t low_watermark, size_t high_watermark, size_t max_queue_size,
+             std::chrono::milliseconds idle_time);
     ~Executor();
 
     /**
@@ -48,18 +65,13 @@ class Executor {
      */
     template <typename F, typename... Types> bool Execute(F &&func, Types... args) {
         // Prepare "task"
-        auto exec = std::bind(std::forward<F>(func), std::forward<Types>(args)...);
+        return execute(std::bind(std::forward<F>(func), std::forward<Types>(args)...));
+    }
 
-        std::unique_lock<std::mutex> lock(this->mutex);
-        if (state != State::kRun) {
-            return false;
-        }
+    // Number of threads currently in the pool
+    size_t Threads() const;
 
-        // Enqueue new task
-        tasks.push_back(exec);
-        empty_condition.notify_one();
-        return true;
-    }
+    State GetState() const;
 
 private:
     // No copy/move/assign allowed
@@ -68,35 +80,111 @@ private:
     Executor &operator=(const Executor &); // = delete;
     Executor &operator=(Executor &&);      // = delete;
 
+    using Task = std::function<void()>;
+
+    /**
+     * Chase-Lev work stealing deque of tasks. Owner thread pushes and pops at the bottom, any other
+     * thread steals from the top. Array grows by owner, arrays that were replaced are kept until
+     * deque is destroyed since thieves may still read them
+     */
+    class WorkDeque {
+    public:
+        WorkDeque();
+        ~WorkDeque();
+
+        // Owner only
+        void Push(Task *task);
+        Task *Pop();
+
+        // Any thread, returns nullptr if deque is empty or steal lost the race
+        Task *Steal();
+
+        bool Empty() const;
+
+    private:
+        struct Array {
+            explicit Array(size_t size) : mask(size - 1), items(new std::atomic<Task *>[size]) {}
+
+            Task *Get(int64_t i) const { return items[i & mask].load(std::memory_order_relaxed); }
+            void Put(int64_t i, Task *task) { items[i & mask].store(task, std::memory_order_relaxed); }
+
+            const size_t mask;
+            std::unique_ptr<std::atomic<Task *>[]> items;
+        };
+
+        Array *grow(Array *array, int64_t top, int64_t bottom);
+
+        alignas(64) std::atomic<int64_t> _top;
+        alignas(64) std::atomic<int64_t> _bottom;
+        std::atomic<Array *> _array;
+
+        // Every array deque ever had, owned here
+        std::vector<std::unique_ptr<Array>> _arrays;
+    };
+
+    // Place of a pool thread, reused by the next thread once the owner exits
+    struct alignas(64) Worker : CacheAligned {
+        WorkDeque deque;
+
+        // Slot is taken by a running thread, guarded by mutex
+        bool used = false;
+    };
+
+    bool execute(Task task);
+
     /**
      * Main function that all pool threads are running. It polls internal task queue and execute tasks
      */
-    friend void perform(Executor *executor);
+    friend void perform(Executor *executor, Worker *worker);
+
+    // Takes a task from own deque or steals one, nullptr if there is none
+    Task *find_task(Worker *self);
+
+    // Any deque other than self has something to steal
+    bool can_steal(const Worker *self) const;
+
+    // Takes free slot and starts thread on it, mutex must be held
+    void spawn();
+
+    // Slot of the calling thread if it belongs to this pool, nullptr otherwise
+    Worker *current() const;
+
+    const std::string _name;
+    const size_t _low_watermark;
+    const size_t _high_watermark;
+    const size_t _max_queue_size;
+    const std::chrono::milliseconds _idle_time;
+
+    // Slots for high_watermark threads
+    std::unique_ptr<Worker[]> _workers;
 
     /**
      * Mutex to protect state below from concurrent modification
      */
-    std::mutex mutex;
+    mutable std::mutex mutex;
 
     /**
      * Conditional variable to await new data in case of empty queue
      */
     std::condition_variable empty_condition;
 
-    /**
-     * Vector of actual threads that perorm execution
-     */
-    std::vector<std::thread> threads;
+    // Notified once the last thread exits
+    std::condition_variable stop_condition;
 
     /**
-     * Task queue
+     * Tasks submitted from outside of the pool
      */
-    std::deque<std::function<void()>> tasks;
+    std::deque<Task *> tasks;
+
+    // Number of threads running, number of them waiting for tasks and number of them running a task
+    size_t threads;
+    std::atomic<size_t> idle;
+    std::atomic<size_t> busy;
 
     /**
-     * Flag to stop bg threads
+     * Flag to stop bg threads, changed under mutex but pool threads check it without one
      */
-    State state;
+    std::atomic<State> state;
 };
 
 } // namespace Concurrency
@@ -1,10 +1,178 @@
 #ifndef AFINA_CONCURRENCY_FLAT_COMBINE_H
 #define AFINA_CONCURRENCY_FLAT_COMBINE_H
 
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/CacheAligned.h>
+
 namespace Afina {
 namespace Concurrency {
 
-template <typename Op> class FlatCombine {};
+/**
+ * # Flat combining
+ * Serializes operations on a sequential structure without making every thread take the lock in turn. Thread
+ * publishes its operation into a slot and tries to become combiner. Combiner collects operations published
+ * by everybody and passes them to the apply function in a single batch, so the structure stays in the cache
+ * of one core and lock changes hands once per batch instead of once per operation. The rest of threads just
+ * wait until their slot is served.
+ *
+ * Every thread prefers the slot of its own, so slots are effectively per-thread unless there are more threads
+ * than slots. Op is whatever record apply function understands, it lives on the stack of the publisher.
+ *
+ * Exception thrown by apply is rethrown to the publishers of every operation in that batch, combiner doesn't
+ * know which of them were applied. Apply that needs per-operation failures has to record them in ops itself.
+ */
+template <typename Op> class FlatCombine {
+public:
+    // Applies batch of operations to the structure, called by one thread at a time
+    using Apply = std::function<void(Op *const *ops, size_t count)>;
+
+    explicit FlatCombine(Apply apply, size_t n_slots = 64)
+        : _apply(std::move(apply)), _n_slots(n_slots), _slots(new Slot[n_slots]), _batch(n_slots),
+          _served(n_slots), _used(0), _combining(false) {}
+
+    /**
+     * Publishes operation and returns once it has been applied, by this thread or by some other one
+     */
+    void Execute(Op &op) {
+        // Nobody combines: apply own operation right away and serve whoever has published meanwhile
+        if (!_combining.load(std::memory_order_relaxed) && !_combining.exchange(true, std::memory_order_acquire)) {
+            Combining combining(_combining);
+            Op *own = &op;
+            _apply(&own, 1);
+            combine();
+            return;
+        }
+
+        Slot &slot = acquire();
+        slot.request.store(&op, std::memory_order_release);
+
+        for (size_t spins = 0; slot.request.load(std::memory_order_acquire) != nullptr; spins++) {
+            if (!_combining.load(std::memory_order_relaxed) && !_combining.exchange(true, std::memory_order_acquire)) {
+                Combining combining(_combining);
+                combine();
+            } else if (spins > kSpinsBeforeYield) {
+                std::this_thread::yield();
+            }
+        }
+
+        std::exception_ptr error = slot.error;
+        slot.error = nullptr;
+        slot.taken.store(false, std::memory_order_release);
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    // No copy/move/assign allowed
+    FlatCombine(const FlatCombine &);            // = delete;
+    FlatCombine &operator=(const FlatCombine &); // = delete;
+
+    // Publication slot, every one in its own cache line
+    struct alignas(64) Slot : CacheAligned {
+        Slot() : taken(false), request(nullptr) {}
+
+        // Slot is used by some thread for the time of one operation
+        std::atomic<bool> taken;
+
+        // Operation waiting to be applied, combiner resets it once operation is done
+        std::atomic<Op *> request;
+
+        // Set by combiner before it resets request, if the batch of the operation has failed
+        std::exception_ptr error;
+    };
+
+    // Gives the combiner role up on leaving the scope, also when apply throws
+    struct Combining {
+        explicit Combining(std::atomic<bool> &flag) : flag(flag) {}
+        ~Combining() { flag.store(false, std::memory_order_release); }
+
+        std::atomic<bool> &flag;
+    };
+
+    // Number of passes combiner makes over slots before it gives the role up
+    static const size_t kCombinePasses = 3;
+
+    // Number of checks of own slot before waiter starts to yield
+    static const size_t kSpinsBeforeYield = 128;
+
+    // Index of the slot calling thread starts to look for a free one from, threads get consecutive ones
+    static size_t home() {
+        static std::atomic<size_t> next(0);
+        static thread_local size_t index = next.fetch_add(1, std::memory_order_relaxed);
+        return index;
+    }
+
+    Slot &acquire() {
+        for (size_t i = home(), tried = 1;; i++, tried++) {
+            Slot &slot = _slots[i % _n_slots];
+            bool expected = false;
+            if (!slot.taken.load(std::memory_order_relaxed) &&
+                slot.taken.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                // Publish that combiner has to look this far, before request could appear in the slot
+                size_t used = _used.load(std::memory_order_relaxed);
+                while (used <= i % _n_slots &&
+                       !_used.compare_exchange_weak(used, i % _n_slots + 1, std::memory_order_release)) {
+                }
+                return slot;
+            }
+            // More threads than slots, let owners finish
+            if (tried % _n_slots == 0) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void combine() {
+        for (size_t pass = 0; pass < kCombinePasses; pass++) {
+            size_t count = 0;
+            size_t used = _used.load(std::memory_order_acquire);
+            for (size_t i = 0; i < used; i++) {
+                Op *op = _slots[i].request.load(std::memory_order_acquire);
+                if (op != nullptr) {
+                    _batch[count] = op;
+                    _served[count] = &_slots[i];
+                    count++;
+                }
+            }
+            if (count == 0) {
+                return;
+            }
+
+            std::exception_ptr error;
+            try {
+                _apply(_batch.data(), count);
+            } catch (...) {
+                error = std::current_exception();
+            }
+            for (size_t i = 0; i < count; i++) {
+                _served[i]->error = error;
+                _served[i]->request.store(nullptr, std::memory_order_release);
+            }
+        }
+    }
+
+    const Apply _apply;
+    const size_t _n_slots;
+    std::unique_ptr<Slot[]> _slots;
+
+    // Operations of the current batch and their slots, touched by combiner only
+    std::vector<Op *> _batch;
+    std::vector<Slot *> _served;
+
+    // Slots past this one were never taken, combiner doesn't scan them
+    std::atomic<size_t> _used;
+
+    // Some thread is combining right now
+    alignas(64) std::atomic<bool> _combining;
+};
 
 } // namespace Concurrency
 } // namespace Afina
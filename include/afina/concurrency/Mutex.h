@@ -0,0 +1,148 @@
+#ifndef AFINA_CONCURRENCY_MUTEX_H
+#define AFINA_CONCURRENCY_MUTEX_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "CoreLocal.h"
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Contention profile of the named lock
+ * All mutexes of the same name report into a single profile, so that, for example, locks of all instances of
+ * some storage show up as one line. Profiles are created on the first use of the name and live until the
+ * process exits. Counters are spread over CPUs, reading them gives a consistent enough snapshot for stats.
+ */
+class LockProfile {
+public:
+    /**
+     * Profile of the given name
+     */
+    static LockProfile &Get(const std::string &name);
+
+    /**
+     * Calls f for every profile there is, in order of names
+     */
+    static void ForEach(const std::function<void(const LockProfile &)> &f);
+
+    const std::string &Name() const { return _name; }
+
+    // Number of times lock was taken and number of them lock was busy at the moment
+    uint64_t Acquisitions() const { return _acquisitions.Get(); }
+    uint64_t Contended() const { return _contended.Get(); }
+
+    // Nanoseconds spent by threads waiting for the lock, in total and the longest single wait
+    uint64_t WaitTime() const { return _wait_time.Get(); }
+    uint64_t MaxWaitTime() const { return _max_wait_time.load(std::memory_order_relaxed); }
+
+    // Nanoseconds lock was held for, in total
+    uint64_t HoldTime() const { return _hold_time.Get(); }
+
+private:
+    friend class Mutex;
+
+    explicit LockProfile(std::string name) : _name(std::move(name)), _max_wait_time(0) {}
+
+    // No copy/move/assign allowed
+    LockProfile(const LockProfile &);            // = delete;
+    LockProfile &operator=(const LockProfile &); // = delete;
+
+    void waited(uint64_t time);
+
+    const std::string _name;
+
+    CoreCounter _acquisitions;
+    CoreCounter _contended;
+    CoreCounter _wait_time;
+    CoreCounter _hold_time;
+    std::atomic<uint64_t> _max_wait_time;
+};
+
+/**
+ * # Adaptive mutex
+ * Free lock is taken by a single CAS. Busy one is spun on for a while, since lock is usually held for a short
+ * time and a sleep costs a couple of syscalls and a context switch, then thread parks on the futex until
+ * owner wakes it up. How long to spin adapts to how long it took to get the lock by spinning recently, and
+ * there is no spinning at all on a single CPU: owner can't run while we spin.
+ *
+ * Every mutex reports to the profile of its name: how many times it was taken, how many of them it was busy,
+ * how long threads waited for it and how long it was held. Timing makes lock and unlock a couple of clock
+ * reads more expensive, that is the price of knowing which lock hurts.
+ *
+ * Satisfies Lockable, so std::lock_guard and std::unique_lock work with it.
+ */
+class Mutex {
+public:
+    explicit Mutex(const std::string &name) : _state(kFree), _profile(LockProfile::Get(name)), _spins(kMinSpins) {}
+
+    void lock() {
+        uint32_t expected = kFree;
+        if (!_state.compare_exchange_strong(expected, kLocked, std::memory_order_acquire,
+                                            std::memory_order_relaxed)) {
+            lock_contended();
+        }
+        _profile._acquisitions.Add();
+        _acquired_at = now();
+    }
+
+    bool try_lock() {
+        uint32_t expected = kFree;
+        if (!_state.compare_exchange_strong(expected, kLocked, std::memory_order_acquire,
+                                            std::memory_order_relaxed)) {
+            return false;
+        }
+        _profile._acquisitions.Add();
+        _acquired_at = now();
+        return true;
+    }
+
+    void unlock() {
+        _profile._hold_time.Add(now() - _acquired_at);
+        if (_state.exchange(kFree, std::memory_order_release) == kSleepers) {
+            wake();
+        }
+    }
+
+private:
+    // No copy/move/assign allowed
+    Mutex(const Mutex &);            // = delete;
+    Mutex &operator=(const Mutex &); // = delete;
+
+    // Lock is free, taken, taken and there could be threads sleeping on the futex
+    static const uint32_t kFree = 0;
+    static const uint32_t kLocked = 1;
+    static const uint32_t kSleepers = 2;
+
+    // Bounds of the number of checks busy lock gets before thread goes to sleep
+    static const int32_t kMinSpins = 16;
+    static const int32_t kMaxSpins = 1000;
+
+    // Monotonic time in nanoseconds
+    static uint64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    void lock_contended();
+    void wake();
+
+    std::atomic<uint32_t> _state;
+    LockProfile &_profile;
+
+    // Recent number of spins it took to get the lock, only a hint so races on it are fine
+    std::atomic<int32_t> _spins;
+
+    // Time lock was taken at, touched by owner only
+    uint64_t _acquired_at;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_MUTEX_H
@@ -0,0 +1,86 @@
+#ifndef AFINA_CONCURRENCY_SHARED_MUTEX_H
+#define AFINA_CONCURRENCY_SHARED_MUTEX_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+#include "CoreLocal.h"
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Reader-writer lock with per-CPU reader counts
+ * Reader announces itself by incrementing the counter of the CPU it runs on and checking that no writer is
+ * there, so readers on different CPUs touch nothing but their own cache lines and the writer flag that stays
+ * shared in all caches while there are no writers. Thread could unlock on another CPU than it has locked on,
+ * that is fine: writer needs the sum of all counters only.
+ *
+ * Writer raises the flag first, so that new readers back off and wait for it to leave, then waits for the
+ * counters to drain. So writer is never starved by the stream of readers, and writers are served one by one
+ * by the mutex of their own. The price is that every write scans counters of all CPUs.
+ *
+ * Satisfies Lockable for the exclusive side (std::lock_guard and std::unique_lock work) and has the same
+ * *_shared methods as std::shared_mutex, see SharedLock for the guard.
+ */
+class SharedMutex {
+public:
+    SharedMutex() : _writer(false) {}
+
+    void lock();
+    bool try_lock();
+    void unlock();
+
+    void lock_shared();
+    bool try_lock_shared();
+    void unlock_shared() { _readers.Local().fetch_sub(1, std::memory_order_release); }
+
+private:
+    // No copy/move/assign allowed
+    SharedMutex(const SharedMutex &);            // = delete;
+    SharedMutex &operator=(const SharedMutex &); // = delete;
+
+    // Number of checks before waiting thread starts to yield or sleep
+    static const size_t kSpins = 128;
+
+    // Sum of reader counters of all CPUs
+    int64_t readers() const;
+
+    // Blocks reader until writer leaves
+    void wait_writer();
+
+    CoreLocal<std::atomic<int64_t>> _readers;
+
+    // Writer holds lock or waits for readers to leave
+    alignas(64) std::atomic<bool> _writer;
+
+    // Serializes writers
+    std::mutex _writers;
+
+    // Readers that backed off sleep here until writer leaves
+    std::mutex _wait_lock;
+    std::condition_variable _writer_left;
+};
+
+/**
+ * # Guard of the shared side
+ * Takes lock shared for the time of the scope
+ */
+class SharedLock {
+public:
+    explicit SharedLock(SharedMutex &mutex) : _mutex(mutex) { _mutex.lock_shared(); }
+    ~SharedLock() { _mutex.unlock_shared(); }
+
+private:
+    SharedLock(const SharedLock &);            // = delete;
+    SharedLock &operator=(const SharedLock &); // = delete;
+
+    SharedMutex &_mutex;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_SHARED_MUTEX_H
@@ -1,10 +1,156 @@
 #ifndef AFINA_CONCURRENCY_THREAD_LOCAL_H
 #define AFINA_CONCURRENCY_THREAD_LOCAL_H
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
 namespace Afina {
 namespace Concurrency {
 
-template <typename T> class ThreadLocal {};
+/**
+ * # Per-thread value owned by an instance
+ * Each thread accessing the instance gets a value of its own, made by the factory on first access. Unlike
+ * thread_local variable, values belong to the instance: it could be created and destroyed at any time, and
+ * any thread could go over values of all the threads, for example to aggregate statistics.
+ *
+ * Value is destroyed once its thread exits or once the instance is destroyed, whatever comes first. Get
+ * looks through the instances calling thread has touched without any lock, mutex is taken only to link new
+ * value in, to unlink it on thread exit and by ForEach.
+ */
+template <typename T> class ThreadLocal {
+public:
+    using Factory = std::function<std::unique_ptr<T>()>;
+
+    ThreadLocal() : ThreadLocal([]() { return std::unique_ptr<T>(new T()); }) {}
+
+    explicit ThreadLocal(Factory factory)
+        : _id(next_id()), _registry(std::make_shared<Registry>()), _factory(std::move(factory)) {}
+
+    ~ThreadLocal() {
+        std::list<std::unique_ptr<T>> values;
+        {
+            std::lock_guard<std::mutex> lock(_registry->mutex);
+            _registry->alive.store(false, std::memory_order_relaxed);
+            values.swap(_registry->values);
+        }
+    }
+
+    /**
+     * Value of the calling thread
+     */
+    T &Get() {
+        auto &entries = local().entries;
+        for (auto &entry : entries) {
+            if (entry.id == _id) {
+                return *entry.value;
+            }
+        }
+        return make();
+    }
+
+    /**
+     * Calls f for value of every thread alive. Values are neither created nor destroyed meanwhile, but
+     * their owners keep running, so f must read only what is safe to read concurrently
+     */
+    template <typename F> void ForEach(F f) {
+        std::lock_guard<std::mutex> lock(_registry->mutex);
+        for (auto &value : _registry->values) {
+            f(*value);
+        }
+    }
+
+    // Number of threads having a value
+    size_t Size() const {
+        std::lock_guard<std::mutex> lock(_registry->mutex);
+        return _registry->values.size();
+    }
+
+private:
+    // No copy/move/assign allowed
+    ThreadLocal(const ThreadLocal &);            // = delete;
+    ThreadLocal &operator=(const ThreadLocal &); // = delete;
+
+    // Values of the instance, outlives it while threads refer to it
+    struct Registry {
+        Registry() : alive(true) {}
+
+        std::mutex mutex;
+        std::atomic<bool> alive;
+        std::list<std::unique_ptr<T>> values;
+    };
+
+    // Values of the instances current thread has touched, released on thread exit
+    struct Local {
+        struct Entry {
+            uint64_t id;
+            T *value;
+            std::shared_ptr<Registry> registry;
+            typename std::list<std::unique_ptr<T>>::iterator position;
+        };
+
+        ~Local() {
+            for (auto &entry : entries) {
+                release(entry);
+            }
+        }
+
+        // Value is destroyed out of the lock, since its destructor could be arbitrary long
+        static void release(Entry &entry) {
+            std::unique_ptr<T> value;
+            std::lock_guard<std::mutex> lock(entry.registry->mutex);
+            if (entry.registry->alive.load(std::memory_order_relaxed)) {
+                value = std::move(*entry.position);
+                entry.registry->values.erase(entry.position);
+            }
+        }
+
+        std::vector<Entry> entries;
+    };
+
+    static Local &local() {
+        static thread_local Local local;
+        return local;
+    }
+
+    static uint64_t next_id() {
+        static std::atomic<uint64_t> last_id(0);
+        return ++last_id;
+    }
+
+    T &make() {
+        // Entries of the instances that are gone refer to nothing, time to forget them
+        auto &entries = local().entries;
+        for (auto it = entries.begin(); it != entries.end();) {
+            if (!it->registry->alive.load(std::memory_order_relaxed)) {
+                it = entries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        std::unique_ptr<T> value = _factory();
+        T *result = value.get();
+        typename std::list<std::unique_ptr<T>>::iterator position;
+        {
+            std::lock_guard<std::mutex> lock(_registry->mutex);
+            position = _registry->values.insert(_registry->values.end(), std::move(value));
+        }
+        entries.push_back(typename Local::Entry{_id, result, _registry, position});
+        return *result;
+    }
+
+    // Unique id of the instance, allows threads to find their value
+    const uint64_t _id;
+    std::shared_ptr<Registry> _registry;
+    const Factory _factory;
+};
 
 } // namespace Concurrency
 } // namespace Afina
@@ -0,0 +1,43 @@
+#ifndef AFINA_EXECUTE_ARITHMETIC_COMMAND_H
+#define AFINA_EXECUTE_ARITHMETIC_COMMAND_H
+
+#include <cstdint>
+#include <string>
+
+#include "Command.h"
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Basic class for incr and decr
+ * Item value must be decimal representation of 64-bit unsigned integer, command
+ * replaces it with the result of the operation
+ *
+ * Command must write result to the output, which could be:
+ * - new value of the item, to indicate success
+ * - "NOT_FOUND" to indicate that the item with this key was not found
+ * - "CLIENT_ERROR ..." if value of the item isn't a number
+ */
+class ArithmeticCommand : public Command {
+public:
+    ArithmeticCommand(const std::string &key, uint64_t delta) : _key(key), _delta(delta) {}
+    ~ArithmeticCommand() {}
+
+    inline const std::string &key() const { return _key; }
+    inline const uint64_t delta() const { return _delta; }
+
+    void Execute(Storage &storage, const std::string &args, std::string &out) override;
+
+protected:
+    // Result of the operation over the current value
+    virtual uint64_t Apply(uint64_t value) const = 0;
+
+    const std::string &_key;
+    const uint64_t _delta;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_ARITHMETIC_COMMAND_H
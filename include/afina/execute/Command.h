@@ -1,17 +1,25 @@
 #ifndef AFINA_EXECUTE_COMMAND_H
 #define AFINA_EXECUTE_COMMAND_H
 
+#include <memory>
 #include <string>
 
+namespace spdlog {
+class logger;
+} // namespace spdlog
+
 namespace Afina {
 
 class Storage;
 
 namespace Execute {
 
+class Response;
+
 /**
- *
- *
+ * # Command to be executed over storage
+ * Command references keys it was built with and doesn't copy them, so it must not outlive the one who owns
+ * the keys: parser builds commands over its own key strings, that stay intact until parser gets reset
  */
 class Command {
 public:
@@ -19,6 +27,17 @@ public:
     virtual ~Command() {}
 
     virtual void Execute(Storage &storage, const std::string &args, std::string &out) = 0;
+
+    /**
+     * Same as above, but builds response that could reference storage memory instead of copying
+     * values out of it. By default response is the text produced by the method above
+     */
+    virtual void Execute(Storage &storage, const std::string &args, Response &out);
+
+protected:
+    // Logger of the commands: "execute" one if it is configured, root otherwise. Commands have no access
+    // to the logging service, so that is the logger service has registered. Null before service is started
+    static std::shared_ptr<spdlog::logger> logger();
 };
 
 } // namespace Execute
@@ -0,0 +1,39 @@
+#ifndef AFINA_EXECUTE_GAT_H
+#define AFINA_EXECUTE_GAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Get.h"
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Get and touch
+ * Same as Get, but expiration time of every item found is updated as Touch does
+ */
+class Gat : public Get {
+public:
+    Gat(int32_t expire, const std::string *keys, size_t count, bool with_cas = false)
+        : Get(keys, count, with_cas), _expire(expire) {}
+    Gat(int32_t expire, const std::vector<std::string> &keys, bool with_cas = false)
+        : Get(keys, with_cas), _expire(expire) {}
+    ~Gat() {}
+
+    inline const int32_t expire() const { return _expire; }
+
+protected:
+    // Items are touched one by one, every key is a single Storage::Touch
+    void Lookup(Storage &storage, const Storage::MultiGetCallback &found) override;
+
+private:
+    const int32_t _expire;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_GAT_H
@@ -1,9 +1,12 @@
 #ifndef AFINA_EXECUTE_GET_H
 #define AFINA_EXECUTE_GET_H
 
+#include <cstddef>
 #include <string>
 #include <vector>
 
+#include <afina/Storage.h>
+
 #include "Command.h"
 
 namespace Afina {
@@ -31,18 +34,49 @@ namespace Execute {
  * hold items with such keys (because they were never stored, or stored
  * but deleted to make space for more items, or expired, or explicitly
  * deleted by a client).
+ *
+ * "gets" is the same, but every item line carries cas unique of the item:
+ * VALUE <key> <flags> <bytes> <cas unique>
  */
 class Get : public Command {
 public:
-    Get(const std::vector<std::string> &keys) : _keys(keys) {}
+    Get(const std::string *keys, size_t count, bool with_cas = false)
+        : _keys(keys), _count(count), _with_cas(with_cas) {}
+    Get(const std::vector<std::string> &keys, bool with_cas = false) : Get(keys.data(), keys.size(), with_cas) {}
     ~Get() {}
 
-    inline const std::vector<std::string> &keys() const { return _keys; }
+    // Copy of the keys, command itself only references them
+    inline std::vector<std::string> keys() const { return std::vector<std::string>(_keys, _keys + _count); }
+    inline bool with_cas() const { return _with_cas; }
 
     void Execute(Storage &storage, const std::string &args, std::string &out) override;
 
+    // Response references values in the storage memory
+    void Execute(Storage &storage, const std::string &args, Response &out) override;
+
+    // Item of the key, as the storage keeps it except for the trailing \r\n
+    struct Item {
+        ValueRef value;
+        ItemMeta meta;
+        bool found = false;
+    };
+
+    // Looks up all the keys and puts the item of the i-th key into items[i], there must be room for all of them.
+    // Protocols other than text one frame the response from items by themselves
+    void Retrieve(Storage &storage, Item *items);
+
+protected:
+    // Looks up all the keys at once and passes items found to the callback, in any order
+    virtual void Lookup(Storage &storage, const Storage::MultiGetCallback &found);
+
+    const std::string *_keys;
+    size_t _count;
+
 private:
-    std::vector<std::string> _keys;
+    // Number of keys whose items are collected on the stack
+    static const size_t kLocalItems = 16;
+
+    bool _with_cas;
 };
 
 } // namespace Execute
@@ -23,7 +23,7 @@ public:
     inline const int32_t expire() const { return _expire; }
 
 protected:
-    const std::string _key;
+    const std::string &_key;
     const uint32_t _flags;
     const int32_t _expire;
 };
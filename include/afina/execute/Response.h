@@ -0,0 +1,90 @@
+#ifndef AFINA_EXECUTE_RESPONSE_H
+#define AFINA_EXECUTE_RESPONSE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <sys/uio.h>
+
+#include <afina/ValueRef.h>
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Response of the command
+ * Sequence of segments to be sent to the client as is. Text of the protocol is copied into the response,
+ * values are kept as ValueRef which response holds until it is destroyed. So network could send the whole
+ * response by writev without copying values once more. Whether ValueRef points into the storage memory or
+ * to a private copy is up to storage, see Storage::Get.
+ *
+ * Small values are copied into the text instead: copy is cheaper than a vector and a reference, and
+ * responses of a pipelined batch then stay a few contiguous runs that go by a single writev.
+ */
+class Response {
+public:
+    // Values up to that size are copied into the text
+    static const size_t kInlineValueSize = 512;
+
+    Response() : _size(0) {}
+    ~Response() {}
+
+    Response(Response &&) = default;
+    Response &operator=(Response &&) = default;
+
+    /**
+     * Appends copy of the given text
+     */
+    void Append(const char *data, size_t size);
+    void Append(const std::string &text) { Append(text.data(), text.size()); }
+
+    /**
+     * Appends referenced bytes, reference is kept by the response unless value is small enough to be copied
+     */
+    void Append(ValueRef value);
+
+    /**
+     * Total number of bytes in the response
+     */
+    size_t Size() const { return _size; }
+    bool Empty() const { return _size == 0; }
+
+    /**
+     * Describes bytes of the response starting from offset by at most max iovecs, returns number of
+     * filled ones. Vectors stay valid until response is changed or destroyed
+     */
+    size_t Fill(struct iovec *iov, size_t max, size_t offset) const;
+
+    /**
+     * Copies all bytes of the response to the end of out
+     */
+    void AppendTo(std::string &out) const;
+
+    /**
+     * Drops all segments and references
+     */
+    void Clear();
+
+private:
+    // Text segment has no data pointer, its bytes are at offset in the _text since the buffer could move
+    struct Segment {
+        const char *data;
+        size_t offset;
+        size_t size;
+    };
+
+    const char *data_of(const Segment &segment) const {
+        return segment.data != nullptr ? segment.data : _text.data() + segment.offset;
+    }
+
+    std::string _text;
+    std::vector<Segment> _segments;
+    std::vector<ValueRef> _values;
+    size_t _size;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_RESPONSE_H
@@ -3,16 +3,54 @@
 
 #include <string>
 
+#include <afina/concurrency/CoreLocal.h>
+
 #include "Command.h"
 
 namespace Afina {
 namespace Execute {
 
+/**
+ * # Server statistics
+ * Reports counters of the whole server, each one as
+ * STAT <name> <value>
+ * followed by END
+ *
+ * "stats locks" reports contention profiles of the named locks instead, see Concurrency::LockProfile:
+ * STAT <lock>:<counter> <value>
+ */
 class Stats : public Command {
 public:
-    Stats() {}
+    /**
+     * Counters updated on every request, they are spread over CPUs so that cores serving requests don't fight
+     * for a shared cache line
+     */
+    struct Counters {
+        // Keys looked up by get family commands, found and not found ones
+        Concurrency::CoreCounter cmd_get;
+        Concurrency::CoreCounter get_hits;
+        Concurrency::CoreCounter get_misses;
+
+        // Bytes received from clients and bytes of responses to them
+        Concurrency::CoreCounter bytes_read;
+        Concurrency::CoreCounter bytes_written;
+    };
+
+    // Counters of the server
+    static Counters &Global();
+
+    // Set of counters to report
+    enum class Group { kGeneral, kLocks };
+
+    explicit Stats(Group group = Group::kGeneral) : _group(group) {}
     ~Stats() {}
+
+    inline Group group() const { return _group; }
+
     void Execute(Storage &storage, const std::string &args, std::string &out) override;
+
+private:
+    Group _group;
 };
 
 } // namespace Execute
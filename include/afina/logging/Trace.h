@@ -0,0 +1,28 @@
+#ifndef AFINA_LOGGING_TRACE_H
+#define AFINA_LOGGING_TRACE_H
+
+#include <spdlog/logger.h>
+
+/**
+ * # Trace logging of the hot paths
+ * Statement is compiled in only if build has AFINA_TRACE option on, otherwise it disappears together
+ * with evaluation of its arguments. Once compiled in, message is formatted only if logger is there and
+ * has trace level enabled.
+ *
+ * AFINA_TRACE(logger, "Set({}): {} bytes", key, value.size());
+ */
+#ifdef AFINA_TRACE_ON
+#define AFINA_TRACE(logger, ...)                                                                                       \
+    do {                                                                                                               \
+        auto &&afina_trace_logger = (logger);                                                                          \
+        if (afina_trace_logger) {                                                                                      \
+            afina_trace_logger->trace(__VA_ARGS__);                                                                    \
+        }                                                                                                              \
+    } while (0)
+#else
+#define AFINA_TRACE(logger, ...)                                                                                       \
+    do {                                                                                                               \
+    } while (0)
+#endif
+
+#endif // AFINA_LOGGING_TRACE_H
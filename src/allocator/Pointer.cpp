@@ -3,12 +3,22 @@
 namespace Afina {
 namespace Allocator {
 
-Pointer::Pointer() {}
-Pointer::Pointer(const Pointer &) {}
-Pointer::Pointer(Pointer &&) {}
+Pointer::Pointer() : _cell(nullptr) {}
+Pointer::Pointer(const Pointer &other) : _cell(other._cell) {}
+Pointer::Pointer(Pointer &&other) : _cell(other._cell) { other._cell = nullptr; }
 
-Pointer &Pointer::operator=(const Pointer &) { return *this; }
-Pointer &Pointer::operator=(Pointer &&) { return *this; }
+Pointer &Pointer::operator=(const Pointer &other) {
+    _cell = other._cell;
+    return *this;
+}
+
+Pointer &Pointer::operator=(Pointer &&other) {
+    if (this != &other) {
+        _cell = other._cell;
+        other._cell = nullptr;
+    }
+    return *this;
+}
 
 } // namespace Allocator
 } // namespace Afina
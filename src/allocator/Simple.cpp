@@ -1,40 +1,476 @@
 #include <afina/allocator/Simple.h>
 
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <utility>
+
+#include <afina/allocator/Error.h>
 #include <afina/allocator/Pointer.h>
 
 namespace Afina {
 namespace Allocator {
 
-Simple::Simple(void *base, size_t size) : _base(base), _base_len(size) {}
-
-/**
- * TODO: semantics
- * @param N size_t
- */
-Pointer Simple::alloc(size_t N) { return Pointer(); }
-
-/**
- * TODO: semantics
- * @param p Pointer
- * @param N size_t
- */
-void Simple::realloc(Pointer &p, size_t N) {}
-
-/**
- * TODO: semantics
- * @param p Pointer
- */
-void Simple::free(Pointer &p) {}
-
-/**
- * TODO: semantics
- */
-void Simple::defrag() {}
-
-/**
- * TODO: semantics
- */
-std::string Simple::dump() const { return ""; }
+namespace {
+
+// Bounds of the page size, actual one depends on size of the area so that there are
+// always enough pages to be shared between size classes
+const size_t kMinPageShift = 6;
+const size_t kMaxPageShift = 20;
+const size_t kPagesPerArea = 16;
+
+// Size classes grow by factor 5/4 starting from the smallest one
+const size_t kMinChunk = 16;
+const size_t kAlign = 8;
+
+size_t align_up(size_t n, size_t align) { return (n + align - 1) & ~(align - 1); }
+
+} // namespace
+
+Simple::Simple(void *base, size_t size) : _base(base), _base_len(size) {
+    char *begin = reinterpret_cast<char *>(align_up(reinterpret_cast<uintptr_t>(base), kAlign * 2));
+    char *end = static_cast<char *>(base) + size;
+    size_t len = begin < end ? end - begin : 0;
+
+    _page_shift = kMinPageShift;
+    while (_page_shift < kMaxPageShift && (size_t(1) << (_page_shift + 1)) * kPagesPerArea <= len) {
+        _page_shift++;
+    }
+    _page_size = size_t(1) << _page_shift;
+    _pages_base = begin;
+
+    Page empty;
+    empty.klass = kPageFree;
+    empty.used = empty.carved = 0;
+    empty.free_list = nullptr;
+    empty.prev = empty.next = nullptr;
+    _pages.assign(len >> _page_shift, empty);
+
+    // Handles
+    _classes.push_back(SizeClass{sizeof(void *), uint32_t(_page_size / sizeof(void *)), nullptr});
+
+    // Data classes, the last one takes the whole page
+    for (size_t chunk = kMinChunk; chunk < _page_size; chunk = align_up(chunk * 5 / 4, kAlign)) {
+        // Widen chunk up to the size that still fits the same number of chunks into the page
+        uint32_t per_page = _page_size / chunk;
+        chunk = (_page_size / per_page) & ~(kAlign - 1);
+        if (per_page == 1) {
+            break;
+        } else if (_classes.size() > 1 && _classes.back().size >= chunk) {
+            continue;
+        }
+        _classes.push_back(SizeClass{chunk, per_page, nullptr});
+    }
+    _classes.push_back(SizeClass{_page_size, 1, nullptr});
+}
+
+// See Simple.h
+Pointer Simple::alloc(size_t N) {
+    Pointer result = alloc(N, std::nothrow);
+    if (result._cell == nullptr) {
+        throw AllocError(AllocErrorType::NoMemory, "Not enough memory to allocate " + std::to_string(N) + " bytes");
+    }
+    return result;
+}
+
+// See Simple.h
+Pointer Simple::alloc(size_t N, const std::nothrow_t &) {
+    void **cell = static_cast<void **>(class_pop(kHandleClass));
+    if (cell == nullptr) {
+        return Pointer();
+    }
+
+    void *chunk = alloc_chunk(N);
+    if (chunk == nullptr) {
+        free_chunk(cell);
+        return Pointer();
+    }
+
+    *cell = chunk;
+    return Pointer(cell);
+}
+
+// See Simple.h
+void Simple::realloc(Pointer &p, size_t N) {
+    if (!realloc(p, N, std::nothrow)) {
+        throw AllocError(AllocErrorType::NoMemory, "Not enough memory to reallocate " + std::to_string(N) + " bytes");
+    }
+}
+
+// See Simple.h
+bool Simple::realloc(Pointer &p, size_t N, const std::nothrow_t &) {
+    if (p._cell == nullptr) {
+        p = alloc(N, std::nothrow);
+        return p._cell != nullptr;
+    }
+
+    void **cell = check_handle(p);
+    size_t old_capacity = capacity(*cell);
+    if (N <= old_capacity) {
+        return true;
+    }
+
+    void *chunk = alloc_chunk(N);
+    if (chunk == nullptr) {
+        return false;
+    }
+
+    std::memcpy(chunk, *cell, old_capacity);
+    free_chunk(*cell);
+    *cell = chunk;
+    return true;
+}
+
+// See Simple.h
+void Simple::free(Pointer &p) {
+    if (p._cell == nullptr) {
+        return;
+    }
+
+    void **cell = check_handle(p);
+    free_chunk(*cell);
+    free_chunk(cell);
+    p._cell = nullptr;
+}
+
+// See Simple.h
+void Simple::defrag() {
+    // Group alive chunks by pages they are in, only handles know which chunks are alive
+    std::vector<std::pair<size_t, void **>> alive;
+    for (auto &page : _pages) {
+        if (page.klass != kHandleClass) {
+            continue;
+        }
+
+        void **cells = reinterpret_cast<void **>(page_address(&page));
+        for (uint32_t i = 0; i < page.carved; i++) {
+            void *chunk = cells[i];
+            if (chunk == nullptr || chunk < _pages_base || chunk >= _pages_base + (_pages.size() << _page_shift)) {
+                continue;
+            }
+
+            Page *chunk_page = page_of(chunk);
+            if (is_data_page(chunk_page) && chunk_page->klass != kPageLarge) {
+                alive.emplace_back(chunk_page - &_pages[0], &cells[i]);
+            }
+        }
+    }
+    std::sort(alive.begin(), alive.end());
+
+    for (uint16_t k = 1; k < _classes.size(); k++) {
+        SizeClass &klass = _classes[k];
+
+        std::vector<Page *> pages;
+        for (auto &page : _pages) {
+            if (page.klass == k) {
+                pages.push_back(&page);
+            }
+        }
+        std::stable_sort(pages.begin(), pages.end(), [](const Page *a, const Page *b) { return a->used > b->used; });
+
+        // Move chunks from the least used pages (tail) to the most used pages that still have room (head)
+        size_t dst = 0, src = pages.size();
+        while (dst + 1 < src) {
+            if (pages[dst]->used == klass.per_page) {
+                dst++;
+                continue;
+            }
+
+            Page *from = pages[src - 1];
+            size_t from_idx = from - &_pages[0];
+            auto it = std::lower_bound(alive.begin(), alive.end(), std::make_pair(from_idx, (void **)nullptr));
+            for (; it != alive.end() && it->first == from_idx && pages[dst]->used < klass.per_page; ++it) {
+                void **cell = it->second;
+                if (cell == nullptr) {
+                    // Moved already
+                    continue;
+                }
+
+                void *chunk = page_pop(pages[dst]);
+                std::memcpy(chunk, *cell, klass.size);
+
+                // Releases source page once the last chunk is gone
+                page_push(from, *cell);
+                *cell = chunk;
+                it->second = nullptr;
+            }
+
+            if (from->klass != k) {
+                src--;
+            } else if (pages[dst]->used < klass.per_page) {
+                // Nothing left to move, page has chunks that has no handle
+                break;
+            }
+        }
+    }
+}
+
+// See Simple.h
+size_t Simple::chunk_size(size_t N) const {
+    if (N <= _page_size) {
+        return _classes[class_for(N)].size;
+    }
+
+    size_t n_pages = align_up(N, _page_size) >> _page_shift;
+    return n_pages <= _pages.size() ? n_pages << _page_shift : 0;
+}
+
+// See Simple.h
+std::vector<void *> Simple::reclaim(size_t N) const {
+    size_t n_pages = N > _page_size ? align_up(N, _page_size) >> _page_shift : 1;
+    if (n_pages > _pages.size()) {
+        return std::vector<void *>();
+    }
+
+    // Run of pages that has the least chunks in use, large allocation counts as one chunk
+    size_t best = _pages.size(), best_cost = 0;
+    for (size_t i = 0; i + n_pages <= _pages.size(); i++) {
+        size_t cost = 0;
+        bool handles = false;
+        for (size_t j = i; j < i + n_pages && !handles; j++) {
+            const Page &page = _pages[j];
+            handles = page.klass == kHandleClass;
+            cost += page.klass == kPageLarge ? 1 : is_data_page(&page) ? page.used : 0;
+        }
+        if (!handles && (best == _pages.size() || cost < best_cost)) {
+            best = i;
+            best_cost = cost;
+        }
+    }
+    if (best == _pages.size()) {
+        return std::vector<void *>();
+    }
+
+    std::vector<void *> chunks;
+    for (size_t j = best; j < best + n_pages; j++) {
+        const Page &page = _pages[j];
+        if (page.klass == kPageFree) {
+            continue;
+        }
+
+        if (page.klass == kPageLarge || page.klass == kPageLargeTail) {
+            // Run could start before the picked pages
+            size_t head = j;
+            while (_pages[head].klass == kPageLargeTail) {
+                head--;
+            }
+            if (chunks.empty() || chunks.back() != page_address(&_pages[head])) {
+                chunks.push_back(page_address(&_pages[head]));
+            }
+            continue;
+        }
+
+        // Chunks on the free list are the only carved ones not in use
+        const SizeClass &klass = _classes[page.klass];
+        char *begin = page_address(&page);
+        std::vector<bool> freed(page.carved, false);
+        for (void *chunk = page.free_list; chunk != nullptr; chunk = *static_cast<void **>(chunk)) {
+            freed[(static_cast<char *>(chunk) - begin) / klass.size] = true;
+        }
+        for (uint32_t i = 0; i < page.carved; i++) {
+            if (!freed[i]) {
+                chunks.push_back(begin + i * klass.size);
+            }
+        }
+    }
+    return chunks;
+}
+
+// See Simple.h
+std::string Simple::dump() const {
+    std::vector<size_t> pages(_classes.size(), 0);
+    std::vector<size_t> used(_classes.size(), 0);
+    size_t free_pages = 0, large_pages = 0;
+    for (auto &page : _pages) {
+        if (page.klass == kPageFree) {
+            free_pages++;
+        } else if (page.klass == kPageLarge || page.klass == kPageLargeTail) {
+            large_pages++;
+        } else {
+            pages[page.klass]++;
+            used[page.klass] += page.used;
+        }
+    }
+
+    std::stringstream out;
+    out << "pages: " << _pages.size() << " x " << _page_size << " bytes, free: " << free_pages
+        << ", large: " << large_pages << std::endl;
+    for (size_t k = 0; k < _classes.size(); k++) {
+        if (pages[k] == 0) {
+            continue;
+        }
+        out << "class " << k << " (" << _classes[k].size << " bytes): pages " << pages[k] << ", chunks " << used[k]
+            << "/" << pages[k] * _classes[k].per_page << std::endl;
+    }
+    return out.str();
+}
+
+void *Simple::alloc_chunk(size_t N) {
+    if (N > _page_size) {
+        return alloc_large(align_up(N, _page_size) >> _page_shift);
+    }
+    return class_pop(class_for(N));
+}
+
+void Simple::free_chunk(void *chunk) {
+    Page *page = page_of(chunk);
+    if (page->klass == kPageLarge) {
+        Page *end = page + page->used;
+        for (; page != end; page++) {
+            release_page(page);
+        }
+        return;
+    }
+    page_push(page, chunk);
+}
+
+size_t Simple::capacity(void *chunk) {
+    Page *page = page_of(chunk);
+    if (page->klass == kPageLarge) {
+        return page->used << _page_shift;
+    }
+    return _classes[page->klass].size;
+}
+
+void *Simple::class_pop(uint16_t k) {
+    SizeClass &klass = _classes[k];
+    Page *page = klass.partial;
+    if (page == nullptr) {
+        page = claim_page(k == kHandleClass);
+        if (page == nullptr) {
+            return nullptr;
+        }
+
+        page->klass = k;
+        link_partial(klass, page);
+    }
+    return page_pop(page);
+}
+
+void *Simple::page_pop(Page *page) {
+    SizeClass &klass = _classes[page->klass];
+
+    void *chunk = page->free_list;
+    if (chunk != nullptr) {
+        page->free_list = *static_cast<void **>(chunk);
+    } else {
+        chunk = page_address(page) + page->carved * klass.size;
+        page->carved++;
+    }
+
+    page->used++;
+    if (page->used == klass.per_page) {
+        unlink_partial(klass, page);
+    }
+    return chunk;
+}
+
+void Simple::page_push(Page *page, void *chunk) {
+    SizeClass &klass = _classes[page->klass];
+
+    *static_cast<void **>(chunk) = page->free_list;
+    page->free_list = chunk;
+
+    if (page->used == klass.per_page) {
+        link_partial(klass, page);
+    }
+
+    page->used--;
+    if (page->used == 0) {
+        unlink_partial(klass, page);
+        release_page(page);
+    }
+}
+
+Simple::Page *Simple::claim_page(bool from_top) {
+    // Handles are never moved, so keep them away from the pages used for data
+    if (from_top) {
+        for (size_t i = _pages.size(); i > 0; i--) {
+            if (_pages[i - 1].klass == kPageFree) {
+                return &_pages[i - 1];
+            }
+        }
+    } else {
+        for (auto &page : _pages) {
+            if (page.klass == kPageFree) {
+                return &page;
+            }
+        }
+    }
+    return nullptr;
+}
+
+void Simple::release_page(Page *page) {
+    page->klass = kPageFree;
+    page->used = page->carved = 0;
+    page->free_list = nullptr;
+    page->prev = page->next = nullptr;
+}
+
+void Simple::link_partial(SizeClass &klass, Page *page) {
+    page->prev = nullptr;
+    page->next = klass.partial;
+    if (klass.partial != nullptr) {
+        klass.partial->prev = page;
+    }
+    klass.partial = page;
+}
+
+void Simple::unlink_partial(SizeClass &klass, Page *page) {
+    if (page->prev != nullptr) {
+        page->prev->next = page->next;
+    } else {
+        klass.partial = page->next;
+    }
+    if (page->next != nullptr) {
+        page->next->prev = page->prev;
+    }
+    page->prev = page->next = nullptr;
+}
+
+void *Simple::alloc_large(size_t n_pages) {
+    size_t run = 0;
+    for (size_t i = 0; i < _pages.size(); i++) {
+        run = (_pages[i].klass == kPageFree) ? run + 1 : 0;
+        if (run < n_pages) {
+            continue;
+        }
+
+        Page *head = &_pages[i + 1 - n_pages];
+        for (Page *page = head; page != head + n_pages; page++) {
+            page->klass = kPageLargeTail;
+        }
+        head->klass = kPageLarge;
+        head->used = n_pages;
+        return page_address(head);
+    }
+    return nullptr;
+}
+
+uint16_t Simple::class_for(size_t N) const {
+    auto it = std::lower_bound(_classes.begin() + 1, _classes.end(), N,
+                               [](const SizeClass &klass, size_t size) { return klass.size < size; });
+    return it - _classes.begin();
+}
+
+void **Simple::check_handle(Pointer &p) {
+    char *cell = reinterpret_cast<char *>(p._cell);
+    if (cell < _pages_base || cell >= _pages_base + (_pages.size() << _page_shift)) {
+        throw AllocError(AllocErrorType::InvalidFree, "Pointer doesn't belong to the allocator");
+    }
+
+    Page *page = page_of(cell);
+    if (page->klass != kHandleClass || (cell - page_address(page)) % sizeof(void *) != 0) {
+        throw AllocError(AllocErrorType::InvalidFree, "Pointer doesn't belong to the allocator");
+    }
+
+    char *chunk = static_cast<char *>(*p._cell);
+    if (chunk < _pages_base || chunk >= _pages_base + (_pages.size() << _page_shift) ||
+        !is_data_page(page_of(chunk))) {
+        throw AllocError(AllocErrorType::InvalidFree, "Pointer has been released already");
+    }
+    return p._cell;
+}
 
 } // namespace Allocator
 } // namespace Afina
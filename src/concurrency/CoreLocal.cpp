@@ -0,0 +1,44 @@
+#include <afina/concurrency/CoreLocal.h>
+
+#include <sched.h>
+#include <unistd.h>
+
+#ifdef AFINA_HAVE_RSEQ
+#include <sys/rseq.h>
+#endif
+
+namespace Afina {
+namespace Concurrency {
+
+// See CoreLocal.h
+size_t CurrentCore() {
+#ifdef AFINA_HAVE_RSEQ
+    // Kernel keeps cpu_id of the registered area up to date on every migration, so it is a plain load
+    if (__rseq_size > 0) {
+        auto area = reinterpret_cast<const volatile struct rseq *>(static_cast<char *>(__builtin_thread_pointer()) +
+                                                                    __rseq_offset);
+        int32_t cpu = static_cast<int32_t>(area->cpu_id);
+        if (cpu >= 0) {
+            return cpu;
+        }
+    }
+#endif
+
+    int cpu = sched_getcpu();
+    if (cpu >= 0) {
+        return cpu;
+    }
+
+    static std::atomic<size_t> next(0);
+    static thread_local size_t index = next.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+// See CoreLocal.h
+size_t NumberOfCores() {
+    long cores = sysconf(_SC_NPROCESSORS_CONF);
+    return cores > 0 ? cores : 1;
+}
+
+} // namespace Concurrency
+} // namespace Afina
@@ -0,0 +1,164 @@
+#include <afina/concurrency/Epoch.h>
+
+#include <algorithm>
+
+namespace Afina {
+namespace Concurrency {
+
+namespace {
+
+std::atomic<uint64_t> last_id(0);
+
+} // namespace
+
+// Records of the epoch instances current thread has entered, released on thread exit
+struct Epoch::Local {
+    struct Entry {
+        uint64_t id;
+        std::shared_ptr<Registry> registry;
+        Record *record;
+    };
+
+    ~Local() {
+        for (auto &entry : entries) {
+            release(entry);
+        }
+    }
+
+    static void release(Entry &entry) {
+        entry.record->nesting = 0;
+        entry.record->state.store(0, std::memory_order_release);
+        entry.record->taken.store(false, std::memory_order_release);
+    }
+
+    std::vector<Entry> entries;
+};
+
+Epoch::Guard::~Guard() {
+    if (_record != nullptr && --_record->nesting == 0) {
+        _record->state.store(0, std::memory_order_release);
+    }
+}
+
+Epoch::Epoch() : _id(++last_id), _registry(new Registry), _since_collect(0) {
+    // Epoch 0 is reserved to mark inactive records
+    _registry->global.store(1);
+    _registry->head.store(nullptr);
+}
+
+Epoch::~Epoch() {
+    for (auto &retired : _retired) {
+        retired.deleter(retired.ptr);
+    }
+}
+
+Epoch::Registry::~Registry() {
+    Record *record = head.load();
+    while (record != nullptr) {
+        Record *next = record->next;
+        delete record;
+        record = next;
+    }
+}
+
+// See Epoch.h
+Epoch::Guard Epoch::Enter() {
+    Record *r = record();
+    if (r->nesting++ == 0) {
+        uint64_t epoch = _registry->global.load(std::memory_order_relaxed);
+        // Writer that inspects records must either see us active or we must see its unlink
+        r->state.store((epoch << 1) | 1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+    return Guard(r);
+}
+
+// See Epoch.h
+void Epoch::Retire(void *ptr, void (*deleter)(void *)) {
+    {
+        std::lock_guard<std::mutex> lock(_retired_lock);
+        _retired.push_back(Retired{_registry->global.load(std::memory_order_seq_cst), ptr, deleter});
+        if (++_since_collect < kCollectPeriod) {
+            return;
+        }
+        _since_collect = 0;
+    }
+    Collect();
+}
+
+// See Epoch.h
+size_t Epoch::Collect() {
+    std::vector<Retired> released;
+    {
+        std::lock_guard<std::mutex> lock(_retired_lock);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        // Epoch could move on only when every active thread has observed the current one
+        uint64_t epoch = _registry->global.load(std::memory_order_seq_cst);
+        bool advance = true;
+        for (Record *r = _registry->head.load(std::memory_order_acquire); r != nullptr; r = r->next) {
+            uint64_t state = r->state.load(std::memory_order_seq_cst);
+            if ((state & 1) != 0 && (state >> 1) != epoch) {
+                advance = false;
+                break;
+            }
+        }
+        if (advance) {
+            _registry->global.store(++epoch, std::memory_order_seq_cst);
+        }
+
+        auto safe = std::partition(_retired.begin(), _retired.end(),
+                                   [epoch](const Retired &retired) { return retired.epoch + 2 > epoch; });
+        released.assign(safe, _retired.end());
+        _retired.erase(safe, _retired.end());
+    }
+
+    for (auto &retired : released) {
+        retired.deleter(retired.ptr);
+    }
+    return released.size();
+}
+
+Epoch::Record *Epoch::record() {
+    static thread_local Local local;
+
+    auto &entries = local.entries;
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (it->id == _id) {
+            return it->record;
+        }
+
+        // Epoch instance is gone, so nobody else refers to its registry
+        if (it->registry.use_count() == 1) {
+            Local::release(*it);
+            it = entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    Record *r = acquire_record();
+    entries.push_back(Local::Entry{_id, _registry, r});
+    return r;
+}
+
+Epoch::Record *Epoch::acquire_record() {
+    for (Record *r = _registry->head.load(std::memory_order_acquire); r != nullptr; r = r->next) {
+        bool expected = false;
+        if (!r->taken.load(std::memory_order_relaxed) && r->taken.compare_exchange_strong(expected, true)) {
+            return r;
+        }
+    }
+
+    Record *r = new Record;
+    r->state.store(0);
+    r->nesting = 0;
+    r->taken.store(true);
+    r->next = _registry->head.load(std::memory_order_relaxed);
+    while (!_registry->head.compare_exchange_weak(r->next, r)) {
+    }
+    return r;
+}
+
+} // namespace Concurrency
+} // namespace Afina
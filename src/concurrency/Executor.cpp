@@ -1,5 +1,299 @@
 #include <afina/concurrency/Executor.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+
 namespace Afina {
-namespace Concurrency {}
+namespace Concurrency {
+
+namespace {
+
+// Slot of the pool the current thread runs in
+thread_local void *current_worker = nullptr;
+
+// Initial number of tasks deque could hold, grows twice each time it is full
+const size_t kInitialDequeSize = 64;
+
+} // namespace
+
+Executor::WorkDeque::WorkDeque() : _top(0), _bottom(0) {
+    _arrays.emplace_back(new Array(kInitialDequeSize));
+    _array.store(_arrays.back().get());
+}
+
+Executor::WorkDeque::~WorkDeque() {
+    Array *array = _array.load();
+    for (int64_t i = _top.load(); i < _bottom.load(); i++) {
+        delete array->Get(i);
+    }
+}
+
+// See Executor.h
+void Executor::WorkDeque::Push(Task *task) {
+    int64_t bottom = _bottom.load(std::memory_order_relaxed);
+    int64_t top = _top.load(std::memory_order_acquire);
+    Array *array = _array.load(std::memory_order_relaxed);
+    if (bottom - top > int64_t(array->mask)) {
+        array = grow(array, top, bottom);
+    }
+    array->Put(bottom, task);
+
+    // Task must be in the array before thieves could see it
+    _bottom.store(bottom + 1, std::memory_order_release);
+}
+
+// See Executor.h
+Executor::Task *Executor::WorkDeque::Pop() {
+    int64_t bottom = _bottom.load(std::memory_order_relaxed) - 1;
+    Array *array = _array.load(std::memory_order_relaxed);
+    _bottom.store(bottom, std::memory_order_relaxed);
+
+    // Either thieves see bottom taken back or we see their top
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = _top.load(std::memory_order_relaxed);
+    if (top > bottom) {
+        _bottom.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Task *task = array->Get(bottom);
+    if (top == bottom) {
+        // The last task: race with thieves for it
+        if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            task = nullptr;
+        }
+        _bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return task;
+}
+
+// See Executor.h
+Executor::Task *Executor::WorkDeque::Steal() {
+    int64_t top = _top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t bottom = _bottom.load(std::memory_order_acquire);
+    if (top >= bottom) {
+        return nullptr;
+    }
+
+    Array *array = _array.load(std::memory_order_acquire);
+    Task *task = array->Get(top);
+    if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    return task;
+}
+
+// See Executor.h
+bool Executor::WorkDeque::Empty() const {
+    int64_t top = _top.load(std::memory_order_acquire);
+    return _bottom.load(std::memory_order_acquire) <= top;
+}
+
+Executor::WorkDeque::Array *Executor::WorkDeque::grow(Array *array, int64_t top, int64_t bottom) {
+    std::unique_ptr<Array> bigger(new Array(2 * (array->mask + 1)));
+    for (int64_t i = top; i < bottom; i++) {
+        bigger->Put(i, array->Get(i));
+    }
+    _arrays.push_back(std::move(bigger));
+    _array.store(_arrays.back().get(), std::memory_order_release);
+    return _arrays.back().get();
+}
+
+void perform(Executor *executor, Executor::Worker *self) {
+    current_worker = self;
+    std::unique_lock<std::mutex> lock(executor->mutex, std::defer_lock);
+    for (;;) {
+        Executor::Task *task = executor->find_task(self);
+        if (task != nullptr) {
+            executor->busy.fetch_add(1);
+        } else {
+            lock.lock();
+            executor->idle.fetch_add(1);
+            // Pairs with the fence of Execute: either submitter sees us idle or we see its task
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            bool exit = false;
+            for (;;) {
+                if (!executor->tasks.empty()) {
+                    task = executor->tasks.front();
+                    executor->tasks.pop_front();
+                    // Counted as busy under the lock, so that Execute never misses it
+                    executor->busy.fetch_add(1);
+                    break;
+                }
+                if (executor->can_steal(self)) {
+                    break;
+                }
+                if (executor->state.load() != Executor::State::kRun) {
+                    exit = true;
+                    break;
+                }
+                if (executor->empty_condition.wait_for(lock, executor->_idle_time) == std::cv_status::timeout &&
+                    executor->threads > executor->_low_watermark && executor->tasks.empty() &&
+                    !executor->can_steal(self)) {
+                    exit = true;
+                    break;
+                }
+            }
+            executor->idle.fetch_sub(1);
+
+            if (exit) {
+                // Nothing could be pushed into our deque anymore, slot is free for the next thread
+                self->used = false;
+                current_worker = nullptr;
+                if (--executor->threads == 0 && executor->state.load() == Executor::State::kStopping) {
+                    executor->state.store(Executor::State::kStopped);
+                    executor->stop_condition.notify_all();
+                }
+                return;
+            }
+            lock.unlock();
+        }
+
+        if (task != nullptr) {
+            // Task must handle its errors by itself, thread keeps serving the pool anyway
+            try {
+                (*task)();
+            } catch (...) {
+            }
+            delete task;
+            executor->busy.fetch_sub(1);
+        }
+    }
+}
+
+// See Executor.h
+Executor::Executor(std::string name, size_t low_watermark, size_t high_watermark, size_t max_queue_size,
+                   std::chrono::milliseconds idle_time)
+    : _name(std::move(name)), _low_watermark(low_watermark), _high_watermark(high_watermark),
+      _max_queue_size(max_queue_size), _idle_time(idle_time), _workers(new Worker[high_watermark]), threads(0),
+      idle(0), busy(0), state(State::kRun) {
+    if (high_watermark == 0 || low_watermark > high_watermark) {
+        throw std::invalid_argument("Executor " + _name + " must have 0 < low_watermark <= high_watermark");
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (size_t i = 0; i < _low_watermark; i++) {
+        spawn();
+    }
+}
+
+// See Executor.h
+Executor::~Executor() {
+    Stop(true);
+    for (auto task : tasks) {
+        delete task;
+    }
+}
+
+// See Executor.h
+void Executor::Stop(bool await) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (state.load() == State::kRun) {
+        state.store(threads == 0 ? State::kStopped : State::kStopping);
+    }
+    empty_condition.notify_all();
+    if (await) {
+        stop_condition.wait(lock, [this] { return threads == 0; });
+    }
+}
+
+// See Executor.h
+size_t Executor::Threads() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return threads;
+}
+
+// See Executor.h
+Executor::State Executor::GetState() const { return state.load(); }
+
+bool Executor::execute(Task task) {
+    Worker *self = current();
+    if (self != nullptr) {
+        // Pool threads keep what they submit, idle siblings steal it
+        if (state.load() != State::kRun) {
+            return false;
+        }
+        self->deque.Push(new Task(std::move(task)));
+
+        // Pairs with the fence of the thread going to sleep
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (idle.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lock(mutex);
+            empty_condition.notify_one();
+        }
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (state.load() != State::kRun) {
+        return false;
+    }
+
+    // Task is accepted if some thread takes it right away or there is room in the queue. Threads that
+    // aren't busy are going to take queued tasks, even if they are just starting
+    size_t free = threads - std::min(threads, busy.load());
+    if (tasks.size() >= free + (_high_watermark - threads) + _max_queue_size) {
+        return false;
+    }
+
+    tasks.push_back(new Task(std::move(task)));
+    if (tasks.size() > free && threads < _high_watermark) {
+        spawn();
+    } else {
+        empty_condition.notify_one();
+    }
+    return true;
+}
+
+Executor::Task *Executor::find_task(Worker *self) {
+    Task *task = self->deque.Pop();
+    if (task != nullptr) {
+        return task;
+    }
+
+    // Victims are walked starting from the next slot, so that thieves don't all hit the same deque
+    size_t index = self - _workers.get();
+    for (size_t i = 1; i < _high_watermark; i++) {
+        task = _workers[(index + i) % _high_watermark].deque.Steal();
+        if (task != nullptr) {
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+bool Executor::can_steal(const Worker *self) const {
+    for (size_t i = 0; i < _high_watermark; i++) {
+        if (&_workers[i] != self && !_workers[i].deque.Empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Executor::spawn() {
+    for (size_t i = 0; i < _high_watermark; i++) {
+        if (!_workers[i].used) {
+            std::thread(perform, this, &_workers[i]).detach();
+            _workers[i].used = true;
+            threads++;
+            return;
+        }
+    }
+}
+
+Executor::Worker *Executor::current() const {
+    auto worker = reinterpret_cast<uintptr_t>(current_worker);
+    auto first = reinterpret_cast<uintptr_t>(_workers.get());
+    if (worker < first || worker >= first + _high_watermark * sizeof(Worker)) {
+        return nullptr;
+    }
+    return static_cast<Worker *>(current_worker);
+}
+
+} // namespace Concurrency
 } // namespace Afina
@@ -0,0 +1,108 @@
+#include <afina/concurrency/Mutex.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace Afina {
+namespace Concurrency {
+
+namespace {
+
+// Profiles by name, never released so that mutexes of static objects could report till the very end
+struct Registry {
+    std::mutex lock;
+    std::map<std::string, std::unique_ptr<LockProfile>> profiles;
+};
+
+Registry &registry() {
+    static Registry *instance = new Registry;
+    return *instance;
+}
+
+// Tells CPU that we are spinning, so that it could give resources to the other hyperthread
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+} // namespace
+
+// See Mutex.h
+LockProfile &LockProfile::Get(const std::string &name) {
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.lock);
+    auto &profile = r.profiles[name];
+    if (profile == nullptr) {
+        profile.reset(new LockProfile(name));
+    }
+    return *profile;
+}
+
+// See Mutex.h
+void LockProfile::ForEach(const std::function<void(const LockProfile &)> &f) {
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.lock);
+    for (auto &it : r.profiles) {
+        f(*it.second);
+    }
+}
+
+void LockProfile::waited(uint64_t time) {
+    _wait_time.Add(time);
+    uint64_t max = _max_wait_time.load(std::memory_order_relaxed);
+    while (time > max && !_max_wait_time.compare_exchange_weak(max, time, std::memory_order_relaxed)) {
+    }
+}
+
+void Mutex::lock_contended() {
+    uint64_t start = now();
+    _profile._contended.Add();
+
+    // Owner can't release lock while we occupy the only CPU
+    static const bool spin = std::thread::hardware_concurrency() > 1;
+    if (spin) {
+        int32_t spins = _spins.load(std::memory_order_relaxed);
+        int32_t limit = spins * 2 + 10;
+        limit = limit > kMaxSpins ? kMaxSpins : (limit < kMinSpins ? kMinSpins : limit);
+        int32_t i = 0;
+        for (; i < limit; i++) {
+            uint32_t expected = kFree;
+            if (_state.load(std::memory_order_relaxed) == kFree &&
+                _state.compare_exchange_weak(expected, kLocked, std::memory_order_acquire,
+                                             std::memory_order_relaxed)) {
+                break;
+            }
+            cpu_relax();
+        }
+
+        // Estimate follows the number of spins lock took lately, or grows towards the limit if spinning failed
+        _spins.store(spins + (i - spins) / 8, std::memory_order_relaxed);
+        if (i < limit) {
+            _profile.waited(now() - start);
+            return;
+        }
+    }
+
+    // Lock taken after sleep stays marked as having sleepers, since there could be others
+    static_assert(sizeof(_state) == sizeof(uint32_t), "Futex must be a plain 32-bit word");
+    while (_state.exchange(kSleepers, std::memory_order_acquire) != kFree) {
+        syscall(SYS_futex, reinterpret_cast<uint32_t *>(&_state), FUTEX_WAIT_PRIVATE, kSleepers, nullptr, nullptr, 0);
+    }
+    _profile.waited(now() - start);
+}
+
+void Mutex::wake() {
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&_state), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+}
+
+} // namespace Concurrency
+} // namespace Afina
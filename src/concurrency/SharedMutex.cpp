@@ -0,0 +1,91 @@
+#include <afina/concurrency/SharedMutex.h>
+
+#include <thread>
+
+namespace Afina {
+namespace Concurrency {
+
+// See SharedMutex.h
+void SharedMutex::lock() {
+    _writers.lock();
+
+    // Reader that increments its counter after the flag is raised sees the flag and backs off, the one that
+    // did it before is seen by the scan below
+    _writer.store(true, std::memory_order_seq_cst);
+    for (size_t spins = 0; readers() != 0; spins++) {
+        if (spins > kSpins) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+// See SharedMutex.h
+bool SharedMutex::try_lock() {
+    if (!_writers.try_lock()) {
+        return false;
+    }
+
+    _writer.store(true, std::memory_order_seq_cst);
+    if (readers() != 0) {
+        unlock();
+        return false;
+    }
+    return true;
+}
+
+// See SharedMutex.h
+void SharedMutex::unlock() {
+    {
+        std::lock_guard<std::mutex> lock(_wait_lock);
+        _writer.store(false, std::memory_order_seq_cst);
+    }
+    _writer_left.notify_all();
+    _writers.unlock();
+}
+
+// See SharedMutex.h
+void SharedMutex::lock_shared() {
+    for (;;) {
+        std::atomic<int64_t> &count = _readers.Local();
+        count.fetch_add(1, std::memory_order_seq_cst);
+        if (!_writer.load(std::memory_order_seq_cst)) {
+            return;
+        }
+
+        // Writer goes first
+        count.fetch_sub(1, std::memory_order_release);
+        wait_writer();
+    }
+}
+
+// See SharedMutex.h
+bool SharedMutex::try_lock_shared() {
+    std::atomic<int64_t> &count = _readers.Local();
+    count.fetch_add(1, std::memory_order_seq_cst);
+    if (!_writer.load(std::memory_order_seq_cst)) {
+        return true;
+    }
+    count.fetch_sub(1, std::memory_order_release);
+    return false;
+}
+
+int64_t SharedMutex::readers() const {
+    return _readers.Aggregate(int64_t(0), [](int64_t sum, const std::atomic<int64_t> &count) {
+        return sum + count.load(std::memory_order_seq_cst);
+    });
+}
+
+void SharedMutex::wait_writer() {
+    // Writers usually hold the lock for a short time, so it is worth to wait a bit before going to sleep
+    for (size_t spins = 0; spins < kSpins; spins++) {
+        if (!_writer.load(std::memory_order_acquire)) {
+            return;
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(_wait_lock);
+    _writer_left.wait(lock, [this]() { return !_writer.load(std::memory_order_acquire); });
+}
+
+} // namespace Concurrency
+} // namespace Afina
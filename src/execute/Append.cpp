@@ -1,21 +1,24 @@
 #include <afina/Storage.h>
 #include <afina/execute/Append.h>
-
-#include <iostream>
+#include <afina/logging/Trace.h>
 
 namespace Afina {
 namespace Execute {
 
 // memcached protocol: "append" means "add this data to an existing key after existing data".
 void Append::Execute(Storage &storage, const std::string &args, std::string &out) {
-    std::cout << "Append(" << _key << ")" << args << std::endl;
+    AFINA_TRACE(logger(), "Append({}): {} bytes", _key, args.size());
     std::string value;
-    if (!storage.Get(_key, value)) {
+    ItemMeta meta;
+    if (!storage.Get(_key, value, meta)) {
         out.assign("NOT_STORED");
         return;
     }
-    value.erase(value.end() - 2, value.end());
-    storage.Put(_key, value + args);
+    if (value.size() >= 2 && value[value.size() - 1] == '\n') {
+        value.erase(value.end() - 2, value.end());
+    }
+    // Item keeps its own flags and expiration time, ones of the command are ignored
+    storage.Put(_key, value + args, meta.flags, static_cast<int32_t>(meta.deadline));
     out.assign("STORED");
 }
 
@@ -0,0 +1,44 @@
+#include <afina/Storage.h>
+#include <afina/execute/ArithmeticCommand.h>
+#include <afina/logging/Trace.h>
+
+#include <limits>
+
+namespace Afina {
+namespace Execute {
+
+// memcached protocol: "incr" and "decr" change data for some item in-place, incrementing or decrementing it.
+void ArithmeticCommand::Execute(Storage &storage, const std::string &args, std::string &out) {
+    AFINA_TRACE(logger(), "Arithmetic({}, {})", _key, _delta);
+    // Value is parsed and replaced within the storage, so that concurrent updates of the key aren't lost
+    bool numeric = true;
+    bool found = storage.Modify(_key, [this, &numeric, &out](std::string &value) {
+        if (value.size() >= 2 && value[value.size() - 1] == '\n') {
+            value.erase(value.end() - 2, value.end());
+        }
+
+        uint64_t number = 0;
+        for (char c : value) {
+            uint64_t digit = c - '0';
+            if (c < '0' || c > '9' || number > (std::numeric_limits<uint64_t>::max() - digit) / 10) {
+                numeric = false;
+                return false;
+            }
+            number = number * 10 + digit;
+        }
+
+        // Item keeps its own flags and expiration time
+        out = std::to_string(Apply(number));
+        value = out + "\r\n";
+        return true;
+    });
+
+    if (!found) {
+        out.assign("NOT_FOUND");
+    } else if (!numeric) {
+        out.assign("CLIENT_ERROR cannot increment or decrement non-numeric value");
+    }
+}
+
+} // namespace Execute
+} // namespace Afina
@@ -0,0 +1,28 @@
+#include <afina/Storage.h>
+#include <afina/execute/Cas.h>
+#include <afina/logging/Trace.h>
+
+namespace Afina {
+namespace Execute {
+
+// memcached protocol: "cas" means "store this data but only if no one else has updated since I last fetched it".
+void Cas::Execute(Storage &storage, const std::string &args, std::string &out) {
+    AFINA_TRACE(logger(), "Cas({}, {}): {} bytes", _key, _cas, args.size());
+    switch (storage.CompareAndSet(_key, args, _flags, _expire, _cas)) {
+    case Storage::CasResult::kStored:
+        out.assign("STORED");
+        break;
+    case Storage::CasResult::kExists:
+        out.assign("EXISTS");
+        break;
+    case Storage::CasResult::kNotFound:
+        out.assign("NOT_FOUND");
+        break;
+    case Storage::CasResult::kNotStored:
+        out.assign("NOT_STORED");
+        break;
+    }
+}
+
+} // namespace Execute
+} // namespace Afina
@@ -1 +1,23 @@
 #include <afina/execute/Command.h>
+#include <afina/execute/Response.h>
+
+#include <spdlog/spdlog.h>
+
+namespace Afina {
+namespace Execute {
+
+// See Command.h
+void Command::Execute(Storage &storage, const std::string &args, Response &out) {
+    std::string result;
+    Execute(storage, args, result);
+    out.Append(result);
+}
+
+// See Command.h
+std::shared_ptr<spdlog::logger> Command::logger() {
+    std::shared_ptr<spdlog::logger> result = spdlog::get("execute");
+    return result != nullptr ? result : spdlog::get("root");
+}
+
+} // namespace Execute
+} // namespace Afina
@@ -0,0 +1,15 @@
+#include <afina/Storage.h>
+#include <afina/execute/Delete.h>
+#include <afina/logging/Trace.h>
+
+namespace Afina {
+namespace Execute {
+
+// memcached protocol: "delete" means "remove the item with the key".
+void Delete::Execute(Storage &storage, const std::string &args, std::string &out) {
+    AFINA_TRACE(logger(), "Delete({})", _key);
+    out = storage.Delete(_key) ? "DELETED" : "NOT_FOUND";
+}
+
+} // namespace Execute
+} // namespace Afina
@@ -0,0 +1,19 @@
+#include <afina/Storage.h>
+#include <afina/execute/Gat.h>
+
+namespace Afina {
+namespace Execute {
+
+// See Gat.h
+void Gat::Lookup(Storage &storage, const Storage::MultiGetCallback &found) {
+    ValueRef value;
+    ItemMeta meta;
+    for (size_t i = 0; i < _count; i++) {
+        if (storage.Touch(_keys[i], _expire, &value, &meta)) {
+            found(i, value, meta);
+        }
+    }
+}
+
+} // namespace Execute
+} // namespace Afina
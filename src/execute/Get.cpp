@@ -1,9 +1,12 @@
 #include <afina/Storage.h>
 #include <afina/execute/Get.h>
+#include <afina/execute/Response.h>
+#include <afina/execute/Stats.h>
+#include <afina/logging/Trace.h>
 
-#include <iostream>
-#include <iterator>
-#include <sstream>
+#include <cstdio>
+#include <memory>
+#include <utility>
 
 namespace Afina {
 namespace Execute {
@@ -22,26 +25,74 @@ to indicate the end of response.
 */
 
 void Get::Execute(Storage &storage, const std::string &args, std::string &out) {
-    std::stringstream keyStream;
-    copy(_keys.begin(), _keys.end(), std::ostream_iterator<std::string>(keyStream, " "));
-    std::cout << "Get(" << keyStream.str() << ")" << std::endl;
+    Response response;
+    Execute(storage, args, response);
 
-    std::stringstream outStream;
+    out.clear();
+    response.AppendTo(out);
+}
+
+// See Get.h
+void Get::Execute(Storage &storage, const std::string &args, Response &out) {
+    AFINA_TRACE(logger(), "Get({} keys): {}", _count, _count == 0 ? std::string() : _keys[0]);
+
+    Item local[kLocalItems];
+    std::unique_ptr<Item[]> heap;
+    Item *items = local;
+    if (_count > kLocalItems) {
+        heap.reset(new Item[_count]);
+        items = heap.get();
+    }
+    Retrieve(storage, items);
 
-    std::string value;
-    for (auto &key : _keys) {
-        if (!storage.Get(key, value))
+    char number[24];
+    for (size_t i = 0; i < _count; i++) {
+        Item &item = items[i];
+        if (!item.found) {
             continue;
-        if (value[value.size() - 1] == '\n') {
-            value.erase(value.end() - 2, value.end());
         }
-        outStream << "VALUE " << key << " 0 " << value.size() << "\r\n";
-        outStream << value << "\r\n";
+
+        // Header goes right into the response text, pieces of it join a single segment
+        out.Append("VALUE ", 6);
+        out.Append(_keys[i]);
+        out.Append(number, snprintf(number, sizeof(number), " %u %zu", item.meta.flags, item.value.size()));
+        if (_with_cas) {
+            out.Append(number, snprintf(number, sizeof(number), " %llu", (unsigned long long)item.meta.cas));
+        }
+        out.Append("\r\n", 2);
+        out.Append(std::move(item.value));
+        out.Append("\r\n", 2);
     }
-    outStream << "END"; // networking layer should add the last \r\n
+    out.Append("END", 3); // networking layer should add the last \r\n
+}
 
-    out = outStream.str();
+// See Get.h
+void Get::Retrieve(Storage &storage, Item *items) {
+    // Storage reports items in the order it finds convenient, they are put in the order of keys. Callback
+    // could run on another thread (see Storage::MultiGet), so it fills the buffer of this call only
+    Lookup(storage, [items](size_t i, ValueRef &value, const ItemMeta &meta) {
+        items[i].value = std::move(value);
+        items[i].meta = meta;
+        items[i].found = true;
+    });
+
+    Stats::Counters &counters = Stats::Global();
+    counters.cmd_get.Add(_count);
+    for (size_t i = 0; i < _count; i++) {
+        Item &item = items[i];
+        if (!item.found) {
+            counters.get_misses.Add();
+            continue;
+        }
+        counters.get_hits.Add();
+        if (item.value.size() >= 2 && item.value.data()[item.value.size() - 1] == '\n') {
+            item.value.RemoveSuffix(2);
+        }
+    }
 }
 
+// See Get.h
+void Get::Lookup(Storage &storage, const Storage::MultiGetCallback &found) { storage.MultiGet(_keys, _count, found); }
+
 } // namespace Execute
 } // namespace Afina
@@ -0,0 +1,27 @@
+#include <afina/Storage.h>
+#include <afina/execute/Prepend.h>
+#include <afina/logging/Trace.h>
+
+namespace Afina {
+namespace Execute {
+
+// memcached protocol: "prepend" means "add this data to an existing key before existing data".
+void Prepend::Execute(Storage &storage, const std::string &args, std::string &out) {
+    AFINA_TRACE(logger(), "Prepend({}): {} bytes", _key, args.size());
+    std::string value;
+    ItemMeta meta;
+    if (!storage.Get(_key, value, meta)) {
+        out.assign("NOT_STORED");
+        return;
+    }
+    std::string data = args;
+    if (data.size() >= 2 && data[data.size() - 1] == '\n') {
+        data.erase(data.end() - 2, data.end());
+    }
+    // Item keeps its own flags and expiration time, ones of the command are ignored
+    storage.Put(_key, data + value, meta.flags, static_cast<int32_t>(meta.deadline));
+    out.assign("STORED");
+}
+
+} // namespace Execute
+} // namespace Afina
@@ -1,7 +1,6 @@
 #include <afina/Storage.h>
 #include <afina/execute/Replace.h>
-
-#include <iostream>
+#include <afina/logging/Trace.h>
 
 namespace Afina {
 namespace Execute {
@@ -10,10 +9,10 @@ namespace Execute {
 // already hold data for this key".
 
 void Replace::Execute(Storage &storage, const std::string &args, std::string &out) {
-    std::cout << "Replace(" << _key << "): " << args << std::endl;
+    AFINA_TRACE(logger(), "Replace({}): {} bytes", _key, args.size());
     std::string value;
     if (storage.Get(_key, value)) {
-        storage.Set(_key, args);
+        storage.Set(_key, args, _flags, _expire);
         out = "STORED";
     } else {
         out = "NOT_STORED";
@@ -0,0 +1,72 @@
+#include <afina/execute/Response.h>
+
+namespace Afina {
+namespace Execute {
+
+// See Response.h
+void Response::Append(const char *data, size_t size) {
+    if (size == 0) {
+        return;
+    }
+
+    // Text written one after another makes a single segment
+    if (!_segments.empty() && _segments.back().data == nullptr &&
+        _segments.back().offset + _segments.back().size == _text.size()) {
+        _segments.back().size += size;
+    } else {
+        _segments.push_back(Segment{nullptr, _text.size(), size});
+    }
+    _text.append(data, size);
+    _size += size;
+}
+
+// See Response.h
+void Response::Append(ValueRef value) {
+    if (value.size() <= kInlineValueSize) {
+        Append(value.data(), value.size());
+        return;
+    }
+
+    _segments.push_back(Segment{value.data(), 0, value.size()});
+    _size += value.size();
+    _values.push_back(std::move(value));
+}
+
+// See Response.h
+size_t Response::Fill(struct iovec *iov, size_t max, size_t offset) const {
+    size_t filled = 0;
+    for (const Segment &segment : _segments) {
+        if (filled == max) {
+            break;
+        }
+        if (offset >= segment.size) {
+            offset -= segment.size;
+            continue;
+        }
+
+        iov[filled].iov_base = const_cast<char *>(data_of(segment)) + offset;
+        iov[filled].iov_len = segment.size - offset;
+        offset = 0;
+        filled++;
+    }
+    return filled;
+}
+
+// See Response.h
+void Response::AppendTo(std::string &out) const {
+    out.reserve(out.size() + _size);
+    for (const Segment &segment : _segments) {
+        out.append(data_of(segment), segment.size);
+    }
+}
+
+// See Response.h
+void Response::Clear() {
+    _text.clear();
+    _segments.clear();
+    _values.clear();
+    _size = 0;
+}
+
+} // namespace Execute
+} // namespace Afina
@@ -1,16 +1,14 @@
 #include <afina/Storage.h>
 #include <afina/execute/Set.h>
-
-#include <iostream>
-#include <unistd.h>
+#include <afina/logging/Trace.h>
 
 namespace Afina {
 namespace Execute {
 
 // memcached protocol: "set" means "store this data".
 void Set::Execute(Storage &storage, const std::string &args, std::string &out) {
-    std::cout << "Set(" << _key << "): " << args << std::endl;
-    storage.Put(_key, args);
+    AFINA_TRACE(logger(), "Set({}): {} bytes", _key, args.size());
+    storage.Put(_key, args, _flags, _expire);
     out = "STORED";
     //sleep(30);
 }
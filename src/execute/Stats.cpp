@@ -1,14 +1,47 @@
 #include <afina/Storage.h>
+#include <afina/concurrency/Mutex.h>
 #include <afina/execute/Stats.h>
 
-#include <iostream>
-#include <iterator>
-#include <sstream>
-
 namespace Afina {
 namespace Execute {
 
-void Stats::Execute(Storage &storage, const std::string &args, std::string &out) { out.assign("END"); }
+// See Stats.h
+Stats::Counters &Stats::Global() {
+    static Counters counters;
+    return counters;
+}
+
+// See Stats.h
+void Stats::Execute(Storage &storage, const std::string &args, std::string &out) {
+    out.clear();
+    if (_group == Group::kLocks) {
+        Concurrency::LockProfile::ForEach([&out](const Concurrency::LockProfile &profile) {
+            auto stat = [&out, &profile](const char *name, uint64_t value) {
+                out += "STAT " + profile.Name() + ":" + name + " " + std::to_string(value) + "\r\n";
+            };
+            stat("acquired", profile.Acquisitions());
+            stat("contended", profile.Contended());
+            stat("wait_ns", profile.WaitTime());
+            stat("max_wait_ns", profile.MaxWaitTime());
+            stat("hold_ns", profile.HoldTime());
+        });
+        out += "END";
+        return;
+    }
+
+    Counters &counters = Global();
+    auto stat = [&out](const char *name, uint64_t value) {
+        out += "STAT ";
+        out += name;
+        out += " " + std::to_string(value) + "\r\n";
+    };
+    stat("cmd_get", counters.cmd_get.Get());
+    stat("get_hits", counters.get_hits.Get());
+    stat("get_misses", counters.get_misses.Get());
+    stat("bytes_read", counters.bytes_read.Get());
+    stat("bytes_written", counters.bytes_written.Get());
+    out += "END";
+}
 
 } // namespace Execute
 } // namespace Afina
@@ -20,9 +20,16 @@
 #include "network/st_blocking/ServerImpl.h"
 #include "network/st_coroutine/ServerImpl.h"
 #include "network/st_nonblocking/ServerImpl.h"
+#include "network/uring/ServerImpl.h"
 
+#include "storage/EvictionPolicy.h"
+#include "storage/FlatCombinedLRU.h"
+#include "storage/RCUClock.h"
+#include "storage/ShardedLRU.h"
+#include "storage/SharedClockLRU.h"
 #include "storage/SimpleLRU.h"
 #include "storage/ThreadSafeSimpleLRU.h"
+#include "storage/TinyLFU.h"
 
 using namespace Afina;
 
@@ -51,10 +58,34 @@ public:
             storage_type = options["storage"].as<std::string>();
         }
 
+        size_t memory = 64 * 1024 * 1024;
+        if (options.count("memory") > 0) {
+            memory = options["memory"].as<size_t>();
+        }
+
+        auto eviction = Afina::Backend::EvictionPolicy::Type::kLRU;
+        if (options.count("eviction") > 0) {
+            eviction = Afina::Backend::EvictionPolicy::FromName(options["eviction"].as<std::string>());
+        }
+
         if (storage_type == "st_lru") {
-            storage = std::make_shared<Afina::Backend::SimpleLRU>();
+            storage = std::make_shared<Afina::Backend::SimpleLRU>(memory, eviction);
+        } else if (storage_type == "st_tinylfu") {
+            storage = std::make_shared<Afina::Backend::TinyLFU>(memory);
         } else if (storage_type == "mt_lru") {
-            storage = std::make_shared<Afina::Backend::ThreadSafeSimplLRU>();
+            storage = std::make_shared<Afina::Backend::ThreadSafeSimplLRU>(memory, eviction);
+        } else if (storage_type == "mt_fc_lru") {
+            storage = std::make_shared<Afina::Backend::FlatCombinedLRU>(memory, eviction);
+        } else if (storage_type == "mt_sharded_lru") {
+            uint32_t shards = 4;
+            if (options.count("shards") > 0) {
+                shards = options["shards"].as<uint32_t>();
+            }
+            storage = std::make_shared<Afina::Backend::ShardedLRU>(memory, shards, eviction);
+        } else if (storage_type == "mt_shared_clock") {
+            storage = std::make_shared<Afina::Backend::SharedClockLRU>(memory);
+        } else if (storage_type == "mt_rcu_clock") {
+            storage = std::make_shared<Afina::Backend::RCUClock>(memory);
         } else {
             throw std::runtime_error("Unknown storage type");
         }
@@ -73,8 +104,15 @@ public:
             server = std::make_shared<Afina::Network::STnonblock::ServerImpl>(storage, logService);
         } else if (network_type == "mt_nonblock") {
             server = std::make_shared<Afina::Network::MTnonblock::ServerImpl>(storage, logService);
+        } else if (network_type == "mt_nonblock_reuseport") {
+            server = std::make_shared<Afina::Network::MTnonblock::ServerImpl>(
+                storage, logService, Afina::Network::MTnonblock::ServerImpl::Mode::kReusePort);
         } else if (network_type == "st_coroutine") {
             server = std::make_shared<Afina::Network::STcoroutine::ServerImpl>(storage, logService);
+        } else if (network_type == "st_uring") {
+            server = std::make_shared<Afina::Network::Uring::ServerImpl>(storage, logService, true);
+        } else if (network_type == "mt_uring") {
+            server = std::make_shared<Afina::Network::Uring::ServerImpl>(storage, logService);
         } else {
             throw std::runtime_error("Unknown network type");
         }
@@ -131,6 +169,9 @@ int main(int argc, char **argv) {
         // TODO: use custom cxxopts::value to print options possible values in help message
         // and simplify validation below
         options.add_options()("s,storage", "Type of storage service to use", cxxopts::value<std::string>());
+        options.add_options()("m,memory", "Memory limit of storage in bytes", cxxopts::value<size_t>());
+        options.add_options()("shards", "Number of shards for mt_sharded_lru storage", cxxopts::value<uint32_t>());
+        options.add_options()("eviction", "Eviction policy of lru storages: lru or clock", cxxopts::value<std::string>());
         options.add_options()("n,network", "Type of network service to use", cxxopts::value<std::string>());
         options.add_options()("h,help", "Print usage info");
         options.parse(argc, argv);
@@ -146,7 +187,12 @@ int main(int argc, char **argv) {
 
     // Start boot sequence
     Application app;
-    app.Configure(options);
+    try {
+        app.Configure(options);
+    } catch (std::exception &ex) {
+        std::cerr << "Error: " << ex.what() << std::endl;
+        return 1;
+    }
 
     // POSIX specific staff
     {
@@ -13,22 +13,50 @@
 #include <signal.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include <spdlog/logger.h>
 
 #include <afina/Storage.h>
 #include <afina/execute/Command.h>
+#include <afina/execute/Response.h>
 #include <afina/logging/Service.h>
 
 #include "protocol/Parser.h"
+#include "protocol/ReadBuffer.h"
 
 namespace Afina {
 namespace Network {
 namespace MTblocking {
 
+namespace {
+
+// Maximum number of segments sent by a single writev
+const size_t kMaxSegments = 64;
+
+// Blocks until whole response is sent, values go out right from the storage memory
+void send_response(int socket, const Execute::Response &response) {
+    struct iovec iov[kMaxSegments];
+    size_t written = 0;
+    while (written < response.Size()) {
+        size_t count = response.Fill(iov, kMaxSegments, written);
+        ssize_t written_bytes = writev(socket, iov, count);
+        if (written_bytes <= 0) {
+            if (written_bytes < 0 && errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Failed to send response");
+        }
+        written += written_bytes;
+    }
+}
+
+} // namespace
+
 // See Server.h
-ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl) : Server(ps, pl) {}
+ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl)
+    : Server(ps, pl), _set_is_blocked("network.mt_blocking.connections") {}
 
 // See Server.h
 ServerImpl::~ServerImpl() {}
@@ -72,6 +100,9 @@ void ServerImpl::Start(uint16_t port, uint32_t n_accept, uint32_t n_workers) {
         throw std::runtime_error("Socket listen() failed");
     }
 
+    // Connection holds its thread until it is closed, so there is no queue: connection over the limit is refused
+    _executor.reset(new Concurrency::Executor("mt_blocking", 1, _max_workers, 0, std::chrono::milliseconds(1000)));
+
     _running.store(true);
     _thread = std::thread(&ServerImpl::OnRun, this);
 }
@@ -80,7 +111,7 @@ void ServerImpl::Start(uint16_t port, uint32_t n_accept, uint32_t n_workers) {
 void ServerImpl::Stop() {
     _running.store(false);
     shutdown(_server_socket, SHUT_RDWR);
-    std::unique_lock<std::mutex> lock(_set_is_blocked);
+    std::lock_guard<Concurrency::Mutex> lock(_set_is_blocked);
     for (auto descriptor : _client_descriptors) {
         shutdown(descriptor, SHUT_RD);
     }
@@ -92,13 +123,12 @@ void ServerImpl::Join() {
     _thread.join();
     close(_server_socket);
 
-    std::unique_lock<std::mutex> l(_thread_stopped);
-    _check_current_workers.wait(l, [this] { return this->_cnt_workers == 0; });
+    // Connections are shut down by Stop, so workers finish shortly
+    _executor->Stop(true);
 }
 
 // See Server.h
 void ServerImpl::OnRun() {
-    _cnt_workers.store(0);
     while (_running.load()) {
         _logger->debug("waiting for connection...");
 
@@ -131,16 +161,16 @@ void ServerImpl::OnRun() {
             setsockopt(client_socket, SOL_SOCKET, SO_RCVTIMEO, (const char *)&tv, sizeof tv);
         }
 
-        if (_cnt_workers < _max_workers && _running.load()) {
-            ++_cnt_workers;
-
-            {
-                std::lock_guard<std::mutex> l1(_set_is_blocked);
-                // running new worker
-                std::thread(&ServerImpl::worker, this, client_socket).detach();
-                // add new descriptor to the set
-                _client_descriptors.emplace(client_socket);
-            }
+        {
+            // Descriptor is registered before worker could close it
+            std::lock_guard<Concurrency::Mutex> l1(_set_is_blocked);
+            _client_descriptors.emplace(client_socket);
+        }
+        if (!_running.load() || !_executor->Execute(&ServerImpl::worker, this, client_socket)) {
+            _logger->warn("No free workers, connection on descriptor {} is refused", client_socket);
+            std::lock_guard<Concurrency::Mutex> l1(_set_is_blocked);
+            close(client_socket);
+            _client_descriptors.erase(client_socket);
         }
     }
 
@@ -151,13 +181,13 @@ void ServerImpl::OnRun() {
 void ServerImpl::worker(int client_socket) {
     // Here is connection state
     // - parser: parse state of the stream
-    // - command_to_execute: last command parsed out of stream
+    // - command_to_execute: last command parsed out of stream, it lives in the parser
     // - arg_remains: how many bytes to read from stream to get command argument
     // - argument_for_command: buffer stores argument
     std::size_t arg_remains = 0;
     Protocol::Parser parser;
     std::string argument_for_command;
-    std::unique_ptr<Execute::Command> command_to_execute;
+    Execute::Command *command_to_execute = nullptr;
 
     // Process new connection:
     // - read commands until socket alive
@@ -165,27 +195,26 @@ void ServerImpl::worker(int client_socket) {
     // - send response
     try {
         int read_bytes = -1;
-        char client_buffer[4096] = "";
-        while ((read_bytes = read(client_socket, client_buffer, sizeof(client_buffer))) > 0) {
+        Protocol::ReadBuffer input;
+        Execute::Response output;
+        while ((read_bytes = input.Read(client_socket)) > 0) {
             _logger->debug("Got {} bytes from socket", read_bytes);
 
             // Single block of data read from the socket could trigger inside actions a multiple times,
             // for example:
             // - read#0: [<command1 start>]
             // - read#1: [<command1 end> <argument> <command2> <argument for command 2> <command3> ... ]
-            while (read_bytes > 0) {
-                _logger->debug("Process {} bytes", read_bytes);
+            while (!input.Empty()) {
+                _logger->debug("Process {} bytes", input.Size());
                 // There is no command yet
                 if (!command_to_execute) {
                     std::size_t parsed = 0;
-                    if (parser.Parse(client_buffer, read_bytes, parsed)) {
+                    if (parser.Parse(input.Data(), input.Size(), parsed)) {
                         // There is no command to be launched, continue to parse input stream
                         // Here we are, current chunk finished some command, process it
                         _logger->debug("Found new command: {} in {} bytes", parser.Name(), parsed);
                         command_to_execute = parser.Build(arg_remains);
-                        if (arg_remains > 0) {
-                            arg_remains += 2;
-                        }
+                        arg_remains += parser.Trailer();
                     }
 
                     // Parsed might fails to consume any bytes from input stream. In real life that could happens,
@@ -193,42 +222,43 @@ void ServerImpl::worker(int client_socket) {
                     if (parsed == 0) {
                         break;
                     } else {
-                        std::memmove(client_buffer, client_buffer + parsed, read_bytes - parsed);
-                        read_bytes -= parsed;
+                        input.Consume(parsed);
                     }
                 }
 
                 // There is command, but we still wait for argument to arrive...
                 if (command_to_execute && arg_remains > 0) {
-                    _logger->debug("Fill argument: {} bytes of {}", read_bytes, arg_remains);
-                    // There is some parsed command, and now we are reading argument
-                    std::size_t to_read = std::min(arg_remains, std::size_t(read_bytes));
-                    argument_for_command.append(client_buffer, to_read);
+                    // Value that fits into the buffer is taken out once it is all there, larger one piece by piece
+                    if (input.Size() < arg_remains && input.Reserve(arg_remains)) {
+                        break;
+                    }
 
-                    std::memmove(client_buffer, client_buffer + to_read, read_bytes - to_read);
+                    _logger->debug("Fill argument: {} bytes of {}", input.Size(), arg_remains);
+                    std::size_t to_read = std::min(arg_remains, input.Size());
+                    argument_for_command.append(input.Data(), to_read);
+                    input.Consume(to_read);
                     arg_remains -= to_read;
-                    read_bytes -= to_read;
                 }
 
                 // There is command & argument - RUN!
                 if (command_to_execute && arg_remains == 0) {
                     _logger->debug("Start command execution");
 
-                    std::string result;
-                    command_to_execute->Execute(*pStorage, argument_for_command, result);
-
-                    // Send response
-                    result += "\r\n";
-                    if (send(client_socket, result.data(), result.size(), 0) <= 0) {
-                        throw std::runtime_error("Failed to send response");
-                    }
+                    // Response joins the ones of the commands before, all of them go out together
+                    parser.Run(*pStorage, argument_for_command, output);
 
                     // Prepare for the next command
-                    command_to_execute.reset();
+                    command_to_execute = nullptr;
                     argument_for_command.resize(0);
                     parser.Reset();
                 }
             } // while (read_bytes)
+
+            // Whole block of data is processed, send responses to all commands in it
+            if (!output.Empty()) {
+                send_response(client_socket, output);
+                output.Clear();
+            }
         }
 
         if (read_bytes == 0) {
@@ -243,15 +273,10 @@ void ServerImpl::worker(int client_socket) {
     // We are done with this connection
 
     {
-        std::lock_guard<std::mutex> l1(_set_is_blocked);
+        std::lock_guard<Concurrency::Mutex> l1(_set_is_blocked);
         close(client_socket);
         _client_descriptors.erase(client_socket);
     }
-
-    --_cnt_workers;
-    if (_cnt_workers == 0) {
-        _check_current_workers.notify_all();
-    }
 }
 
 
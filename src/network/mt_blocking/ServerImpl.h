@@ -2,10 +2,14 @@
 #define AFINA_NETWORK_MT_BLOCKING_SERVER_H
 
 #include <atomic>
-#include <thread>
+#include <memory>
+#include <mutex>
 #include <set>
+#include <thread>
+
+#include <afina/concurrency/Executor.h>
+#include <afina/concurrency/Mutex.h>
 #include <afina/network/Server.h>
-#include <condition_variable>
 
 namespace spdlog {
 class logger;
@@ -17,7 +21,7 @@ namespace MTblocking {
 
 /**
  * # Network resource manager implementation
- * Server that is spawning a separate thread for each connection
+ * Server that runs each connection on a thread of the pool, up to _max_workers connections at a time
  */
 class ServerImpl : public Server {
 public:
@@ -54,15 +58,15 @@ private:
     // Thread to run network on
     std::thread _thread;
 
-    std::atomic<int> _cnt_workers;
     const int _max_workers = 5;
 
-    std::condition_variable _check_current_workers;
-    std::mutex _thread_stopped;
+    // Threads connections are served on
+    std::unique_ptr<Concurrency::Executor> _executor;
 
     void worker(int socket);
 
-    std::mutex _set_is_blocked;
+    // Guards set of connections, profiled as network.mt_blocking.connections
+    Concurrency::Mutex _set_is_blocked;
     std::set<int> _client_descriptors;
 };
 
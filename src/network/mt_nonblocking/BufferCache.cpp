@@ -0,0 +1,41 @@
+#include "BufferCache.h"
+
+#include <cassert>
+
+namespace Afina {
+namespace Network {
+namespace MTnonblock {
+
+// See BufferCache.h
+std::unique_ptr<Buffers> BufferCache::Take() {
+    // Counters are written by the owner only, so there is no need in atomic increment
+    taken.store(taken.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (_cached.empty()) {
+        allocated.store(allocated.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return std::unique_ptr<Buffers>(new Buffers);
+    }
+
+    std::unique_ptr<Buffers> result = std::move(_cached.back());
+    _cached.pop_back();
+    return result;
+}
+
+// See BufferCache.h
+void BufferCache::Give(std::unique_ptr<Buffers> buffers) {
+    assert(buffers->input.Empty() && buffers->output.Empty());
+    if (_cached.size() >= kMaxCached) {
+        return;
+    }
+
+    // Argument of a large value isn't worth to be kept
+    if (buffers->argument.capacity() > Protocol::ReadBuffer::kPooledSize) {
+        std::string().swap(buffers->argument);
+    }
+    buffers->argument.clear();
+    buffers->parser.Clear();
+    _cached.push_back(std::move(buffers));
+}
+
+} // namespace MTnonblock
+} // namespace Network
+} // namespace Afina
@@ -0,0 +1,67 @@
+#ifndef AFINA_NETWORK_MT_NONBLOCKING_BUFFER_CACHE_H
+#define AFINA_NETWORK_MT_NONBLOCKING_BUFFER_CACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <afina/execute/Response.h>
+#include <protocol/Parser.h>
+#include <protocol/ReadBuffer.h>
+
+namespace Afina {
+namespace Network {
+namespace MTnonblock {
+
+/**
+ * # Working memory of the connection
+ * Everything connection needs while it has a request in progress: bytes read and not parsed yet, parser
+ * with the command built in it, argument of the command and responses not sent yet
+ */
+struct Buffers {
+    Protocol::ReadBuffer input;
+    Protocol::Parser parser;
+    std::string argument;
+    Execute::Response output;
+};
+
+/**
+ * # Buffers of the worker thread
+ * Connection takes buffers from the cache of the thread serving it once data arrives and gives them back to
+ * the cache of whatever thread is serving it once nothing is in progress anymore. So idle connections hold no
+ * memory, and requests are served by a few sets that already have grown to the sizes needed, without any
+ * allocation on the way
+ */
+class BufferCache {
+public:
+    // Sets kept for reuse, the rest of the ones given back are released
+    static const size_t kMaxCached = 64;
+
+    BufferCache() : taken(0), allocated(0) {}
+
+    /**
+     * Returns cached set or a new one if there is none
+     */
+    std::unique_ptr<Buffers> Take();
+
+    /**
+     * Keeps set for reuse, buffers must have nothing in progress
+     */
+    void Give(std::unique_ptr<Buffers> buffers);
+
+    // Number of sets taken and number of them allocated since cache was empty, could be read by any thread
+    std::atomic<uint64_t> taken;
+    std::atomic<uint64_t> allocated;
+
+private:
+    std::vector<std::unique_ptr<Buffers>> _cached;
+};
+
+} // namespace MTnonblock
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_MT_NONBLOCKING_BUFFER_CACHE_H
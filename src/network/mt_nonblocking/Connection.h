@@ -1,26 +1,32 @@
 #ifndef AFINA_NETWORK_MT_NONBLOCKING_CONNECTION_H
 #define AFINA_NETWORK_MT_NONBLOCKING_CONNECTION_H
 
+#include <afina/concurrency/ThreadLocal.h>
 #include <afina/execute/Command.h>
 #include <cstring>
-#include <protocol/Parser.h>
+#include <memory>
 #include <spdlog/logger.h>
 #include <sys/epoll.h>
 #include <vector>
 #include <atomic>
 
+#include "BufferCache.h"
+
 namespace Afina {
 namespace Network {
 namespace MTnonblock {
 
 class Connection {
 public:
-    Connection(int s, std::shared_ptr<Afina::Storage> &ps, std::shared_ptr<spdlog::logger> &pl)
-        : _socket(s), _pStorage(ps), _logger(pl) {
+    Connection(int s, std::shared_ptr<Afina::Storage> &ps, std::shared_ptr<spdlog::logger> &pl,
+               Concurrency::ThreadLocal<BufferCache> &buffer_cache)
+        : _socket(s), _buffer_cache(buffer_cache), _logger(pl), _pStorage(ps) {
         std::memset(&_event, 0, sizeof(struct epoll_event));
         _is_alive.store(true, std::memory_order_release);
         _data_available.store(false, std::memory_order_release);
-        _read_bytes = _head_written_count = 0;
+        _output_written = 0;
+        _command_to_execute = nullptr;
+        _read_closed = false;
         _event.data.ptr = this;
     }
 
@@ -35,6 +41,15 @@ protected:
     void DoWrite();
 
 private:
+    // There are responses not sent yet
+    bool has_output() const { return _buffers != nullptr && !_buffers->output.Empty(); }
+
+    // Gives buffers back to the cache of the current thread if nothing is in progress
+    void release_buffers();
+
+    // Maximum number of segments sent by a single writev
+    static const size_t kMaxSegments = 64;
+
     friend class Worker;
     friend class ServerImpl;
 
@@ -44,18 +59,21 @@ private:
     int _socket;
     struct epoll_event _event;
 
-    std::vector<std::string> _output_queue;
-    char _read_buffer[4096];
-    size_t _read_bytes;
-    int _head_written_count;
+    // Input, parser and output of the connection, taken from the thread serving it for the time some
+    // request is in progress. Responses of all commands read so far are written by a single writev once
+    // the input is processed, values in them reference storage memory
+    std::unique_ptr<Buffers> _buffers;
+    Concurrency::ThreadLocal<BufferCache> &_buffer_cache;
+    size_t _output_written;
+
+    // No more commands are going to be read, connection is closed once output is sent
+    bool _read_closed;
     std::shared_ptr<spdlog::logger> _logger;
     std::shared_ptr<Afina::Storage> _pStorage;
 
     // variables for parser
     std::size_t _arg_remains;
-    Protocol::Parser _parser;
-    std::string _argument_for_command;
-    std::unique_ptr<Execute::Command> _command_to_execute;
+    Execute::Command *_command_to_execute;
 };
 
 } // namespace MTnonblock
@@ -25,7 +25,9 @@ namespace Network {
 namespace MTnonblock {
 
 // See Server.h
-ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl) : Server(ps, pl) {}
+ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl, Mode mode)
+    : Server(ps, pl), _mode(mode), _server_socket(-1), _set_is_blocked("network.mt_nonblocking.connections"),
+      _data_epoll_fd(-1), _event_fd(-1) {}
 
 // See Server.h
 ServerImpl::~ServerImpl() {
@@ -36,7 +38,8 @@ ServerImpl::~ServerImpl() {
 // See Server.h
 void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers) {
     _logger = pLogging->select("network");
-    _logger->info("Start mt_nonblocking network service");
+    _logger->info("Start mt_nonblocking network service, {}",
+                  _mode == Mode::kReusePort ? "epoll per worker" : "shared epoll");
 
     sigset_t sig_mask;
     sigemptyset(&sig_mask);
@@ -45,34 +48,30 @@ void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers)
         throw std::runtime_error("Unable to mask SIGPIPE");
     }
 
-    // Create server socket
-    struct sockaddr_in server_addr;
-    std::memset(&server_addr, 0, sizeof(server_addr));
-    server_addr.sin_family = AF_INET;         // IPv4
-    server_addr.sin_port = htons(port);       // TCP port number
-    server_addr.sin_addr.s_addr = INADDR_ANY; // Bind to any address
-
-    _server_socket = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP);
-    if (_server_socket == -1) {
-        throw std::runtime_error("Failed to open socket: " + std::string(strerror(errno)));
-    }
-
-    int opts = 1;
-    if (setsockopt(_server_socket, SOL_SOCKET, (SO_REUSEADDR), &opts, sizeof(opts)) == -1) {
-        close(_server_socket);
-        throw std::runtime_error("Socket setsockopt() failed: " + std::string(strerror(errno)));
+    _event_fd = eventfd(0, EFD_NONBLOCK);
+    if (_event_fd == -1) {
+        throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
     }
 
-    if (bind(_server_socket, (struct sockaddr *)&server_addr, sizeof(server_addr)) == -1) {
-        close(_server_socket);
-        throw std::runtime_error("Socket bind() failed: " + std::string(strerror(errno)));
+    // Each worker listens and serves its connections on its own, there are no acceptors
+    if (_mode == Mode::kReusePort) {
+        _workers.reserve(n_workers);
+        for (int i = 0; i < n_workers; i++) {
+            _workers.emplace_back(pStorage, pLogging, this);
+            try {
+                _workers.back().Start(port, _event_fd);
+            } catch (...) {
+                // Failed worker has released what it took, the ones started before go away as well
+                _workers.pop_back();
+                ServerImpl::Stop();
+                ServerImpl::Join();
+                throw;
+            }
+        }
+        return;
     }
 
-    make_socket_non_blocking(_server_socket);
-    if (listen(_server_socket, 5) == -1) {
-        close(_server_socket);
-        throw std::runtime_error("Socket listen() failed: " + std::string(strerror(errno)));
-    }
+    _server_socket = make_server_socket(port, false);
 
     // Start IO workers
     _data_epoll_fd = epoll_create1(0);
@@ -80,11 +79,6 @@ void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers)
         throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
     }
 
-    _event_fd = eventfd(0, EFD_NONBLOCK);
-    if (_event_fd == -1) {
-        throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
-    }
-
     struct epoll_event event;
     event.events = EPOLLIN;
     event.data.ptr = nullptr;
@@ -108,23 +102,33 @@ void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers)
 // See Server.h
 void ServerImpl::Stop() {
     _logger->warn("Stop network service");
+
+    uint64_t taken = 0, allocated = 0;
+    _buffer_cache.ForEach([&taken, &allocated](BufferCache &cache) {
+        taken += cache.taken.load(std::memory_order_relaxed);
+        allocated += cache.allocated.load(std::memory_order_relaxed);
+    });
+    _logger->info("Connection buffers taken {} times, allocated {} times", taken, allocated);
+
     // Said workers to stop
     for (auto &w : _workers) {
         w.Stop();
     }
 
     // Wakeup threads that are sleep on epoll_wait
-    if (eventfd_write(_event_fd, 1)) {
+    if (_event_fd != -1 && eventfd_write(_event_fd, 1)) {
         throw std::runtime_error("Failed to wakeup workers");
     }
 
     {
-        std::lock_guard<std::mutex> l(_set_is_blocked);
+        std::lock_guard<Concurrency::Mutex> l(_set_is_blocked);
         for (auto connection : _connections) {
             shutdown(connection->_socket, SHUT_RD);
         }
     }
-    shutdown(_server_socket, SHUT_RDWR);
+    if (_server_socket != -1) {
+        shutdown(_server_socket, SHUT_RDWR);
+    }
 }
 
 // See Server.h
@@ -138,14 +142,17 @@ void ServerImpl::Join() {
     }
     _workers.clear();
     {
-        std::lock_guard<std::mutex> l(_set_is_blocked);
+        std::lock_guard<Concurrency::Mutex> l(_set_is_blocked);
         for (auto connection : _connections) {
             close(connection->_socket);
             delete connection;
         }
         _connections.clear();
     }
-    close(_server_socket);
+    if (_server_socket != -1) {
+        close(_server_socket);
+        _server_socket = -1;
+    }
 }
 
 // See ServerImpl.h
@@ -209,7 +216,7 @@ void ServerImpl::OnRun() {
                 }
 
                 // Register the new FD to be monitored by epoll.
-                Connection *pc = new Connection(infd, pStorage, _logger);
+                Connection *pc = new Connection(infd, pStorage, _logger, _buffer_cache);
                 if (pc == nullptr) {
                     throw std::runtime_error("Failed to allocate connection");
                 }
@@ -225,7 +232,7 @@ void ServerImpl::OnRun() {
                         close(pc->_socket);
                         delete pc;
                     } else {
-                        std::lock_guard<std::mutex> l(_set_is_blocked);
+                        std::lock_guard<Concurrency::Mutex> l(_set_is_blocked);
                         _connections.emplace(pc);
                     }
                 }
@@ -235,7 +242,7 @@ void ServerImpl::OnRun() {
     _logger->warn("Acceptor stopped");
 }
 void ServerImpl::delete_from_set(Connection *connection) {
-    std::lock_guard<std::mutex> l(_set_is_blocked);
+    std::lock_guard<Concurrency::Mutex> l(_set_is_blocked);
     _connections.erase(connection);
     close(connection->_socket);
     delete connection;
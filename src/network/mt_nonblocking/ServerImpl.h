@@ -7,6 +7,7 @@
 #include <mutex>
 
 #include "Connection.h"
+#include <afina/concurrency/Mutex.h>
 #include <afina/network/Server.h>
 
 namespace spdlog {
@@ -22,12 +23,20 @@ class Worker;
 
 /**
  * Network resource manager implementation
- * Epoll based server
+ * Epoll based server, works in one of two modes:
+ * - shared epoll: acceptors register connections in the epoll shared by all workers, any worker could pick
+ *   up the next event of the connection, so connection is rearmed by EPOLLONESHOT after each one
+ * - epoll per worker: each worker has own epoll and own listening socket bound with SO_REUSEPORT, so kernel
+ *   spreads connections between workers. Connection stays in the worker that has accepted it for the whole
+ *   life, no rearm and no shared state between workers
  */
 class ServerImpl : public Server {
     friend class Worker;
 public:
-    ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl);
+    enum class Mode { kSharedEpoll, kReusePort };
+
+    ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl,
+               Mode mode = Mode::kSharedEpoll);
     ~ServerImpl();
 
     // See Server.h
@@ -46,16 +55,23 @@ private:
     // logger to use
     std::shared_ptr<spdlog::logger> _logger;
 
+    // How connections are spread between workers
+    Mode _mode;
+
     // Port to listen for new connections, permits access only from
     // inside of accept_thread
     // Read-only
     uint16_t listen_port;
 
-    // Socket to accept new connection on, shared between acceptors
+    // Socket to accept new connection on, shared between acceptors. Not used if workers listen on their own
     int _server_socket;
 
     std::unordered_set<Connection *> _connections;
-    std::mutex _set_is_blocked;
+    // Guards set of connections, profiled as network.mt_nonblocking.connections
+    Concurrency::Mutex _set_is_blocked;
+
+    // Buffers of the connections, cached by every thread serving them
+    Concurrency::ThreadLocal<BufferCache> _buffer_cache;
 
     // Threads that accepts new connections, each has private epoll instance
     // but share global server socket
@@ -1,12 +1,18 @@
 #ifndef AFINA_NETWORK_MT_NONBLOCKING_UTILS_H
 #define AFINA_NETWORK_MT_NONBLOCKING_UTILS_H
 
+#include <cstdint>
+
 namespace Afina {
 namespace Network {
 namespace MTnonblock {
 
 void make_socket_non_blocking(int sfd);
 
+// Opens non blocking socket listening on the given port of all interfaces. With reuse_port several sockets
+// could listen on the same port, kernel spreads incoming connections between them
+int make_server_socket(uint16_t port, bool reuse_port);
+
 } // namespace MTnonblock
 } // namespace Network
 } // namespace Afina
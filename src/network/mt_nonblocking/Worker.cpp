@@ -1,13 +1,16 @@
 #include "Worker.h"
 
 #include <cassert>
+#include <cstring>
 #include <functional>
 #include <iostream>
+#include <stdexcept>
 
 #include <netdb.h>
 #include <sys/epoll.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <unistd.h>
 
 #include <spdlog/logger.h>
 
@@ -23,7 +26,7 @@ namespace MTnonblock {
 
 // See Worker.h
 Worker::Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Afina::Logging::Service> pl,  ServerImpl *server)
-    : _pStorage(ps), _pLogging(pl), _server(server), isRunning(false), _epoll_fd(-1) {
+    : _pStorage(ps), _pLogging(pl), _server(server), isRunning(false), _epoll_fd(-1), _server_socket(-1) {
     // TODO: implementation here
 }
 
@@ -42,8 +45,12 @@ Worker &Worker::operator=(Worker &&other) {
     _logger = std::move(other._logger);
     _thread = std::move(other._thread);
     _epoll_fd = other._epoll_fd;
+    _server = other._server;
+    _server_socket = other._server_socket;
+    _connections = std::move(other._connections);
 
     other._epoll_fd = -1;
+    other._server_socket = -1;
     return *this;
 }
 
@@ -57,13 +64,60 @@ void Worker::Start(int epoll_fd) {
     }
 }
 
+// See Worker.h
+void Worker::Start(uint16_t port, int event_fd) {
+    if (isRunning.exchange(true)) {
+        return;
+    }
+    assert(_epoll_fd == -1);
+    _logger = _pLogging->select("network.worker");
+
+    // Resources are created here, so that failure gets reported by the server's Start. Worker that failed
+    // has nothing open and could be dropped
+    try {
+        _server_socket = make_server_socket(port, true);
+        _epoll_fd = epoll_create1(0);
+        if (_epoll_fd == -1) {
+            throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
+        }
+
+        struct epoll_event event;
+        event.events = EPOLLIN;
+        event.data.ptr = nullptr;
+        if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, event_fd, &event)) {
+            throw std::runtime_error("Failed to add eventfd descriptor to epoll");
+        }
+
+        event.events = EPOLLIN;
+        event.data.ptr = &_server_socket;
+        if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _server_socket, &event)) {
+            throw std::runtime_error("Failed to add server socket to epoll");
+        }
+
+        _thread = std::thread(&Worker::OnRun, this);
+    } catch (...) {
+        if (_epoll_fd != -1) {
+            close(_epoll_fd);
+            _epoll_fd = -1;
+        }
+        if (_server_socket != -1) {
+            close(_server_socket);
+            _server_socket = -1;
+        }
+        isRunning = false;
+        throw;
+    }
+}
+
 // See Worker.h
 void Worker::Stop() { isRunning = false; }
 
 // See Worker.h
 void Worker::Join() {
-    assert(_thread.joinable());
-    _thread.join();
+    // Worker that failed to start has no thread
+    if (_thread.joinable()) {
+        _thread.join();
+    }
 }
 
 // See Worker.h
@@ -91,6 +145,12 @@ void Worker::OnRun() {
                 continue;
             }
 
+            // New connections on own listening socket
+            if (current_event.data.ptr == &_server_socket) {
+                OnAccept();
+                continue;
+            }
+
             // Some connection gets new data
             auto *pconn = static_cast<Connection *>(current_event.data.ptr);
             if ((current_event.events & EPOLLERR) || (current_event.events & EPOLLHUP)) {
@@ -108,9 +168,21 @@ void Worker::OnRun() {
                 if (current_event.events & EPOLLOUT) {
                     _logger->debug("Got EPOLLOUT");
                     pconn->DoWrite();
+                } else if (pconn->has_output()) {
+                    // Responses of everything read are flushed right away instead of waiting for EPOLLOUT,
+                    // it comes only once socket buffer gets full
+                    pconn->DoWrite();
                 }
             }
 
+            // Own connections stay registered as they are
+            if (_server_socket != -1) {
+                if (!pconn->isAlive()) {
+                    OnClosed(pconn);
+                }
+                continue;
+            }
+
             // Rearm connection
             if (pconn->isAlive()) {
                 _logger->debug("Next worker iteration");
@@ -132,9 +204,55 @@ void Worker::OnRun() {
         }
         // TODO: Select timeout...
     }
+
+    // Own connections and socket are released by the worker itself
+    if (_server_socket != -1) {
+        for (auto pconn : _connections) {
+            close(pconn->_socket);
+            delete pconn;
+        }
+        _connections.clear();
+
+        close(_server_socket);
+        close(_epoll_fd);
+    }
     _logger->warn("Worker stopped");
 }
 
+void Worker::OnAccept() {
+    for (;;) {
+        int infd = accept4(_server_socket, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (infd == -1) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                _logger->error("Failed to accept socket: {}", strerror(errno));
+            }
+            break;
+        }
+        _logger->debug("Accepted connection on descriptor {}", infd);
+
+        // Connection is registered for both directions with edge trigger and never rearmed
+        Connection *pc = new Connection(infd, _pStorage, _logger, _server->_buffer_cache);
+        pc->Start();
+        pc->_event.events = EPOLLIN | EPOLLOUT | EPOLLET;
+        if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, infd, &pc->_event)) {
+            _logger->error("Failed to register connection {}: {}", infd, strerror(errno));
+            close(infd);
+            delete pc;
+            continue;
+        }
+        _connections.insert(pc);
+    }
+}
+
+void Worker::OnClosed(Connection *pconn) {
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, pconn->_socket, nullptr)) {
+        _logger->error("Failed to delete connection {}: {}", pconn->_socket, strerror(errno));
+    }
+    _connections.erase(pconn);
+    close(pconn->_socket);
+    delete pconn;
+}
+
 } // namespace MTnonblock
 } // namespace Network
 } // namespace Afina
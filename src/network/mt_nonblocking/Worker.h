@@ -5,6 +5,7 @@
 #include <atomic>
 #include <memory>
 #include <thread>
+#include <unordered_set>
 
 namespace spdlog {
 class logger;
@@ -41,6 +42,13 @@ public:
      */
     void Start(int epoll_fd);
 
+    /**
+     * Spaws new background thread that owns its epoll and listening socket on the given port, bound
+     * with SO_REUSEPORT. Connections accepted there are served by this thread only, until they are
+     * closed. Thread stops once event_fd gets signaled
+     */
+    void Start(uint16_t port, int event_fd);
+
     /**
      * Signal background thread to stop. After that signal thread must stop to
      * accept new connections and must stop read new commands from existing. Once
@@ -62,6 +70,12 @@ protected:
     void OnRun();
 
 private:
+    // Accepts all pending connections on own listening socket
+    void OnAccept();
+
+    // Drops connection that is not alive anymore
+    void OnClosed(Connection *pconn);
+
     Worker(Worker &) = delete;
     Worker &operator=(Worker &) = delete;
 
@@ -84,6 +98,12 @@ private:
     int _epoll_fd;
 
     ServerImpl *_server;
+
+    // Own listening socket, -1 if connections come from server's acceptors through the shared epoll
+    int _server_socket;
+
+    // Connections of own listening socket, touched by worker thread only
+    std::unordered_set<Connection *> _connections;
 };
 
 } // namespace MTnonblock
@@ -19,9 +19,11 @@
 
 #include <afina/Storage.h>
 #include <afina/execute/Command.h>
+#include <afina/execute/Response.h>
 #include <afina/logging/Service.h>
 
 #include "protocol/Parser.h"
+#include "protocol/ReadBuffer.h"
 
 namespace Afina {
 namespace Network {
@@ -122,13 +124,12 @@ void ServerImpl::Join() {
 void ServerImpl::OnRun() {
     // Here is connection state
     // - parser: parse state of the stream
-    // - command_to_execute: last command parsed out of stream
+    // - command_to_execute: last command parsed out of stream, it lives in the parser
     // - arg_remains: how many bytes to read from stream to get command argument
     // - argument_for_command: buffer stores argument
     std::size_t arg_remains;
-    Protocol::Parser parser;
     std::string argument_for_command;
-    std::unique_ptr<Execute::Command> command_to_execute;
+    Execute::Command *command_to_execute = nullptr;
     while (running.load()) {
         _logger->debug("waiting for connection...");
 
@@ -161,33 +162,34 @@ void ServerImpl::OnRun() {
             setsockopt(client_socket, SOL_SOCKET, SO_RCVTIMEO, (const char *)&tv, sizeof tv);
         }
 
+        // Parser is made for each connection, since it sticks to protocol the connection has started with
+        Protocol::Parser parser;
+
         // Process new connection:
         // - read commands until socket alive
         // - execute each command
         // - send response
         try {
             int readed_bytes = -1;
-            char client_buffer[4096];
-            while ((readed_bytes = read(client_socket, client_buffer, sizeof(client_buffer))) > 0) {
+            Protocol::ReadBuffer input;
+            while ((readed_bytes = input.Read(client_socket)) > 0) {
                 _logger->debug("Got {} bytes from socket", readed_bytes);
 
                 // Single block of data readed from the socket could trigger inside actions a multiple times,
                 // for example:
                 // - read#0: [<command1 start>]
                 // - read#1: [<command1 end> <argument> <command2> <argument for command 2> <command3> ... ]
-                while (readed_bytes > 0) {
-                    _logger->debug("Process {} bytes", readed_bytes);
+                while (!input.Empty()) {
+                    _logger->debug("Process {} bytes", input.Size());
                     // There is no command yet
                     if (!command_to_execute) {
                         std::size_t parsed = 0;
-                        if (parser.Parse(client_buffer, readed_bytes, parsed)) {
+                        if (parser.Parse(input.Data(), input.Size(), parsed)) {
                             // There is no command to be launched, continue to parse input stream
                             // Here we are, current chunk finished some command, process it
                             _logger->debug("Found new command: {} in {} bytes", parser.Name(), parsed);
                             command_to_execute = parser.Build(arg_remains);
-                            if (arg_remains > 0) {
-                                arg_remains += 2;
-                            }
+                            arg_remains += parser.Trailer();
                         }
 
                         // Parsed might fails to consume any bytes from input stream. In real life that could happens,
@@ -195,41 +197,40 @@ void ServerImpl::OnRun() {
                         if (parsed == 0) {
                             break;
                         } else {
-                            std::memmove(client_buffer, client_buffer + parsed, readed_bytes - parsed);
-                            readed_bytes -= parsed;
+                            input.Consume(parsed);
                         }
                     }
 
                     // There is command, but we still wait for argument to arrive...
                     if (command_to_execute && arg_remains > 0) {
-                        _logger->debug("Fill argument: {} bytes of {}", readed_bytes, arg_remains);
-                        // There is some parsed command, and now we are reading argument
-                        std::size_t to_read = std::min(arg_remains, std::size_t(readed_bytes));
-                        argument_for_command.append(client_buffer, to_read);
+                        // Value that fits into the buffer is taken out once it is all there, larger one piece by piece
+                        if (input.Size() < arg_remains && input.Reserve(arg_remains)) {
+                            break;
+                        }
 
-                        std::memmove(client_buffer, client_buffer + to_read, readed_bytes - to_read);
+                        _logger->debug("Fill argument: {} bytes of {}", input.Size(), arg_remains);
+                        std::size_t to_read = std::min(arg_remains, input.Size());
+                        argument_for_command.append(input.Data(), to_read);
+                        input.Consume(to_read);
                         arg_remains -= to_read;
-                        readed_bytes -= to_read;
                     }
 
                     // There is command & argument - RUN!
                     if (command_to_execute && arg_remains == 0) {
                         _logger->debug("Start command execution");
 
-                        std::string result;
-                        if (argument_for_command.size()) {
-                            argument_for_command.resize(argument_for_command.size() - 2);
-                        }
-                        command_to_execute->Execute(*pStorage, argument_for_command, result);
+                        Execute::Response response;
+                        parser.Run(*pStorage, argument_for_command, response);
 
                         // Send response
-                        result += "\r\n";
-                        if (send(client_socket, result.data(), result.size(), 0) <= 0) {
+                        std::string result;
+                        response.AppendTo(result);
+                        if (result.size() && send(client_socket, result.data(), result.size(), 0) <= 0) {
                             throw std::runtime_error("Failed to send response");
                         }
 
                         // Prepare for the next command
-                        command_to_execute.reset();
+                        command_to_execute = nullptr;
                         argument_for_command.resize(0);
                         parser.Reset();
                     }
@@ -249,9 +250,8 @@ void ServerImpl::OnRun() {
         close(client_socket);
 
         // Prepare for the next command: just in case if connection was closed in the middle of executing something
-        command_to_execute.reset();
+        command_to_execute = nullptr;
         argument_for_command.resize(0);
-        parser.Reset();
     }
 
     // Cleanup on exit...
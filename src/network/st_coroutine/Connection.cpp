@@ -1,6 +1,7 @@
 #include "Connection.h"
 
 #include <afina/execute/Command.h>
+#include <afina/execute/Response.h>
 #include <iostream>
 #include <sys/socket.h>
 #include <unistd.h>
@@ -32,33 +33,29 @@ void Connection::OnClose() {
 // See Connection.h
 void Connection::DoReadWrite() {
     _logger->debug("Do read on {} socket", _socket);
-    char _read_buffer[4096] = "";
-    size_t _read_bytes = 0;
+    Protocol::ReadBuffer _input;
     std::size_t _arg_remains = 0;
     Protocol::Parser _parser;
     std::string _argument_for_command;
-    std::unique_ptr<Execute::Command> _command_to_execute;
+    Execute::Command *_command_to_execute = nullptr;
 
     try {
         int read_count = -1;
-        while ((read_count = read(_socket, _read_buffer + _read_bytes, sizeof(_read_buffer) - _read_bytes)) > 0) {
-            _read_bytes += read_count;
+        while ((read_count = _input.Read(_socket)) > 0) {
             _logger->debug("Got {} bytes from socket", read_count);
 
-            while (_read_bytes > 0) {
-                _logger->debug("Process {} bytes", _read_bytes);
+            while (!_input.Empty()) {
+                _logger->debug("Process {} bytes", _input.Size());
                 // There is no command yet
                 if (!_command_to_execute) {
                     std::size_t parsed = 0;
                     try {
-                        if (_parser.Parse(_read_buffer, _read_bytes, parsed)) {
+                        if (_parser.Parse(_input.Data(), _input.Size(), parsed)) {
                             // There is no command to be launched, continue to parse input stream
                             // Here we are, current chunk finished some command, process it
                             _logger->debug("Found new command: {} in {} bytes", _parser.Name(), parsed);
                             _command_to_execute = _parser.Build(_arg_remains);
-                            if (_arg_remains > 0) {
-                                _arg_remains += 2;
-                            }
+                            _arg_remains += _parser.Trailer();
                         }
                     } catch (std::runtime_error &ex) {
                         _event.events |= EPOLLOUT;
@@ -70,32 +67,34 @@ void Connection::DoReadWrite() {
                     if (parsed == 0) {
                         break;
                     } else {
-                        std::memmove(_read_buffer, _read_buffer + parsed, _read_bytes - parsed);
-                        _read_bytes -= parsed;
+                        _input.Consume(parsed);
                     }
                 }
 
                 // There is command, but we still wait for argument to arrive...
                 if (_command_to_execute && _arg_remains > 0) {
-                    _logger->debug("Fill argument: {} bytes of {}", _read_bytes, _arg_remains);
-                    // There is some parsed command, and now we are reading argument
-                    std::size_t to_read = std::min(_arg_remains, std::size_t(_read_bytes));
-                    _argument_for_command.append(_read_buffer, to_read);
+                    // Value that fits into the buffer is taken out once it is all there, larger one piece by piece
+                    if (_input.Size() < _arg_remains && _input.Reserve(_arg_remains)) {
+                        break;
+                    }
 
-                    std::memmove(_read_buffer, _read_buffer + to_read, _read_bytes - to_read);
+                    _logger->debug("Fill argument: {} bytes of {}", _input.Size(), _arg_remains);
+                    std::size_t to_read = std::min(_arg_remains, _input.Size());
+                    _argument_for_command.append(_input.Data(), to_read);
+                    _input.Consume(to_read);
                     _arg_remains -= to_read;
-                    _read_bytes -= to_read;
                 }
 
                 // There is command & argument - RUN!
                 if (_command_to_execute && _arg_remains == 0) {
                     _logger->debug("Start command execution");
 
-                    std::string result;
-                    _command_to_execute->Execute(*_pStorage, _argument_for_command, result);
+                    Execute::Response response;
+                    _parser.Run(*_pStorage, _argument_for_command, response);
 
                     // Send response
-                    result += "\r\n";
+                    std::string result;
+                    response.AppendTo(result);
 
                     _event.events |= EPOLLOUT;
 
@@ -103,12 +102,12 @@ void Connection::DoReadWrite() {
                     _engine->block();
 
                     // the second entry to DoReadWrite() method
-                    if (send(_socket, result.data(), result.size(), 0) <= 0) {
+                    if (result.size() && send(_socket, result.data(), result.size(), 0) <= 0) {
                         throw std::runtime_error("Failed to send response");
                     }
 
                     // Prepare for the next command
-                    _command_to_execute.reset();
+                    _command_to_execute = nullptr;
                     _argument_for_command.resize(0);
                     _parser.Reset();
 
@@ -6,6 +6,7 @@
 #include <afina/Storage.h>
 #include <afina/coroutine/Engine.h>
 #include <protocol/Parser.h>
+#include <protocol/ReadBuffer.h>
 #include <spdlog/logger.h>
 #include <sys/epoll.h>
 
@@ -34,28 +34,25 @@ void Connection::DoRead() {
 
     try {
         int read_count = -1;
-        while ((read_count = read(_socket, _read_buffer + _read_bytes, sizeof(_read_buffer) - _read_bytes)) > 0) {
-            _read_bytes += read_count;
+        while ((read_count = _input.Read(_socket)) > 0) {
             _logger->debug("Got {} bytes from socket", read_count);
 
-            while (_read_bytes > 0) {
-                _logger->debug("Process {} bytes", _read_bytes);
+            while (!_input.Empty()) {
+                _logger->debug("Process {} bytes", _input.Size());
                 // There is no command yet
                 if (!_command_to_execute) {
                     std::size_t parsed = 0;
                     try {
-                        if (_parser.Parse(_read_buffer, _read_bytes, parsed)) {
+                        if (_parser.Parse(_input.Data(), _input.Size(), parsed)) {
                             // There is no command to be launched, continue to parse input stream
                             // Here we are, current chunk finished some command, process it
                             _logger->debug("Found new command: {} in {} bytes", _parser.Name(), parsed);
                             _command_to_execute = _parser.Build(_arg_remains);
-                            if (_arg_remains > 0) {
-                                _arg_remains += 2;
-                            }
+                            _arg_remains += _parser.Trailer();
                         }
                     } catch (std::runtime_error &ex) {
-                        _output_queue.emplace_back("(?^u:ERROR)");
-                        _event.events = EPOLLIN | EPOLLHUP | EPOLLERR | EPOLLOUT;
+                        // Rest of the input can't be trusted, connection goes away once error is sent
+                        _output.Append("CLIENT_ERROR " + std::string(ex.what()) + "\r\n");
                         throw std::runtime_error(ex.what());
                     }
 
@@ -64,97 +61,84 @@ void Connection::DoRead() {
                     if (parsed == 0) {
                         break;
                     } else {
-                        std::memmove(_read_buffer, _read_buffer + parsed, _read_bytes - parsed);
-                        _read_bytes -= parsed;
+                        _input.Consume(parsed);
                     }
                 }
 
                 // There is command, but we still wait for argument to arrive...
                 if (_command_to_execute && _arg_remains > 0) {
-                    _logger->debug("Fill argument: {} bytes of {}", _read_bytes, _arg_remains);
-                    // There is some parsed command, and now we are reading argument
-                    std::size_t to_read = std::min(_arg_remains, std::size_t(_read_bytes));
-                    _argument_for_command.append(_read_buffer, to_read);
+                    // Value that fits into the buffer is taken out once it is all there, larger one piece by piece
+                    if (_input.Size() < _arg_remains && _input.Reserve(_arg_remains)) {
+                        break;
+                    }
 
-                    std::memmove(_read_buffer, _read_buffer + to_read, _read_bytes - to_read);
+                    _logger->debug("Fill argument: {} bytes of {}", _input.Size(), _arg_remains);
+                    std::size_t to_read = std::min(_arg_remains, _input.Size());
+                    _argument_for_command.append(_input.Data(), to_read);
+                    _input.Consume(to_read);
                     _arg_remains -= to_read;
-                    _read_bytes -= to_read;
                 }
 
                 // There is command & argument - RUN!
                 if (_command_to_execute && _arg_remains == 0) {
                     _logger->debug("Start command execution");
 
-                    std::string result;
-                    _command_to_execute->Execute(*_pStorage, _argument_for_command, result);
-
-                    // Send response
-                    result += "\r\n";
-
-                    _output_queue.push_back(result);
-                    if (_output_queue.size() == 1) {
-                        _event.events = EPOLLIN | EPOLLHUP | EPOLLERR | EPOLLOUT;
-                    }
+                    // Response joins the ones of the commands before, all of them go out together
+                    _parser.Run(*_pStorage, _argument_for_command, _output);
 
                     // Prepare for the next command
-                    _command_to_execute.reset();
+                    _command_to_execute = nullptr;
                     _argument_for_command.resize(0);
                     _parser.Reset();
                 }
             }
         } // while (read_count)
-        _end_reading = true;
-        if (_read_bytes == 0) {
+        if (read_count == 0) {
+            // Client has closed its side, connection goes away once responses are sent
             _logger->debug("Connection closed");
-        } else {
+            _end_reading = true;
+        } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
             throw std::runtime_error(std::string(strerror(errno)));
         }
     } catch (std::runtime_error &ex) {
         _logger->error("Failed to process connection on descriptor {}: {}", _socket, ex.what());
         _end_reading = true;
     }
+
+    // Everything read is answered by one write, EPOLLOUT is needed only if socket buffer gets full
+    DoWrite();
 }
 
 // See Connection.h
 void Connection::DoWrite() {
     _logger->debug("Do write on {} socket", _socket);
-    struct iovec tmp[_output_queue.size()];
-    size_t i;
-    for (i = 0; i < _output_queue.size(); ++i) {
-        tmp[i].iov_base = &(_output_queue[i][0]);
-        tmp[i].iov_len = _output_queue[i].size();
-    }
-
-    tmp[0].iov_base = static_cast<char *>(tmp[0].iov_base) + _head_written_count;
-    tmp[0].iov_len -= _head_written_count;
-
-    int written_bytes = writev(_socket, tmp, i);
-
-    if (written_bytes <= 0) {
-        if (errno != EINTR && errno != EAGAIN && errno != EPIPE) {
-            _is_alive = false;
-            throw std::runtime_error("Failed to send response");
-        }
-    }
-
-    i = 0;
-    for (const auto& command : _output_queue) {
-        if (written_bytes - command.size() >= 0) {
-            ++i;
-            written_bytes -= command.size();
-        } else {
+    struct iovec iov[kMaxSegments];
+    while (_output_written < _output.Size()) {
+        size_t count = _output.Fill(iov, kMaxSegments, _output_written);
+        ssize_t written_bytes = writev(_socket, iov, count);
+        if (written_bytes <= 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                _logger->error("Failed to send response on descriptor {}: {}", _socket, strerror(errno));
+                _is_alive = false;
+            }
             break;
         }
+        _output_written += written_bytes;
     }
 
-    _output_queue.erase(_output_queue.begin(), _output_queue.begin() + i);
-    _head_written_count = written_bytes;
+    if (_output_written < _output.Size()) {
+        _event.events = EPOLLIN | EPOLLHUP | EPOLLERR | EPOLLOUT;
+        return;
+    }
 
-    if (_output_queue.empty()) {
-        _event.events = EPOLLIN | EPOLLHUP | EPOLLERR;
-        if (_end_reading) {
-            _is_alive = false;
-        }
+    _output.Clear();
+    _output_written = 0;
+    _event.events = EPOLLIN | EPOLLHUP | EPOLLERR;
+    if (_end_reading) {
+        _is_alive = false;
     }
 }
 
@@ -2,8 +2,10 @@
 #define AFINA_NETWORK_ST_NONBLOCKING_CONNECTION_H
 
 #include <afina/execute/Command.h>
+#include <afina/execute/Response.h>
 #include <cstring>
 #include <protocol/Parser.h>
+#include <protocol/ReadBuffer.h>
 #include <spdlog/logger.h>
 #include <sys/epoll.h>
 #include <vector>
@@ -15,13 +17,13 @@ namespace STnonblock {
 class Connection {
 public:
     Connection(int s, std::shared_ptr<Afina::Storage> &ps, std::shared_ptr<spdlog::logger> &pl)
-        : _socket(s), _pStorage(ps), _logger(pl) {
+        : _socket(s), _logger(pl), _pStorage(ps) {
         std::memset(&_event, 0, sizeof(struct epoll_event));
         _is_alive = true;
         _end_reading = false;
-        _arg_remains = _read_bytes = _head_written_count = 0;
+        _arg_remains = _output_written = 0;
+        _command_to_execute = nullptr;
         _event.data.ptr = this;
-        std::memset(_read_buffer, 0, 4096);
     }
 
     inline bool isAlive() const { return _is_alive; }
@@ -35,6 +37,9 @@ protected:
     void DoWrite();
 
 private:
+    // Maximum number of segments sent by a single writev
+    static const size_t kMaxSegments = 64;
+
     friend class ServerImpl;
 
     bool _is_alive;
@@ -42,17 +47,18 @@ private:
     int _socket;
     struct epoll_event _event;
 
-    std::vector<std::string> _output_queue;
-    char _read_buffer[4096];
-    size_t _read_bytes;
-    int _head_written_count;
+    // Responses of all commands read so far and not sent yet, written by a single writev once the read
+    // buffer is processed
+    Execute::Response _output;
+    size_t _output_written;
+    Protocol::ReadBuffer _input;
     std::shared_ptr<spdlog::logger> _logger;
     std::shared_ptr<Afina::Storage> _pStorage;
 
     std::size_t _arg_remains;
     Protocol::Parser _parser;
     std::string _argument_for_command;
-    std::unique_ptr<Execute::Command> _command_to_execute;
+    Execute::Command *_command_to_execute;
 };
 
 } // namespace STnonblock
@@ -0,0 +1,117 @@
+#include "Connection.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Afina {
+namespace Network {
+namespace Uring {
+
+// See Connection.h
+bool Connection::OnData(const char *data, size_t size) {
+    // Responses to everything received at once make a single batch, batches in flight are not touched
+    _output_queue.emplace_back();
+    bool result = false;
+    try {
+        // Received buffer goes back to the kernel right after, so bytes are copied out
+        _input.Append(data, size);
+        result = process();
+    } catch (std::runtime_error &ex) {
+        _logger->error("Failed to process connection on descriptor {}: {}", _socket, ex.what());
+    }
+    if (_output_queue.back().Empty()) {
+        _output_queue.pop_back();
+    }
+    return result;
+}
+
+// See Connection.h
+bool Connection::process() {
+    while (!_input.Empty()) {
+        _logger->debug("Process {} bytes", _input.Size());
+        // There is no command yet
+        if (!_command_to_execute) {
+            std::size_t parsed = 0;
+            try {
+                if (_parser.Parse(_input.Data(), _input.Size(), parsed)) {
+                    // Here we are, current chunk finished some command, process it
+                    _logger->debug("Found new command: {} in {} bytes", _parser.Name(), parsed);
+                    _command_to_execute = _parser.Build(_arg_remains);
+                    _arg_remains += _parser.Trailer();
+                }
+            } catch (std::runtime_error &ex) {
+                // Rest of the input can't be trusted, connection goes away once error is sent
+                _logger->error("Failed to process connection on descriptor {}: {}", _socket, ex.what());
+                _output_queue.back().Append("CLIENT_ERROR " + std::string(ex.what()) + "\r\n");
+                return false;
+            }
+
+            // Parser might fail to consume any bytes, rest of the command is not there yet
+            if (parsed == 0) {
+                break;
+            } else {
+                _input.Consume(parsed);
+            }
+        }
+
+        // There is command, but we still wait for argument to arrive...
+        if (_command_to_execute && _arg_remains > 0) {
+            // Value that fits into the buffer is taken out once it is all there, larger one piece by piece
+            if (_input.Size() < _arg_remains && _input.Reserve(_arg_remains)) {
+                break;
+            }
+
+            _logger->debug("Fill argument: {} bytes of {}", _input.Size(), _arg_remains);
+            std::size_t to_read = std::min(_arg_remains, _input.Size());
+            _argument_for_command.append(_input.Data(), to_read);
+            _input.Consume(to_read);
+            _arg_remains -= to_read;
+        }
+
+        // There is command & argument - RUN!
+        if (_command_to_execute && _arg_remains == 0) {
+            _logger->debug("Start command execution");
+
+            _parser.Run(*_pStorage, _argument_for_command, _output_queue.back());
+
+            // Prepare for the next command
+            _command_to_execute = nullptr;
+            _argument_for_command.resize(0);
+            _parser.Reset();
+        }
+    }
+    return true;
+}
+
+// See Connection.h
+bool Connection::PrepareSend() {
+    size_t count = 0;
+    size_t offset = _head_written_count;
+    for (auto it = _output_queue.begin(); it != _output_queue.end() && count < kMaxSegments; ++it) {
+        count += it->Fill(_iov + count, kMaxSegments - count, offset);
+        offset = 0;
+    }
+    if (count == 0) {
+        return false;
+    }
+
+    std::memset(&_msg, 0, sizeof(_msg));
+    _msg.msg_iov = _iov;
+    _msg.msg_iovlen = count;
+    return true;
+}
+
+// See Connection.h
+void Connection::OnSent(size_t written_bytes) {
+    // Drop responses sent completely, remember how much of the next one is sent already
+    size_t sent = _head_written_count + written_bytes;
+    while (!_output_queue.empty() && sent >= _output_queue.front().Size()) {
+        sent -= _output_queue.front().Size();
+        _output_queue.pop_front();
+    }
+    _head_written_count = sent;
+}
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
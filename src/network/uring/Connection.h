@@ -0,0 +1,92 @@
+#ifndef AFINA_NETWORK_URING_CONNECTION_H
+#define AFINA_NETWORK_URING_CONNECTION_H
+
+#include <cstring>
+#include <deque>
+#include <memory>
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <afina/execute/Command.h>
+#include <afina/execute/Response.h>
+#include <protocol/Parser.h>
+#include <protocol/ReadBuffer.h>
+#include <spdlog/logger.h>
+
+namespace Afina {
+namespace Network {
+namespace Uring {
+
+/**
+ * # Connection served by io_uring
+ * Has no IO of its own: worker feeds it with received bytes and sends responses it has queued. Keeps
+ * track of the operations in flight, so that worker knows when connection could be released
+ */
+class Connection {
+public:
+    Connection(int s, std::shared_ptr<Afina::Storage> &ps, std::shared_ptr<spdlog::logger> &pl)
+        : _socket(s), _pStorage(ps), _logger(pl), _head_written_count(0), _recv_armed(false),
+          _send_armed(false), _closing(false), _arg_remains(0), _command_to_execute(nullptr) {
+        std::memset(&_msg, 0, sizeof(_msg));
+    }
+
+    /**
+     * Runs commands found in received bytes, their responses are queued for sending. Returns false if
+     * input is broken, connection must be closed once queued responses are sent
+     */
+    bool OnData(const char *data, size_t size);
+
+    /**
+     * Describes queued responses in the message to be sent, returns false if there is nothing to send.
+     * Message and responses must stay untouched until send completes
+     */
+    bool PrepareSend();
+
+    /**
+     * Drops bytes sent by the completed send
+     */
+    void OnSent(size_t written_bytes);
+
+private:
+    friend class Worker;
+
+    // Maximum number of segments sent by a single sendmsg
+    static const size_t kMaxSegments = 64;
+
+    bool process();
+
+    int _socket;
+    std::shared_ptr<Afina::Storage> _pStorage;
+    std::shared_ptr<spdlog::logger> _logger;
+
+    // Start of the next command, that didn't arrive completely yet
+    Protocol::ReadBuffer _input;
+
+    // Batches of responses waiting to be sent, values in them reference storage memory
+    std::deque<Execute::Response> _output_queue;
+    size_t _head_written_count;
+
+    // Message of the send in flight
+    struct msghdr _msg;
+    struct iovec _iov[kMaxSegments];
+
+    // Operations in flight
+    bool _recv_armed;
+    bool _send_armed;
+
+    // No more commands are going to be read, connection is closed once output is sent
+    bool _closing;
+
+    // variables for parser
+    std::size_t _arg_remains;
+    Protocol::Parser _parser;
+    std::string _argument_for_command;
+    Execute::Command *_command_to_execute;
+};
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_URING_CONNECTION_H
@@ -0,0 +1,219 @@
+#include "Ring.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace Afina {
+namespace Network {
+namespace Uring {
+
+#ifndef AFINA_HAVE_IO_URING
+
+// See Ring.h
+bool Supported() { return false; }
+
+#else
+
+namespace {
+
+template <typename T> T *at(void *base, size_t offset) {
+    return reinterpret_cast<T *>(static_cast<char *>(base) + offset);
+}
+
+std::string error_text(const std::string &what) { return what + ": " + std::string(strerror(errno)); }
+
+} // namespace
+
+// See Ring.h
+bool Supported() {
+    try {
+        Ring ring(4);
+        BufferRing buffers(ring, 0, 2, 64);
+        return true;
+    } catch (std::runtime_error &) {
+        return false;
+    }
+}
+
+// See Ring.h
+Ring::Ring(unsigned entries) : _sq_ptr(MAP_FAILED), _cq_ptr(MAP_FAILED), _sqes(nullptr) {
+    struct io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    _ring_fd = syscall(__NR_io_uring_setup, entries, &params);
+    if (_ring_fd < 0) {
+        throw std::runtime_error(error_text("Failed to setup io_uring"));
+    }
+
+    // Both queues could live in the single mapping
+    _sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    _cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        _sq_size = _cq_size = std::max(_sq_size, _cq_size);
+    }
+
+    _sq_ptr = mmap(nullptr, _sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring_fd,
+                   IORING_OFF_SQ_RING);
+    if (_sq_ptr == MAP_FAILED) {
+        close(_ring_fd);
+        throw std::runtime_error(error_text("Failed to map submission queue"));
+    }
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        _cq_ptr = _sq_ptr;
+    } else {
+        _cq_ptr = mmap(nullptr, _cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring_fd,
+                       IORING_OFF_CQ_RING);
+        if (_cq_ptr == MAP_FAILED) {
+            munmap(_sq_ptr, _sq_size);
+            close(_ring_fd);
+            throw std::runtime_error(error_text("Failed to map completion queue"));
+        }
+    }
+
+    _sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    void *sqes = mmap(nullptr, _sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring_fd,
+                      IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        if (_cq_ptr != _sq_ptr) {
+            munmap(_cq_ptr, _cq_size);
+        }
+        munmap(_sq_ptr, _sq_size);
+        close(_ring_fd);
+        throw std::runtime_error(error_text("Failed to map submission entries"));
+    }
+    _sqes = static_cast<struct io_uring_sqe *>(sqes);
+
+    _sq_head = at<unsigned>(_sq_ptr, params.sq_off.head);
+    _sq_tail_shared = at<unsigned>(_sq_ptr, params.sq_off.tail);
+    _sq_array = at<unsigned>(_sq_ptr, params.sq_off.array);
+    _sq_mask = *at<unsigned>(_sq_ptr, params.sq_off.ring_mask);
+    _sq_entries = *at<unsigned>(_sq_ptr, params.sq_off.ring_entries);
+    _sq_tail = *_sq_tail_shared;
+
+    _cq_head = at<unsigned>(_cq_ptr, params.cq_off.head);
+    _cq_tail = at<unsigned>(_cq_ptr, params.cq_off.tail);
+    _cq_mask = *at<unsigned>(_cq_ptr, params.cq_off.ring_mask);
+    _cqes = at<struct io_uring_cqe>(_cq_ptr, params.cq_off.cqes);
+}
+
+// See Ring.h
+Ring::~Ring() {
+    munmap(_sqes, _sqes_size);
+    if (_cq_ptr != _sq_ptr) {
+        munmap(_cq_ptr, _cq_size);
+    }
+    munmap(_sq_ptr, _sq_size);
+    close(_ring_fd);
+}
+
+// See Ring.h
+struct io_uring_sqe *Ring::GetSqe() {
+    if (_sq_tail - __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE) >= _sq_entries) {
+        Submit(0);
+        if (_sq_tail - __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE) >= _sq_entries) {
+            throw std::runtime_error("Submission queue is full");
+        }
+    }
+
+    unsigned index = _sq_tail & _sq_mask;
+    struct io_uring_sqe *sqe = &_sqes[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    _sq_array[index] = index;
+    _sq_tail++;
+    return sqe;
+}
+
+// See Ring.h
+void Ring::Submit(unsigned wait_nr) {
+    __atomic_store_n(_sq_tail_shared, _sq_tail, __ATOMIC_RELEASE);
+    unsigned to_submit = _sq_tail - __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE);
+
+    unsigned flags = wait_nr > 0 ? IORING_ENTER_GETEVENTS : 0;
+    if (syscall(__NR_io_uring_enter, _ring_fd, to_submit, wait_nr, flags, nullptr, 0) < 0) {
+        // Interrupted wait or completion queue overflow, either way caller reaps what is there and comes back
+        if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+            throw std::runtime_error(error_text("Failed to submit io_uring entries"));
+        }
+    }
+}
+
+// See Ring.h
+struct io_uring_cqe *Ring::PeekCqe() {
+    unsigned head = *_cq_head;
+    if (head == __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE)) {
+        return nullptr;
+    }
+    return &_cqes[head & _cq_mask];
+}
+
+// See Ring.h
+void Ring::Seen() { __atomic_store_n(_cq_head, *_cq_head + 1, __ATOMIC_RELEASE); }
+
+// See Ring.h
+BufferRing::BufferRing(Ring &ring, uint16_t group, unsigned count, size_t size)
+    : _ring(ring), _group(group), _count(count), _size(size), _tail(0) {
+    if (count == 0 || (count & (count - 1)) != 0) {
+        throw std::invalid_argument("Number of provided buffers must be a power of two");
+    }
+
+    // Kernel wants ring of buffer descriptors to be page aligned
+    _buffers_size = count * sizeof(struct io_uring_buf);
+    void *buffers = mmap(nullptr, _buffers_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buffers == MAP_FAILED) {
+        throw std::runtime_error(error_text("Failed to map buffer ring"));
+    }
+    _buffers = static_cast<struct io_uring_buf_ring *>(buffers);
+
+    struct io_uring_buf_reg reg;
+    std::memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = reinterpret_cast<uint64_t>(_buffers);
+    reg.ring_entries = count;
+    reg.bgid = group;
+    if (syscall(__NR_io_uring_register, _ring.fd(), IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        munmap(_buffers, _buffers_size);
+        throw std::runtime_error(error_text("Failed to register buffer ring"));
+    }
+
+    _memory = new char[count * size];
+    for (unsigned i = 0; i < count; i++) {
+        Recycle(i);
+    }
+}
+
+// See Ring.h
+BufferRing::~BufferRing() {
+    struct io_uring_buf_reg reg;
+    std::memset(&reg, 0, sizeof(reg));
+    reg.bgid = _group;
+    syscall(__NR_io_uring_register, _ring.fd(), IORING_UNREGISTER_PBUF_RING, &reg, 1);
+
+    munmap(_buffers, _buffers_size);
+    delete[] _memory;
+}
+
+// See Ring.h
+void BufferRing::Recycle(uint16_t id) {
+    // Descriptors start right at the ring, tail overlaps the first one. Flexible array member of the kernel
+    // header is shifted by C++, so it can't be used
+    struct io_uring_buf *descriptors = reinterpret_cast<struct io_uring_buf *>(_buffers);
+    struct io_uring_buf &buffer = descriptors[_tail & (_count - 1)];
+    buffer.addr = reinterpret_cast<uint64_t>(_memory + size_t(id) * _size);
+    buffer.len = _size;
+    buffer.bid = id;
+
+    _tail++;
+    __atomic_store_n(&_buffers->tail, _tail, __ATOMIC_RELEASE);
+}
+
+#endif // AFINA_HAVE_IO_URING
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
@@ -0,0 +1,117 @@
+#ifndef AFINA_NETWORK_URING_RING_H
+#define AFINA_NETWORK_URING_RING_H
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef AFINA_HAVE_IO_URING
+#include <linux/io_uring.h>
+#endif
+
+namespace Afina {
+namespace Network {
+namespace Uring {
+
+/**
+ * Checks that kernel provides io_uring with everything engine relies on: ring could be created and
+ * buffer ring for recv could be registered. False if build has no io_uring headers at all
+ */
+bool Supported();
+
+#ifdef AFINA_HAVE_IO_URING
+
+/**
+ * # Submission and completion queues of io_uring
+ * Thin wrapper over raw syscalls, there is no liburing in the build. Queues are mapped once on
+ * construction and unmapped together with the ring descriptor on destruction.
+ *
+ * That is NOT thread safe, ring belongs to a single thread
+ */
+class Ring {
+public:
+    explicit Ring(unsigned entries);
+    ~Ring();
+
+    Ring(const Ring &) = delete;
+    Ring &operator=(const Ring &) = delete;
+
+    int fd() const { return _ring_fd; }
+
+    /**
+     * Returns zeroed entry to fill in, submits queued entries first if there is no free one
+     */
+    struct io_uring_sqe *GetSqe();
+
+    /**
+     * Submits queued entries and waits until at least wait_nr completions are there
+     */
+    void Submit(unsigned wait_nr);
+
+    /**
+     * Returns next completion or nullptr if there is none. Completion stays in the queue until Seen
+     */
+    struct io_uring_cqe *PeekCqe();
+    void Seen();
+
+private:
+    int _ring_fd;
+
+    // Mapped areas of the queues and array of submission entries
+    void *_sq_ptr;
+    size_t _sq_size;
+    void *_cq_ptr;
+    size_t _cq_size;
+    struct io_uring_sqe *_sqes;
+    size_t _sqes_size;
+
+    // Submission queue, _sq_tail is local copy published on Submit
+    unsigned *_sq_head;
+    unsigned *_sq_tail_shared;
+    unsigned *_sq_array;
+    unsigned _sq_mask;
+    unsigned _sq_entries;
+    unsigned _sq_tail;
+
+    // Completion queue
+    unsigned *_cq_head;
+    unsigned *_cq_tail;
+    unsigned _cq_mask;
+    struct io_uring_cqe *_cqes;
+};
+
+/**
+ * # Provided buffers for recv
+ * Ring of equal buffers registered in the kernel under the group id. Kernel picks a buffer when data
+ * arrives, so idle connections hold no memory. Buffer is given back by Recycle once data is consumed
+ */
+class BufferRing {
+public:
+    BufferRing(Ring &ring, uint16_t group, unsigned count, size_t size);
+    ~BufferRing();
+
+    BufferRing(const BufferRing &) = delete;
+    BufferRing &operator=(const BufferRing &) = delete;
+
+    uint16_t group() const { return _group; }
+    const char *Buffer(uint16_t id) const { return _memory + size_t(id) * _size; }
+    void Recycle(uint16_t id);
+
+private:
+    Ring &_ring;
+    uint16_t _group;
+    unsigned _count;
+    size_t _size;
+
+    struct io_uring_buf_ring *_buffers;
+    size_t _buffers_size;
+    char *_memory;
+    uint16_t _tail;
+};
+
+#endif // AFINA_HAVE_IO_URING
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_URING_RING_H
@@ -0,0 +1,107 @@
+#include "ServerImpl.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#include <pthread.h>
+#include <signal.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <spdlog/logger.h>
+
+#include <afina/Storage.h>
+#include <afina/logging/Service.h>
+
+#include "../mt_nonblocking/ServerImpl.h"
+#include "../st_nonblocking/ServerImpl.h"
+#include "Ring.h"
+#include "Worker.h"
+
+namespace Afina {
+namespace Network {
+namespace Uring {
+
+// See Server.h
+ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl, bool single_thread)
+    : Server(ps, pl), _single_thread(single_thread), _event_fd(-1) {}
+
+// See Server.h
+ServerImpl::~ServerImpl() {
+    ServerImpl::Stop();
+    ServerImpl::Join();
+}
+
+// See Server.h
+void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers) {
+    _logger = pLogging->select("network");
+    if (!Supported()) {
+        _logger->warn("io_uring is not available, fall back to epoll");
+        if (_single_thread) {
+            _fallback.reset(new STnonblock::ServerImpl(pStorage, pLogging));
+        } else {
+            _fallback.reset(new MTnonblock::ServerImpl(pStorage, pLogging, MTnonblock::ServerImpl::Mode::kReusePort));
+        }
+        _fallback->Start(port, n_acceptors, n_workers);
+        return;
+    }
+    _logger->info("Start io_uring network service");
+
+    sigset_t sig_mask;
+    sigemptyset(&sig_mask);
+    sigaddset(&sig_mask, SIGPIPE);
+    if (pthread_sigmask(SIG_BLOCK, &sig_mask, NULL) != 0) {
+        throw std::runtime_error("Unable to mask SIGPIPE");
+    }
+
+    _event_fd = eventfd(0, EFD_NONBLOCK);
+    if (_event_fd == -1) {
+        throw std::runtime_error("Failed to create event file descriptor: " + std::string(strerror(errno)));
+    }
+
+    if (_single_thread || n_workers == 0) {
+        n_workers = 1;
+    }
+    _workers.reserve(n_workers);
+    for (uint32_t i = 0; i < n_workers; i++) {
+        _workers.emplace_back(new Worker(pStorage, pLogging));
+        _workers.back()->Start(port, _event_fd);
+    }
+}
+
+// See Server.h
+void ServerImpl::Stop() {
+    if (_fallback) {
+        _fallback->Stop();
+        return;
+    }
+    if (_event_fd == -1) {
+        return;
+    }
+
+    _logger->warn("Stop network service");
+    if (eventfd_write(_event_fd, 1)) {
+        throw std::runtime_error("Failed to wakeup workers");
+    }
+}
+
+// See Server.h
+void ServerImpl::Join() {
+    if (_fallback) {
+        _fallback->Join();
+        return;
+    }
+
+    for (auto &w : _workers) {
+        w->Join();
+    }
+    _workers.clear();
+    if (_event_fd != -1) {
+        close(_event_fd);
+        _event_fd = -1;
+    }
+}
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
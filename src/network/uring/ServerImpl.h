@@ -0,0 +1,64 @@
+#ifndef AFINA_NETWORK_URING_SERVER_H
+#define AFINA_NETWORK_URING_SERVER_H
+
+#include <memory>
+#include <vector>
+
+#include <afina/network/Server.h>
+
+namespace spdlog {
+class logger;
+}
+
+namespace Afina {
+namespace Network {
+namespace Uring {
+
+// Forward declaration, see Worker.h
+class Worker;
+
+/**
+ * Network resource manager implementation
+ * io_uring based server, each worker owns a ring and a listening socket bound with SO_REUSEPORT. Accept
+ * and recv are multishot and take buffers from the ring provided to kernel, responses go out by sendmsg
+ * right from the storage memory.
+ *
+ * If kernel can't run io_uring the way workers need, server falls back to epoll: single threaded one
+ * or epoll per worker one
+ */
+class ServerImpl : public Server {
+public:
+    ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl, bool single_thread = false);
+    ~ServerImpl();
+
+    // See Server.h
+    void Start(uint16_t port, uint32_t acceptors, uint32_t workers) override;
+
+    // See Server.h
+    void Stop() override;
+
+    // See Server.h
+    void Join() override;
+
+private:
+    // logger to use
+    std::shared_ptr<spdlog::logger> _logger;
+
+    // Serve all connections on the calling thread's worker only
+    bool _single_thread;
+
+    // Curstom event "device" used to wakeup workers
+    int _event_fd;
+
+    // threads serving connections
+    std::vector<std::unique_ptr<Worker>> _workers;
+
+    // epoll based server used instead if io_uring is not there
+    std::unique_ptr<Server> _fallback;
+};
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_URING_SERVER_H
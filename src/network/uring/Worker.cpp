@@ -0,0 +1,310 @@
+#include "Worker.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <spdlog/logger.h>
+
+#include <afina/logging/Service.h>
+
+#include "../mt_nonblocking/Utils.h"
+#include "Connection.h"
+
+namespace Afina {
+namespace Network {
+namespace Uring {
+
+namespace {
+
+// Completions of the worker's own operations, connections are told apart by their address. Nobody waits
+// for completions of cancels
+const uint64_t kIgnoredData = 0;
+const uint64_t kAcceptData = 1;
+const uint64_t kStopData = 2;
+
+// Set in the address of connection for send completions
+const uint64_t kSendTag = 1;
+
+const unsigned kRingEntries = 256;
+const unsigned kBuffersCount = 256;
+const size_t kBufferSize = 4096;
+
+} // namespace
+
+// See Worker.h
+Worker::Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Afina::Logging::Service> pl)
+    : _pStorage(ps), _pLogging(pl), _server_socket(-1), _event_fd(-1), _multishot_accept(true),
+      _multishot_recv(true), _accept_armed(false), _stopping(false) {}
+
+// See Worker.h
+Worker::~Worker() {
+    Join();
+    if (_server_socket != -1) {
+        close(_server_socket);
+    }
+}
+
+// See Worker.h
+void Worker::Join() {
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+#ifndef AFINA_HAVE_IO_URING
+
+// See Worker.h
+void Worker::Start(uint16_t port, int event_fd) {
+    throw std::runtime_error("Build has no io_uring support");
+}
+
+// See Worker.h
+void Worker::OnRun() {}
+
+#else
+
+// See Worker.h
+void Worker::Start(uint16_t port, int event_fd) {
+    _logger = _pLogging->select("network");
+    _ring.reset(new Ring(kRingEntries));
+    _buffers.reset(new BufferRing(*_ring, 0, kBuffersCount, kBufferSize));
+    _server_socket = MTnonblock::make_server_socket(port, true);
+    _event_fd = event_fd;
+    _thread = std::thread(&Worker::OnRun, this);
+}
+
+// See Worker.h
+void Worker::OnRun() {
+    _logger->info("Start io_uring worker on {} socket", _server_socket);
+    try {
+        arm_accept();
+        arm_stop();
+        while (!_stopping || _accept_armed || !_connections.empty()) {
+            _ring->Submit(1);
+
+            // Completion is copied out, so that handlers are free to queue new operations
+            struct io_uring_cqe *pcqe;
+            while ((pcqe = _ring->PeekCqe()) != nullptr) {
+                struct io_uring_cqe cqe = *pcqe;
+                _ring->Seen();
+
+                if (cqe.user_data == kAcceptData) {
+                    on_accept(&cqe);
+                } else if (cqe.user_data == kStopData) {
+                    on_stop();
+                } else if (cqe.user_data != kIgnoredData) {
+                    Connection *pconn = reinterpret_cast<Connection *>(cqe.user_data & ~kSendTag);
+                    if (cqe.user_data & kSendTag) {
+                        on_send(pconn, &cqe);
+                    } else {
+                        on_recv(pconn, &cqe);
+                    }
+                }
+            }
+        }
+    } catch (std::runtime_error &ex) {
+        _logger->error("io_uring worker failed: {}", ex.what());
+    }
+
+    for (Connection *pconn : _connections) {
+        close(pconn->_socket);
+        delete pconn;
+    }
+    _connections.clear();
+    _logger->info("io_uring worker on {} socket stopped", _server_socket);
+}
+
+// See Worker.h
+void Worker::arm_accept() {
+    struct io_uring_sqe *sqe = _ring->GetSqe();
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = _server_socket;
+    sqe->accept_flags = SOCK_CLOEXEC;
+    sqe->ioprio = _multishot_accept ? IORING_ACCEPT_MULTISHOT : 0;
+    sqe->user_data = kAcceptData;
+    _accept_armed = true;
+}
+
+// See Worker.h
+void Worker::arm_recv(Connection *pconn) {
+    struct io_uring_sqe *sqe = _ring->GetSqe();
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = pconn->_socket;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = _buffers->group();
+    sqe->ioprio = _multishot_recv ? IORING_RECV_MULTISHOT : 0;
+    sqe->user_data = reinterpret_cast<uint64_t>(pconn);
+    pconn->_recv_armed = true;
+}
+
+// See Worker.h
+void Worker::arm_send(Connection *pconn) {
+    struct io_uring_sqe *sqe = _ring->GetSqe();
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = pconn->_socket;
+    sqe->addr = reinterpret_cast<uint64_t>(&pconn->_msg);
+    sqe->len = 1;
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = reinterpret_cast<uint64_t>(pconn) | kSendTag;
+    pconn->_send_armed = true;
+}
+
+// See Worker.h
+void Worker::arm_stop() {
+    struct io_uring_sqe *sqe = _ring->GetSqe();
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = _event_fd;
+    sqe->poll32_events = POLLIN;
+    sqe->user_data = kStopData;
+}
+
+// See Worker.h
+void Worker::cancel(uint64_t user_data) {
+    struct io_uring_sqe *sqe = _ring->GetSqe();
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = user_data;
+    sqe->user_data = kIgnoredData;
+}
+
+// See Worker.h
+void Worker::on_accept(const struct io_uring_cqe *cqe) {
+    if (cqe->res >= 0) {
+        if (_stopping) {
+            close(cqe->res);
+        } else {
+            Connection *pconn = new Connection(cqe->res, _pStorage, _logger);
+            _connections.insert(pconn);
+            _logger->debug("Connection on {} socket started", pconn->_socket);
+            arm_recv(pconn);
+        }
+    }
+
+    if (cqe->flags & IORING_CQE_F_MORE) {
+        return;
+    }
+    _accept_armed = false;
+
+    bool rearm = !_stopping;
+    if (cqe->res == -EINVAL && _multishot_accept) {
+        _logger->warn("Multishot accept is not supported, accept connections one by one");
+        _multishot_accept = false;
+    } else if (cqe->res < 0 && cqe->res != -ECANCELED) {
+        _logger->error("Failed to accept on descriptor {}: {}", _server_socket, strerror(-cqe->res));
+        rearm = rearm && cqe->res != -EINVAL && cqe->res != -EBADF;
+    }
+    if (rearm) {
+        arm_accept();
+    }
+}
+
+// See Worker.h
+void Worker::on_recv(Connection *pconn, const struct io_uring_cqe *cqe) {
+    bool more = (cqe->flags & IORING_CQE_F_MORE) != 0;
+    if (!more) {
+        pconn->_recv_armed = false;
+    }
+
+    if (cqe->res > 0) {
+        uint16_t id = cqe->flags >> IORING_CQE_BUFFER_SHIFT;
+        // Data already queued by multishot recv is dropped once connection is closing
+        if (!pconn->_closing && !pconn->OnData(_buffers->Buffer(id), cqe->res)) {
+            pconn->_closing = true;
+            if (more) {
+                cancel(cqe->user_data);
+            }
+        }
+        _buffers->Recycle(id);
+
+        if (!more && !pconn->_closing) {
+            arm_recv(pconn);
+        }
+    } else if (cqe->res == 0 || cqe->res == -ECANCELED) {
+        // Client has closed its side, connection goes away once responses are sent
+        _logger->debug("Connection on {} socket closed", pconn->_socket);
+        pconn->_closing = true;
+    } else if (cqe->res == -ENOBUFS) {
+        // All buffers are taken, they are back already since data is consumed right away
+        if (!pconn->_closing) {
+            arm_recv(pconn);
+        }
+    } else if (cqe->res == -EINVAL && _multishot_recv) {
+        _logger->warn("Multishot recv is not supported, arm recv after each completion");
+        _multishot_recv = false;
+        if (!pconn->_closing) {
+            arm_recv(pconn);
+        }
+    } else {
+        _logger->error("Failed to receive on descriptor {}: {}", pconn->_socket, strerror(-cqe->res));
+        pconn->_closing = true;
+    }
+
+    progress(pconn);
+}
+
+// See Worker.h
+void Worker::on_send(Connection *pconn, const struct io_uring_cqe *cqe) {
+    pconn->_send_armed = false;
+    if (cqe->res >= 0) {
+        pconn->OnSent(cqe->res);
+    } else if (cqe->res != -EINTR && cqe->res != -EAGAIN) {
+        _logger->error("Failed to send response on descriptor {}: {}", pconn->_socket, strerror(-cqe->res));
+        pconn->_output_queue.clear();
+        pconn->_head_written_count = 0;
+        if (!pconn->_closing) {
+            pconn->_closing = true;
+            if (pconn->_recv_armed) {
+                cancel(reinterpret_cast<uint64_t>(pconn));
+            }
+        }
+    }
+
+    progress(pconn);
+}
+
+// See Worker.h
+void Worker::on_stop() {
+    _logger->debug("Stop io_uring worker on {} socket", _server_socket);
+    _stopping = true;
+    if (_accept_armed) {
+        cancel(kAcceptData);
+    }
+
+    // Commands already read are executed, connections go away once their responses are sent
+    std::vector<Connection *> connections(_connections.begin(), _connections.end());
+    for (Connection *pconn : connections) {
+        if (!pconn->_closing) {
+            pconn->_closing = true;
+            if (pconn->_recv_armed) {
+                cancel(reinterpret_cast<uint64_t>(pconn));
+            }
+        }
+        progress(pconn);
+    }
+}
+
+// See Worker.h
+void Worker::progress(Connection *pconn) {
+    if (!pconn->_send_armed && pconn->PrepareSend()) {
+        arm_send(pconn);
+    }
+
+    if (pconn->_closing && !pconn->_recv_armed && !pconn->_send_armed) {
+        _logger->debug("Release connection on {} socket", pconn->_socket);
+        close(pconn->_socket);
+        _connections.erase(pconn);
+        delete pconn;
+    }
+}
+
+#endif // AFINA_HAVE_IO_URING
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
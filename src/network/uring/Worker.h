@@ -0,0 +1,117 @@
+#ifndef AFINA_NETWORK_URING_WORKER_H
+#define AFINA_NETWORK_URING_WORKER_H
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <unordered_set>
+
+#include "Ring.h"
+
+namespace spdlog {
+class logger;
+}
+
+namespace Afina {
+
+// Forward declaration, see afina/Storage.h
+class Storage;
+namespace Logging {
+class Service;
+}
+
+namespace Network {
+namespace Uring {
+
+// Forward declaration, see Connection.h
+class Connection;
+
+/**
+ * # Thread running io_uring
+ * Owns the ring, listening socket bound with SO_REUSEPORT and buffers for recv. Accept and recv are
+ * multishot: armed once they keep producing completions, so the loop only submits sends and reaps
+ * completions, one syscall per batch. Thread stops once event_fd gets signaled
+ */
+class Worker {
+public:
+    Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Afina::Logging::Service> pl);
+    ~Worker();
+
+    /**
+     * Sets up ring, listening socket and buffers, then spawns background thread serving them. Throws if
+     * any of them can't be set up
+     */
+    void Start(uint16_t port, int event_fd);
+
+    /**
+     * Blocks calling thread until background one for this worker is actually
+     * been destoryed
+     */
+    void Join();
+
+protected:
+    /**
+     * Method executing by background thread
+     */
+    void OnRun();
+
+private:
+#ifdef AFINA_HAVE_IO_URING
+    void arm_accept();
+    void arm_recv(Connection *pconn);
+    void arm_send(Connection *pconn);
+    void arm_stop();
+    void cancel(uint64_t user_data);
+
+    void on_accept(const struct io_uring_cqe *cqe);
+    void on_recv(Connection *pconn, const struct io_uring_cqe *cqe);
+    void on_send(Connection *pconn, const struct io_uring_cqe *cqe);
+    void on_stop();
+
+    // Starts send if there is output and none is in flight, releases connection once it is done
+    void progress(Connection *pconn);
+
+    // Ring and buffers for recv, created by Start
+    std::unique_ptr<Ring> _ring;
+    std::unique_ptr<BufferRing> _buffers;
+#endif
+
+    Worker(Worker &) = delete;
+    Worker &operator=(Worker &) = delete;
+
+    // afina services
+    std::shared_ptr<Afina::Storage> _pStorage;
+
+    // afina services
+    std::shared_ptr<Afina::Logging::Service> _pLogging;
+
+    // Logger to be used
+    std::shared_ptr<spdlog::logger> _logger;
+
+    // Thread serving requests in this worker
+    std::thread _thread;
+
+    // Own listening socket
+    int _server_socket;
+
+    // Server's descriptor signaled on stop
+    int _event_fd;
+
+    // Kernel might lack multishot operations, then they are armed again after each completion
+    bool _multishot_accept;
+    bool _multishot_recv;
+
+    // Accept is waiting for connections
+    bool _accept_armed;
+
+    // Stop is signaled, worker waits until connections are done
+    bool _stopping;
+
+    // Connections of own listening socket, touched by worker thread only
+    std::unordered_set<Connection *> _connections;
+};
+
+} // namespace Uring
+} // namespace Network
+} // namespace Afina
+#endif // AFINA_NETWORK_URING_WORKER_H
@@ -0,0 +1,380 @@
+#include "BinaryParser.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include <afina/execute/Add.h>
+#include <afina/execute/Append.h>
+#include <afina/execute/Cas.h>
+#include <afina/execute/Command.h>
+#include <afina/execute/Decr.h>
+#include <afina/execute/Delete.h>
+#include <afina/execute/Gat.h>
+#include <afina/execute/Get.h>
+#include <afina/execute/Incr.h>
+#include <afina/execute/Prepend.h>
+#include <afina/execute/Replace.h>
+#include <afina/execute/Response.h>
+#include <afina/execute/Set.h>
+#include <afina/execute/Touch.h>
+
+#include "CommandSpace.h"
+
+namespace Afina {
+namespace Protocol {
+
+/**
+ * What request does, several opcodes could share it
+ */
+enum class OpcodeKind : uint8_t { Get, Gat, Set, Add, Replace, Append, Prepend, Delete, Incr, Decr, Touch, Noop };
+
+/**
+ * # Entry of the opcode table
+ */
+struct OpcodeSpec {
+    uint8_t code;
+    const char *name;
+    OpcodeKind kind;
+
+    // Size of extras request must have
+    uint8_t extras;
+
+    // Response is sent only if request fails, or misses for the retrievals
+    bool quiet;
+
+    // Response of retrieval carries the key
+    bool with_key;
+};
+
+namespace {
+
+// Response status codes
+const uint16_t kSuccess = 0x0000;
+const uint16_t kKeyNotFound = 0x0001;
+const uint16_t kKeyExists = 0x0002;
+const uint16_t kInvalidArguments = 0x0004;
+const uint16_t kItemNotStored = 0x0005;
+const uint16_t kNonNumeric = 0x0006;
+const uint16_t kUnknownCommand = 0x0081;
+
+// Opcodes server knows
+const OpcodeSpec kOpcodes[] = {
+    {0x00, "get", OpcodeKind::Get, 0, false, false},        {0x09, "getq", OpcodeKind::Get, 0, true, false},
+    {0x0c, "getk", OpcodeKind::Get, 0, false, true},        {0x0d, "getkq", OpcodeKind::Get, 0, true, true},
+    {0x1d, "gat", OpcodeKind::Gat, 4, false, false},        {0x1e, "gatq", OpcodeKind::Gat, 4, true, false},
+    {0x23, "gatk", OpcodeKind::Gat, 4, false, true},        {0x24, "gatkq", OpcodeKind::Gat, 4, true, true},
+    {0x01, "set", OpcodeKind::Set, 8, false, false},        {0x11, "setq", OpcodeKind::Set, 8, true, false},
+    {0x02, "add", OpcodeKind::Add, 8, false, false},        {0x12, "addq", OpcodeKind::Add, 8, true, false},
+    {0x03, "replace", OpcodeKind::Replace, 8, false, false}, {0x13, "replaceq", OpcodeKind::Replace, 8, true, false},
+    {0x0e, "append", OpcodeKind::Append, 0, false, false},  {0x19, "appendq", OpcodeKind::Append, 0, true, false},
+    {0x0f, "prepend", OpcodeKind::Prepend, 0, false, false}, {0x1a, "prependq", OpcodeKind::Prepend, 0, true, false},
+    {0x04, "delete", OpcodeKind::Delete, 0, false, false},  {0x14, "deleteq", OpcodeKind::Delete, 0, true, false},
+    {0x05, "incr", OpcodeKind::Incr, 20, false, false},     {0x15, "incrq", OpcodeKind::Incr, 20, true, false},
+    {0x06, "decr", OpcodeKind::Decr, 20, false, false},     {0x16, "decrq", OpcodeKind::Decr, 20, true, false},
+    {0x1c, "touch", OpcodeKind::Touch, 4, false, false},    {0x0a, "noop", OpcodeKind::Noop, 0, false, false},
+};
+
+// Entry of the opcode, nullptr if opcode is unknown
+const OpcodeSpec *find_opcode(uint8_t code) {
+    static const std::array<const OpcodeSpec *, 256> index = [] {
+        std::array<const OpcodeSpec *, 256> result;
+        result.fill(nullptr);
+        for (const OpcodeSpec &spec : kOpcodes) {
+            result[spec.code] = &spec;
+        }
+        return result;
+    }();
+    return index[code];
+}
+
+// Numbers are in network byte order
+uint64_t load(const char *data, size_t size) {
+    uint64_t result = 0;
+    for (size_t i = 0; i < size; i++) {
+        result = (result << 8) | uint8_t(data[i]);
+    }
+    return result;
+}
+
+void store(char *data, size_t size, uint64_t value) {
+    for (size_t i = size; i > 0; i--) {
+        data[i - 1] = char(value & 0xff);
+        value >>= 8;
+    }
+}
+
+std::string encode(uint64_t value, size_t size) {
+    std::string result(size, '\0');
+    store(&result[0], size, value);
+    return result;
+}
+
+// Counter is all decimal digits that fit into 64 bits
+bool parse_number(const std::string &text, uint64_t &value) {
+    if (text.empty() || text.size() > 20 || text.find_first_not_of("0123456789") != std::string::npos) {
+        return false;
+    }
+    errno = 0;
+    value = std::strtoull(text.c_str(), nullptr, 10);
+    return errno == 0;
+}
+
+const char *status_message(uint16_t status) {
+    switch (status) {
+    case kKeyNotFound:
+        return "Not found";
+    case kKeyExists:
+        return "Data exists for key.";
+    case kInvalidArguments:
+        return "Invalid arguments";
+    case kItemNotStored:
+        return "Not stored.";
+    case kNonNumeric:
+        return "Non-numeric server-side value for incr or decr";
+    case kUnknownCommand:
+        return "Unknown command";
+    default:
+        return "";
+    }
+}
+
+/**
+ * # Command that does nothing
+ * Stands for NOOP and for requests that are answered by the parser itself
+ */
+class Noop : public Execute::Command {
+public:
+    void Execute(Storage &storage, const std::string &args, std::string &out) override { out.clear(); }
+};
+
+} // namespace
+
+// See BinaryParser.h
+bool BinaryParser::Parse(const char *input, const size_t size, size_t &parsed) {
+    parsed = 0;
+    while (parsed < size && head.size() < head_size) {
+        size_t to_read = std::min(head_size - head.size(), size - parsed);
+        head.append(input + parsed, to_read);
+        parsed += to_read;
+
+        // Header tells how much of the body is to be read along with it
+        if (head.size() == kHeaderSize) {
+            if (uint8_t(head[0]) != kRequestMagic) {
+                throw std::runtime_error("Invalid magic byte of binary request");
+            }
+            opcode = find_opcode(uint8_t(head[1]));
+            size_t key_size = load(&head[2], 2);
+            extras_size = uint8_t(head[4]);
+            body_size = load(&head[8], 4);
+            opaque = load(&head[12], 4);
+            cas = load(&head[16], 8);
+            if (extras_size + key_size > body_size) {
+                throw std::runtime_error("Body of binary request is shorter than its extras and key");
+            }
+            head_size += extras_size + key_size;
+        }
+    }
+
+    if (head.size() < head_size) {
+        return false;
+    }
+    key.assign(head, kHeaderSize + extras_size, head_size - kHeaderSize - extras_size);
+    return true;
+}
+
+// See BinaryParser.h
+Execute::Command *BinaryParser::Build(void *space, size_t &value_size) const {
+    if (head.size() < head_size || head.size() < kHeaderSize) {
+        return nullptr;
+    }
+
+    value_size = body_size - (head_size - kHeaderSize);
+    if (!valid()) {
+        return Place<Noop>(space);
+    }
+
+    const char *extras = head.data() + kHeaderSize;
+    switch (opcode->kind) {
+    case OpcodeKind::Get:
+        return Place<Execute::Get>(space, &key, 1, true);
+    case OpcodeKind::Gat:
+        return Place<Execute::Gat>(space, int32_t(load(extras, 4)), &key, 1, true);
+    case OpcodeKind::Set:
+        if (cas != 0) {
+            return Place<Execute::Cas>(space, key, load(extras, 4), int32_t(load(extras + 4, 4)), cas);
+        }
+        return Place<Execute::Set>(space, key, load(extras, 4), int32_t(load(extras + 4, 4)));
+    case OpcodeKind::Add:
+        return Place<Execute::Add>(space, key, load(extras, 4), int32_t(load(extras + 4, 4)));
+    case OpcodeKind::Replace:
+        return Place<Execute::Replace>(space, key, load(extras, 4), int32_t(load(extras + 4, 4)));
+    case OpcodeKind::Append:
+        return Place<Execute::Append>(space, key, 0, 0);
+    case OpcodeKind::Prepend:
+        return Place<Execute::Prepend>(space, key, 0, 0);
+    case OpcodeKind::Delete:
+        return Place<Execute::Delete>(space, key);
+    case OpcodeKind::Incr:
+        return Place<Execute::Incr>(space, key, load(extras, 8));
+    case OpcodeKind::Decr:
+        return Place<Execute::Decr>(space, key, load(extras, 8));
+    case OpcodeKind::Touch:
+        return Place<Execute::Touch>(space, key, int32_t(load(extras, 4)));
+    default:
+        return Place<Noop>(space);
+    }
+}
+
+// See BinaryParser.h
+void BinaryParser::Run(Execute::Command &command, Storage &storage, std::string &value,
+                       Execute::Response &out) const {
+    if (!valid()) {
+        const char *message = status_message(opcode == nullptr ? kUnknownCommand : kInvalidArguments);
+        respond(opcode == nullptr ? kUnknownCommand : kInvalidArguments, 0, "", "", message, std::strlen(message),
+                out);
+        return;
+    }
+
+    // Storage keeps values the way text protocol sends them
+    OpcodeKind kind = opcode->kind;
+    if (kind == OpcodeKind::Set || kind == OpcodeKind::Add || kind == OpcodeKind::Replace ||
+        kind == OpcodeKind::Append || kind == OpcodeKind::Prepend) {
+        value.append("\r\n", 2);
+    }
+
+    const std::string &response_key = opcode->with_key ? key : std::string();
+    uint16_t status = kSuccess;
+
+    // Item is framed right from what storage keeps, text response could not be parsed back for any key
+    if (kind == OpcodeKind::Get || kind == OpcodeKind::Gat) {
+        Execute::Get::Item item;
+        static_cast<Execute::Get &>(command).Retrieve(storage, &item);
+        if (item.found) {
+            respond(kSuccess, item.meta.cas, encode(item.meta.flags, 4), response_key, std::move(item.value), out);
+            return;
+        }
+        if (!opcode->quiet) {
+            const char *message = status_message(kKeyNotFound);
+            respond(kKeyNotFound, 0, "", response_key, message, std::strlen(message), out);
+        }
+        return;
+    }
+
+    std::string result;
+    command.Execute(storage, value, result);
+
+    switch (kind) {
+    case OpcodeKind::Noop:
+        break;
+
+    case OpcodeKind::Incr:
+    case OpcodeKind::Decr: {
+        // Missing item is created with the initial value, unless expiration is all ones
+        const char *extras = head.data() + kHeaderSize;
+        uint32_t expire = load(extras + 16, 4);
+        if (result == "NOT_FOUND" && expire != 0xffffffff) {
+            std::string initial = std::to_string(load(extras + 8, 8));
+            std::string data = initial + "\r\n";
+            std::string stored;
+            Execute::Add(key, 0, int32_t(expire)).Execute(storage, data, stored);
+            if (stored == "STORED") {
+                result = initial;
+            }
+        }
+
+        uint64_t number = 0;
+        if (result == "NOT_FOUND") {
+            status = kKeyNotFound;
+        } else if (result.compare(0, 12, "CLIENT_ERROR") == 0) {
+            status = kNonNumeric;
+        } else if (!parse_number(result, number)) {
+            // Nothing else is expected from the command, but one going wrong must not take the connection down
+            status = kNonNumeric;
+        } else if (!opcode->quiet) {
+            std::string encoded = encode(number, 8);
+            respond(kSuccess, 0, "", "", encoded.data(), encoded.size(), out);
+            return;
+        }
+        break;
+    }
+
+    default: {
+        if (result == "NOT_FOUND") {
+            status = kKeyNotFound;
+        } else if (result == "EXISTS") {
+            status = kKeyExists;
+        } else if (result == "NOT_STORED") {
+            status = kind == OpcodeKind::Add ? kKeyExists : kind == OpcodeKind::Replace ? kKeyNotFound : kItemNotStored;
+        }
+        break;
+    }
+    }
+
+    // Quiet requests are silent on success, quiet retrievals on miss (see above)
+    if (opcode->quiet && status == kSuccess) {
+        return;
+    }
+    const char *message = status_message(status);
+    respond(status, 0, "", response_key, message, std::strlen(message), out);
+}
+
+// See BinaryParser.h
+void BinaryParser::respond(uint16_t status, uint64_t cas, const std::string &extras, const std::string &key,
+                           const char *value, size_t value_size, Execute::Response &out) const {
+    respond_head(status, cas, extras, key, value_size, out);
+    out.Append(value, value_size);
+}
+
+// See BinaryParser.h
+void BinaryParser::respond(uint16_t status, uint64_t cas, const std::string &extras, const std::string &key,
+                           ValueRef value, Execute::Response &out) const {
+    respond_head(status, cas, extras, key, value.size(), out);
+    out.Append(std::move(value));
+}
+
+// See BinaryParser.h
+void BinaryParser::respond_head(uint16_t status, uint64_t cas, const std::string &extras, const std::string &key,
+                                size_t value_size, Execute::Response &out) const {
+    char header[kHeaderSize];
+    header[0] = char(kResponseMagic);
+    header[1] = head[1];
+    store(&header[2], 2, key.size());
+    header[4] = char(extras.size());
+    header[5] = 0;
+    store(&header[6], 2, status);
+    store(&header[8], 4, extras.size() + key.size() + value_size);
+    store(&header[12], 4, opaque);
+    store(&header[16], 8, cas);
+
+    out.Append(header, kHeaderSize);
+    out.Append(extras);
+    out.Append(key);
+}
+
+// See BinaryParser.h
+void BinaryParser::Reset() {
+    head.clear();
+    head_size = kHeaderSize;
+    opcode = nullptr;
+    key.clear();
+    extras_size = 0;
+    body_size = 0;
+    opaque = 0;
+    cas = 0;
+}
+
+// See BinaryParser.h
+bool BinaryParser::valid() const {
+    return opcode != nullptr && extras_size == opcode->extras && (!key.empty() || opcode->kind == OpcodeKind::Noop);
+}
+
+// See BinaryParser.h
+const char *BinaryParser::Name() const { return opcode != nullptr ? opcode->name : "unknown"; }
+
+} // namespace Protocol
+} // namespace Afina
@@ -0,0 +1,119 @@
+#ifndef AFINA_PROTOCOL_BINARY_PARSER_H
+#define AFINA_PROTOCOL_BINARY_PARSER_H
+
+#include <string>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <afina/ValueRef.h>
+
+namespace Afina {
+class Storage;
+namespace Execute {
+class Command;
+class Response;
+} // namespace Execute
+namespace Protocol {
+
+// Entry of the opcode table, see BinaryParser.cpp
+struct OpcodeSpec;
+
+/**
+ * # Memcached binary protocol parser
+ * Every request is a fixed 24 bytes header followed by body of extras, key and value, all lengths are in the
+ * header. Parser takes the header, extras and key, value goes to the command as its argument just like data
+ * block of the text protocol does. Commands are the same as for the text protocol, their results are encoded
+ * into binary responses.
+ *
+ * Quiet requests (GETQ, GETKQ, SETQ...) get no response if they are missed or succeed, so that client could
+ * send a batch of them followed by NOOP and have back only the responses that matter.
+ */
+class BinaryParser {
+public:
+    // First byte of every request
+    static const uint8_t kRequestMagic = 0x80;
+
+    // First byte of every response
+    static const uint8_t kResponseMagic = 0x81;
+
+    // Size of the request and response header
+    static const size_t kHeaderSize = 24;
+
+    BinaryParser() { Reset(); }
+
+    /**
+     * Push given bytes into parser input, same as Parser::Parse does
+     *
+     * @param input bytes to be added to the parsed input
+     * @param size number of bytes in the input buffer that could be read
+     * @param parsed output parameter tells how many bytes was consumed from the input
+     * @return true if header, extras and key of the request are parsed out
+     */
+    bool Parse(const char *input, const size_t size, size_t &parsed);
+
+    /**
+     * Builds command of the parsed request in the given space, returns nullptr if request isn't parsed
+     * out yet. Command references key kept by the parser
+     *
+     * @param space room for the command, kCommandSpace bytes
+     * @param value_size output parameter tells size of the value that follows
+     */
+    Execute::Command *Build(void *space, size_t &value_size) const;
+
+    /**
+     * Executes command built out of the request and appends binary response to out, if there should be any
+     *
+     * @param command built by Build
+     * @param value of the request, gets changed
+     */
+    void Run(Execute::Command &command, Storage &storage, std::string &value, Execute::Response &out) const;
+
+    /**
+     * Reset parser so that it could be used to parse out new request
+     */
+    void Reset();
+
+    // Nothing of the next request has been read yet
+    bool Empty() const { return head.empty(); }
+
+    // Name of the command in the text protocol, for logs
+    const char *Name() const;
+
+private:
+    // Opcode is known and request has what it needs, otherwise request is answered with an error
+    bool valid() const;
+
+    // Appends response to the request with the given status and body parts
+    void respond(uint16_t status, uint64_t cas, const std::string &extras, const std::string &key,
+                 const char *value, size_t value_size, Execute::Response &out) const;
+
+    // Same, but value is referenced by the response rather than copied
+    void respond(uint16_t status, uint64_t cas, const std::string &extras, const std::string &key, ValueRef value,
+                 Execute::Response &out) const;
+
+    // Appends header, extras and key of the response, value_size bytes of value must follow
+    void respond_head(uint16_t status, uint64_t cas, const std::string &extras, const std::string &key,
+                      size_t value_size, Execute::Response &out) const;
+
+    // Header, extras and key of the request as they are read
+    std::string head;
+
+    // Number of bytes of the head to be read, grows once header is there
+    size_t head_size;
+
+    // Opcode found by the header, nullptr if opcode is unknown
+    const OpcodeSpec *opcode;
+
+    // Fields of the parsed request
+    std::string key;
+    uint8_t extras_size;
+    uint32_t body_size;
+    uint32_t opaque;
+    uint64_t cas;
+};
+
+} // namespace Protocol
+} // namespace Afina
+
+#endif // AFINA_PROTOCOL_BINARY_PARSER_H
@@ -0,0 +1,29 @@
+#ifndef AFINA_PROTOCOL_COMMAND_SPACE_H
+#define AFINA_PROTOCOL_COMMAND_SPACE_H
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace Afina {
+namespace Execute {
+class Command;
+} // namespace Execute
+namespace Protocol {
+
+// Room parser has for the command built in place, enough for any of them
+constexpr size_t kCommandSpace = 64;
+
+/**
+ * Makes command of type T in the space parser has for it
+ */
+template <typename T, typename... Args> Execute::Command *Place(void *space, Args &&... args) {
+    static_assert(sizeof(T) <= kCommandSpace && alignof(T) <= alignof(std::max_align_t),
+                  "Command doesn't fit into the parser");
+    return new (space) T(std::forward<Args>(args)...);
+}
+
+} // namespace Protocol
+} // namespace Afina
+
+#endif // AFINA_PROTOCOL_COMMAND_SPACE_H
@@ -1,22 +1,295 @@
 #include "Parser.h"
 
+#include <cstring>
 #include <iostream>
+#include <limits>
 #include <sstream>
 #include <stdexcept>
 
 #include <afina/execute/Add.h>
 #include <afina/execute/Append.h>
+#include <afina/execute/Cas.h>
 #include <afina/execute/Command.h>
+#include <afina/execute/Decr.h>
 #include <afina/execute/Delete.h>
+#include <afina/execute/Gat.h>
 #include <afina/execute/Get.h>
+#include <afina/execute/Incr.h>
+#include <afina/execute/Prepend.h>
+#include <afina/execute/Replace.h>
+#include <afina/execute/Response.h>
 #include <afina/execute/Set.h>
 #include <afina/execute/Stats.h>
+#include <afina/execute/Touch.h>
+
+#include "CommandSpace.h"
+#include "Scanner.h"
 
 namespace Afina {
 namespace Protocol {
 
+namespace {
+
+// Appends decimal digit to unsigned field, throws once it overflows
+template <typename T> void push_digit(T &field, char c, const char *error) {
+    T digit = c - '0';
+    if (field > (std::numeric_limits<T>::max() - digit) / 10) {
+        // Overflow
+        throw std::runtime_error(error);
+    }
+    field = field * 10 + digit;
+}
+
+// Appends decimal digit to expire time, throws once it overflows
+void push_digit(int32_t &field, bool negative, char c) {
+    int64_t et = int64_t(field) * 10 + (negative ? -(c - '0') : (c - '0'));
+    if (et > std::numeric_limits<int32_t>::max() || et < std::numeric_limits<int32_t>::min()) {
+        throw std::runtime_error("Expire time field overflow");
+    }
+    field = et;
+}
+
+// Slice is a decimal number, optionally negative
+bool is_number(const Slice &slice, bool allow_sign) {
+    size_t start = (allow_sign && slice.size > 0 && slice.data[0] == '-') ? 1 : 0;
+    if (slice.size == start) {
+        return false;
+    }
+    for (size_t i = start; i < slice.size; i++) {
+        if (slice.data[i] < '0' || slice.data[i] > '9') {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Unsigned number out of the command word
+template <typename T> T parse_unsigned(const std::string &word, const char *error) {
+    if (!is_number({word.data(), word.size()}, false)) {
+        throw std::runtime_error(error);
+    }
+    T result = 0;
+    for (char c : word) {
+        push_digit(result, c, error);
+    }
+    return result;
+}
+
+// Expire time out of the command word
+int32_t parse_expire(const std::string &word) {
+    if (!is_number({word.data(), word.size()}, true)) {
+        throw std::runtime_error("Invalid expire time");
+    }
+    bool negative = word[0] == '-';
+    int32_t result = 0;
+    for (size_t i = negative ? 1 : 0; i < word.size(); i++) {
+        push_digit(result, negative, word[i]);
+    }
+    return result;
+}
+
+// Builder of the command out of words of the line (key of storage command is the only one) and numeric fields
+using Builder = Execute::Command *(*)(void *space, const std::string *words, size_t count, uint32_t flags,
+                                      int32_t exprtime, uint64_t cas);
+
+// Command taking <key> <flags> <exptime> <bytes>
+template <typename T>
+Execute::Command *build_insert(void *space, const std::string *keys, size_t count, uint32_t flags, int32_t exprtime,
+                               uint64_t) {
+    if (count == 0) {
+        throw std::runtime_error("Client provides no key to store");
+    }
+    return Place<T>(space, keys[0], flags, exprtime);
+}
+
+Execute::Command *build_cas(void *space, const std::string *keys, size_t count, uint32_t flags, int32_t exprtime,
+                            uint64_t cas) {
+    if (count == 0) {
+        throw std::runtime_error("Client provides no key to store");
+    }
+    return Place<Execute::Cas>(space, keys[0], flags, exprtime, cas);
+}
+
+// get and gets: <key>*
+template <bool WithCas>
+Execute::Command *build_get(void *space, const std::string *words, size_t count, uint32_t, int32_t, uint64_t) {
+    if (count == 0) {
+        throw std::runtime_error("Client provides no key to retrive");
+    }
+    return Place<Execute::Get>(space, words, count, WithCas);
+}
+
+// gat and gats: <exptime> <key>*
+template <bool WithCas>
+Execute::Command *build_gat(void *space, const std::string *words, size_t count, uint32_t, int32_t, uint64_t) {
+    if (count < 2) {
+        throw std::runtime_error("Client provides no key to retrive");
+    }
+    return Place<Execute::Gat>(space, parse_expire(words[0]), words + 1, count - 1, WithCas);
+}
+
+// delete: <key>
+Execute::Command *build_delete(void *space, const std::string *words, size_t count, uint32_t, int32_t, uint64_t) {
+    if (count == 0) {
+        throw std::runtime_error("Client provides no key to delete");
+    }
+    return Place<Execute::Delete>(space, words[0]);
+}
+
+// incr and decr: <key> <value>
+template <typename T>
+Execute::Command *build_arithmetic(void *space, const std::string *words, size_t count, uint32_t, int32_t,
+                                   uint64_t) {
+    if (count < 2) {
+        throw std::runtime_error("Client provides no key or value to change");
+    }
+    return Place<T>(space, words[0], parse_unsigned<uint64_t>(words[1], "Invalid numeric delta argument"));
+}
+
+// touch: <key> <exptime>
+Execute::Command *build_touch(void *space, const std::string *words, size_t count, uint32_t, int32_t, uint64_t) {
+    if (count < 2) {
+        throw std::runtime_error("Client provides no key or expire time to touch");
+    }
+    return Place<Execute::Touch>(space, words[0], parse_expire(words[1]));
+}
+
+// stats: [<group>]
+Execute::Command *build_stats(void *space, const std::string *words, size_t count, uint32_t, int32_t, uint64_t) {
+    if (count == 0) {
+        return Place<Execute::Stats>(space);
+    }
+    if (words[0] == "locks") {
+        return Place<Execute::Stats>(space, Execute::Stats::Group::kLocks);
+    }
+    throw std::runtime_error("Unknown stats group: " + words[0]);
+}
+
+} // namespace
+
+/**
+ * Layout of the command line after the name
+ */
+enum class Syntax : uint8_t {
+    // <command>\r\n
+    None,
+    // <command> <key> <flags> <exptime> <bytes>\r\n, followed by data block
+    Storage,
+    // same as Storage with <cas unique> after <bytes>
+    Cas,
+    // <command> <word>*\r\n, words are made sense of once command is built
+    Words
+};
+
+/**
+ * # Entry of the command table
+ */
+struct CommandSpec {
+    const char *name;
+    size_t size;
+    Syntax syntax;
+    Builder build;
+};
+
+namespace {
+
+constexpr size_t length(const char *name) { return *name == '\0' ? 0 : 1 + length(name + 1); }
+
+constexpr CommandSpec entry(const char *name, Syntax syntax, Builder build) {
+    return CommandSpec{name, length(name), syntax, build};
+}
+
+// Commands server knows. New one is a line here, unless its name collides with others in command_hash
+constexpr CommandSpec kCommands[] = {
+    entry("set", Syntax::Storage, &build_insert<Execute::Set>),
+    entry("add", Syntax::Storage, &build_insert<Execute::Add>),
+    entry("replace", Syntax::Storage, &build_insert<Execute::Replace>),
+    entry("append", Syntax::Storage, &build_insert<Execute::Append>),
+    entry("prepend", Syntax::Storage, &build_insert<Execute::Prepend>),
+    entry("cas", Syntax::Cas, &build_cas),
+    entry("get", Syntax::Words, &build_get<false>),
+    entry("gets", Syntax::Words, &build_get<true>),
+    entry("gat", Syntax::Words, &build_gat<false>),
+    entry("gats", Syntax::Words, &build_gat<true>),
+    entry("delete", Syntax::Words, &build_delete),
+    entry("incr", Syntax::Words, &build_arithmetic<Execute::Incr>),
+    entry("decr", Syntax::Words, &build_arithmetic<Execute::Decr>),
+    entry("touch", Syntax::Words, &build_touch),
+    entry("stats", Syntax::Words, &build_stats),
+};
+
+constexpr size_t kCommandsCount = sizeof(kCommands) / sizeof(kCommands[0]);
+constexpr size_t kSlotsCount = 32;
+
+// Slot of the name with at least two chars. Length and two first chars set all the names apart
+constexpr size_t command_hash(const char *name, size_t size) {
+    return (uint8_t(name[0]) + uint8_t(name[1]) + 10 * size) & (kSlotsCount - 1);
+}
+
+// Index of the first command starting from i that hashes into the slot, kCommandsCount if there is none
+constexpr size_t find_command(size_t slot, size_t i) {
+    return i == kCommandsCount || command_hash(kCommands[i].name, kCommands[i].size) == slot
+               ? i
+               : find_command(slot, i + 1);
+}
+
+// Every command from i on is the first one in its slot
+constexpr bool is_perfect(size_t i) {
+    return i == kCommandsCount ||
+           (find_command(command_hash(kCommands[i].name, kCommands[i].size), 0) == i && is_perfect(i + 1));
+}
+
+static_assert(kCommandsCount < 256 && kSlotsCount > kCommandsCount, "Command table is too large");
+static_assert(is_perfect(0), "Command names collide, command_hash needs other constants");
+
+// Slot to command index map, generated out of the table at compile time
+struct SlotMap {
+    uint8_t index[kSlotsCount];
+};
+
+template <size_t... I> struct Indices {};
+template <size_t N, size_t... I> struct MakeIndices : MakeIndices<N - 1, N - 1, I...> {};
+template <size_t... I> struct MakeIndices<0, I...> { typedef Indices<I...> type; };
+
+template <size_t... I> constexpr SlotMap make_slots(Indices<I...>) {
+    return SlotMap{{uint8_t(find_command(I, 0))...}};
+}
+
+constexpr SlotMap kSlots = make_slots(MakeIndices<kSlotsCount>::type());
+
+// Command with the given name, nullptr if there is none
+const CommandSpec *lookup(const char *name, size_t size) {
+    if (size < 2) {
+        return nullptr;
+    }
+    size_t index = kSlots.index[command_hash(name, size)];
+    if (index == kCommandsCount || kCommands[index].size != size ||
+        std::memcmp(kCommands[index].name, name, size) != 0) {
+        return nullptr;
+    }
+    return &kCommands[index];
+}
+
+} // namespace
+
 // See Parse.h
 bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
+    if (mode == Mode::Unknown && size > 0) {
+        mode = uint8_t(input[0]) == BinaryParser::kRequestMagic ? Mode::Binary : Mode::Text;
+    }
+    if (mode == Mode::Binary) {
+        if (!binary.Parse(input, size, parsed)) {
+            return false;
+        }
+        name.assign(binary.Name());
+        return true;
+    }
+
+    // Command line that arrived completely is cut into slices at once, split one goes through the state machine
+    if (state == State::sName && name.empty() && parse_line(input, size, parsed)) {
+        return true;
+    }
+
     size_t pos;
     parsed = 0;
 
@@ -28,15 +301,18 @@ bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
         case State::sName: {
             if (c == ' ' || c == '\r') {
                 // std::cout << "parser debug: name='" << name << "'" << std::endl;
-                if (name == "set" || name == "add" || name == "append" || name == "prepend") {
-                    state = State::spKey;
-                } else if (name == "get" || name == "gets") {
-                    state = State::sgKey;
-                } else if (name == "stats") {
+                command = lookup(name.data(), name.size());
+                if (command == nullptr) {
+                    throw std::runtime_error("Unknown command name: " + name);
+                }
+
+                // Command with no arguments given is left for Build to complain
+                if (c == '\r' || command->syntax == Syntax::None) {
                     state = State::sLF;
-                    continue;
+                } else if (command->syntax == Syntax::Words) {
+                    state = State::sgKey;
                 } else {
-                    throw std::runtime_error("Unknown command name: " + name);
+                    state = State::spKey;
                 }
             } else {
                 name.push_back(c);
@@ -47,7 +323,7 @@ bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
         case State::spKey: {
             if (c == ' ') {
                 state = State::spFlags;
-                keys.push_back(curKey);
+                push_key(curKey.data(), curKey.size());
                 // std::cout << "parser debug: key[" << keys.size() - 1 << "]='" << curKey << "'" << std::endl;
             } else {
                 curKey.push_back(c);
@@ -57,10 +333,10 @@ bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
 
         case State::sgKey: {
             if (c == '\r') {
-                keys.push_back(curKey);
+                push_key(curKey.data(), curKey.size());
                 // std::cout << "parser debug: total '" << keys.size() << " keys" << std::endl;
 
-                if (keys.size() == 0) {
+                if (keys_count == 0) {
                     throw std::runtime_error("Client provides no key to retrive");
                 }
 
@@ -69,7 +345,7 @@ bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
             } else if (c == ' ') {
                 // std::cout << "parser debug: key[" << keys.size() << "]='" << curKey << "'" << std::endl;
                 state = State::sgKey;
-                keys.push_back(curKey);
+                push_key(curKey.data(), curKey.size());
                 curKey.clear();
             } else {
                 curKey.push_back(c);
@@ -83,12 +359,7 @@ bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
                 state = State::spExprTimeStart;
                 // std::cout << "parser debug: flags='" << flags << "'" << std::endl;
             } else if (c >= '0' && c <= '9') {
-                uint32_t f = (flags * 10) + (c - '0');
-                if (f < flags) {
-                    // Overflow
-                    throw std::runtime_error("Flags field overflow");
-                }
-                flags = f;
+                push_digit(flags, c, "Flags field overflow");
             }
             break;
         }
@@ -109,19 +380,7 @@ bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
                 state = State::spBytes;
                 // std::cout << "parser debug: ExprTime='" << exprtime << "'" << std::endl;
             } else if (c >= '0' && c <= '9') {
-                int32_t et = exprtime;
-                if (negative) {
-                    et -= (c - '0');
-                    if (et > exprtime) {
-                        throw std::runtime_error("Expire time field overflow");
-                    }
-                } else {
-                    et += (c - '0');
-                    if (et < exprtime) {
-                        throw std::runtime_error("Expire time field overflow");
-                    }
-                }
-                exprtime = et;
+                push_digit(exprtime, negative, c);
             }
             break;
         }
@@ -130,13 +389,19 @@ bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
             if (c == '\r') {
                 state = State::sLF;
                 // std::cout << "parser debug: bytes='" << bytes << "'" << std::endl;
+            } else if (c == ' ' && command->syntax == Syntax::Cas) {
+                state = State::spCas;
             } else if (c >= '0' && c <= '9') {
-                uint32_t b = (bytes * 10) + (c - '0');
-                if (b < bytes) {
-                    // Overflow
-                    throw std::runtime_error("Bytes field overflow");
-                }
-                bytes = b;
+                push_digit(bytes, c, "Bytes field overflow");
+            }
+            break;
+        }
+
+        case State::spCas: {
+            if (c == '\r') {
+                state = State::sLF;
+            } else if (c >= '0' && c <= '9') {
+                push_digit(cas, c, "Cas unique field overflow");
             }
             break;
         }
@@ -162,37 +427,162 @@ bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
 }
 
 // See Parse.h
-std::unique_ptr<Execute::Command> Parser::Build(size_t &body_size) const {
-    if (state != State::sLF) {
-        return std::unique_ptr<Execute::Command>(nullptr);
-    }
-
-    body_size = bytes;
-    if (name == "set") {
-        return std::unique_ptr<Execute::Command>(new Execute::Set(keys[0], flags, exprtime));
-    } else if (name == "add") {
-        return std::unique_ptr<Execute::Command>(new Execute::Add(keys[0], flags, exprtime));
-    } else if (name == "append") {
-        return std::unique_ptr<Execute::Command>(new Execute::Append(keys[0], flags, exprtime));
-    } else if (name == "get") {
-        return std::unique_ptr<Execute::Command>(new Execute::Get(keys));
-    } else if (name == "stats") {
-        return std::unique_ptr<Execute::Command>(new Execute::Stats());
+bool Parser::parse_line(const char *input, const size_t size, size_t &parsed) {
+    const char *end = input + size;
+    const char *delim = FindDelimiter(input, end);
+    if (delim == end) {
+        return false;
+    }
+
+    const CommandSpec *spec = lookup(input, delim - input);
+    if (spec == nullptr) {
+        return false;
+    }
+
+    switch (spec->syntax) {
+    case Syntax::None: {
+        if (*delim != '\r') {
+            return false;
+        }
+        break;
+    }
+
+    case Syntax::Storage:
+    case Syntax::Cas: {
+        // <key> <flags> <exptime> <bytes> [<cas unique>], anything else is left to the state machine
+        const size_t expected = spec->syntax == Syntax::Cas ? 5 : 4;
+        Slice args[5];
+        size_t count = 0;
+        while (*delim == ' ' && count < expected) {
+            const char *begin = delim + 1;
+            delim = FindDelimiter(begin, end);
+            if (delim == end) {
+                return false;
+            }
+            args[count++] = {begin, size_t(delim - begin)};
+        }
+        if (count < expected || *delim != '\r' || delim + 1 == end || delim[1] != '\n' ||
+            !is_number(args[1], false) || !is_number(args[2], true) || !is_number(args[3], false) ||
+            (expected == 5 && !is_number(args[4], false))) {
+            return false;
+        }
+
+        push_key(args[0].data, args[0].size);
+        for (size_t i = 0; i < args[1].size; i++) {
+            push_digit(flags, args[1].data[i], "Flags field overflow");
+        }
+        negative = args[2].data[0] == '-';
+        for (size_t i = negative ? 1 : 0; i < args[2].size; i++) {
+            push_digit(exprtime, negative, args[2].data[i]);
+        }
+        for (size_t i = 0; i < args[3].size; i++) {
+            push_digit(bytes, args[3].data[i], "Bytes field overflow");
+        }
+        for (size_t i = 0; expected == 5 && i < args[4].size; i++) {
+            push_digit(cas, args[4].data[i], "Cas unique field overflow");
+        }
+        break;
+    }
+
+    case Syntax::Words: {
+        while (*delim == ' ') {
+            const char *begin = delim + 1;
+            delim = FindDelimiter(begin, end);
+            if (delim == end) {
+                keys_count = 0;
+                return false;
+            }
+            push_key(begin, delim - begin);
+        }
+        break;
+    }
+    }
+
+    if (delim + 1 == end || delim[1] != '\n') {
+        keys_count = 0;
+        return false;
+    }
+
+    command = spec;
+    name.assign(spec->name, spec->size);
+    state = State::sLF;
+    parse_complete = true;
+    parsed = delim + 2 - input;
+    return true;
+}
+
+// See Parse.h
+Execute::Command *Parser::Build(size_t &body_size) {
+    if (mode == Mode::Binary ? name.empty() : state != State::sLF) {
+        return nullptr;
+    }
+
+    if (command_built != nullptr) {
+        command_built->~Command();
+        command_built = nullptr;
+    }
+    if (mode == Mode::Binary) {
+        command_built = binary.Build(command_space, body_size);
+    } else {
+        command_built = command->build(command_space, keys.data(), keys_count, flags, exprtime, cas);
+        body_size = bytes;
+    }
+    return command_built;
+}
+
+// See Parse.h
+size_t Parser::Trailer() const {
+    // Text data block ends with \r\n, binary value has nothing after it
+    bool has_block = mode == Mode::Text && command != nullptr &&
+                     (command->syntax == Syntax::Storage || command->syntax == Syntax::Cas);
+    return has_block ? 2 : 0;
+}
+
+// See Parse.h
+void Parser::Run(Storage &storage, std::string &args, Execute::Response &out) {
+    size_t before = out.Size();
+    if (mode == Mode::Binary) {
+        binary.Run(*command_built, storage, args, out);
     } else {
-        throw std::runtime_error("Unsupported command");
+        command_built->Execute(storage, args, out);
+        out.Append("\r\n", 2);
     }
+    Execute::Stats::Global().bytes_written.Add(out.Size() - before);
+}
+
+// See Parse.h
+void Parser::push_key(const char *data, size_t size) {
+    if (keys_count == keys.size()) {
+        keys.emplace_back();
+    }
+    keys[keys_count++].assign(data, size);
 }
 
 // See Parse.h
 void Parser::Reset() {
     state = State::sName;
+    if (command_built != nullptr) {
+        command_built->~Command();
+        command_built = nullptr;
+    }
+    command = nullptr;
+    binary.Reset();
     name.clear();
-    keys.clear();
+    keys_count = 0;
     curKey.clear();
     parse_complete = false;
     flags = 0;
     bytes = 0;
     exprtime = 0;
+    cas = 0;
+}
+
+// See Parse.h
+bool Parser::Empty() const {
+    if (command_built != nullptr || !name.empty()) {
+        return false;
+    }
+    return mode == Mode::Binary ? binary.Empty() : state == State::sName;
 }
 
 } // namespace Protocol
@@ -8,19 +8,36 @@
 #include <cstddef>
 #include <cstdint>
 
+#include "BinaryParser.h"
+#include "CommandSpace.h"
+
 namespace Afina {
+class Storage;
 namespace Execute {
 class Command;
+class Response;
 } // namespace Execute
 namespace Protocol {
 
+// Entry of the command table, see Parser.cpp
+struct CommandSpec;
+
 /**
  * # Memcached protocol parser
- * Parser supports subset of memcached protocol
+ * Parser supports subset of memcached protocol, both text and binary one. Protocol is chosen by the first
+ * byte connection sends and stays the same for the rest of it: binary requests start with 0x80, that is
+ * not a char text command could start with
+ *
+ * Parser could be passed from one connection to another in between of commands, see Empty and Clear
  */
 class Parser {
 public:
-    Parser() { Reset(); }
+    Parser() : mode(Mode::Unknown), command_built(nullptr), keys_count(0) { Reset(); }
+    ~Parser() { Reset(); }
+
+    Parser(const Parser &) = delete;
+    Parser &operator=(const Parser &) = delete;
+
     /**
      * Push given string into parser input. Method returns true if it was a command parsed out
      * from cumulative input. In a such case method Build will return new command
@@ -44,32 +61,93 @@ public:
 
     /**
      * Builds new command from parsed input. In case if it wasn't enough input to parse command out
-     * method return nullptr
+     * method return nullptr.
+     *
+     * Command lives inside of the parser and references its keys, so building one takes no allocations.
+     * It stays valid until the next Build or Reset, which destroy it
+     */
+    Execute::Command *Build(size_t &body_size);
+
+    /**
+     * Number of bytes protocol puts after data block of the built command, those are read as a part of
+     * command argument along with the block
      */
-    std::unique_ptr<Execute::Command> Build(size_t &body_size) const;
+    size_t Trailer() const;
+
+    /**
+     * Executes command made by the last Build and appends its response to out, framed the way protocol of
+     * the connection does
+     *
+     * @param storage to execute command against
+     * @param args data block read after the command, could be changed
+     * @param out response to append to
+     */
+    void Run(Storage &storage, std::string &args, Execute::Response &out);
 
     /**
      * Reset parse so that it could be used to parse out new command
      */
     void Reset();
 
+    /**
+     * Nothing of the next command has been taken from input yet, so parser holds no state of the connection
+     * but the protocol
+     */
+    bool Empty() const;
+
+    /**
+     * Resets parser and forgets protocol, so that it could be used to parse out commands of another connection
+     */
+    void Clear() {
+        Reset();
+        mode = Mode::Unknown;
+    }
+
     inline const std::string &Name() const { return name; }
 
 private:
+    /**
+     * Fast path of Parse for the parser that has seen nothing yet: if input has complete command line in a
+     * well-formed shape, cuts it into slices by delimiters found with SIMD and fills the fields from them.
+     * Returns false leaving parser untouched otherwise, then the state machine does the job byte by byte
+     */
+    bool parse_line(const char *input, const size_t size, size_t &parsed);
+
+    // Adds key to the command, reusing string left from the commands before if there is one
+    void push_key(const char *data, size_t size);
+
+    // Protocol of the connection, unknown until first byte arrives
+    enum class Mode : uint8_t { Unknown, Text, Binary };
+    Mode mode;
+
+    // Parser of the binary requests
+    BinaryParser binary;
+
     /**
      * State of the command parser. Prefixes are:
      * - s: state for PUT and GET commands
      * - sp: for PUT commands only
-     * - sg: for GET commands only
+     * - sg: for GET and other commands taking list of words
      */
-    enum State : uint16_t { sCR, sLF, sName, spKey, spFlags, spExprTimeStart, spExprTime, spBytes, sgKey };
+    enum State : uint16_t { sCR, sLF, sName, spKey, spFlags, spExprTimeStart, spExprTime, spBytes, spCas, sgKey };
 
     // Current parser state
     State state;
 
+    // Command found by name, nullptr until name is complete
+    const CommandSpec *command;
+
+    // Command object made by Build, nullptr if there is none
+    Execute::Command *command_built;
+    alignas(std::max_align_t) char command_space[kCommandSpace];
+
     // various fields of the command
     std::string name;
+
+    // First keys_count strings are keys of the command. The rest are kept from the commands before, so that
+    // their memory is reused by the next ones
     std::vector<std::string> keys;
+    size_t keys_count;
 
     // <flags> is an arbitrary 16-bit unsigned integer (written out in decimal) that the server stores along with
     // the data and sends back when the item is retrieved. Clients may use this as a bit field to store data-specific
@@ -88,6 +166,9 @@ private:
     // it's followed by an empty data block).
     uint32_t bytes;
 
+    // <cas unique> of cas command, 64-bit version of the item taken from gets
+    uint64_t cas;
+
     bool negative;
     std::string curKey;
     bool parse_complete;
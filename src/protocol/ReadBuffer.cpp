@@ -0,0 +1,100 @@
+#include "ReadBuffer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <unistd.h>
+
+#include <afina/execute/Stats.h>
+
+namespace Afina {
+namespace Protocol {
+
+// See ReadBuffer.h
+ReadBuffer::ReadBuffer() : _memory(new char[kPooledSize]), _capacity(kPooledSize), _head(0), _tail(0) {}
+
+// See ReadBuffer.h
+void ReadBuffer::Consume(size_t size) {
+    _head += size;
+    if (_head < _tail) {
+        return;
+    }
+
+    // Nothing left, next read starts from the front of the buffer of the usual size
+    _head = _tail = 0;
+    if (_capacity > kPooledSize) {
+        _memory.reset(new char[kPooledSize]);
+        _capacity = kPooledSize;
+    }
+}
+
+// See ReadBuffer.h
+bool ReadBuffer::Reserve(size_t size) {
+    if (_head + size <= _capacity) {
+        return true;
+    }
+    if (size > kMaxSize) {
+        return false;
+    }
+
+    if (size <= _capacity) {
+        std::memmove(_memory.get(), Data(), Size());
+        _tail -= _head;
+        _head = 0;
+    } else {
+        size_t capacity = _capacity;
+        while (capacity < size) {
+            capacity *= 2;
+        }
+        reallocate(capacity < kMaxSize ? capacity : kMaxSize);
+    }
+    return true;
+}
+
+// See ReadBuffer.h
+ssize_t ReadBuffer::Read(int fd) {
+    size_t size = room();
+    ssize_t result = read(fd, _memory.get() + _tail, size);
+    if (result > 0) {
+        _tail += result;
+        Execute::Stats::Global().bytes_read.Add(result);
+    }
+    return result;
+}
+
+// See ReadBuffer.h
+void ReadBuffer::Append(const char *data, size_t size) {
+    if (!Reserve(Size() + size)) {
+        throw std::runtime_error("Command doesn't fit into read buffer");
+    }
+    std::memcpy(_memory.get() + _tail, data, size);
+    _tail += size;
+    Execute::Stats::Global().bytes_read.Add(size);
+}
+
+// See ReadBuffer.h
+size_t ReadBuffer::room() {
+    if (_tail < _capacity) {
+        return _capacity - _tail;
+    }
+
+    // Input is moved to the front if that frees at least half of the buffer, otherwise buffer grows
+    if (!Reserve(Size() + std::max(_head, _capacity / 2))) {
+        throw std::runtime_error("Command doesn't fit into read buffer");
+    }
+    return _capacity - _tail;
+}
+
+// See ReadBuffer.h
+void ReadBuffer::reallocate(size_t capacity) {
+    std::unique_ptr<char[]> memory(new char[capacity]);
+    std::memcpy(memory.get(), Data(), Size());
+    _memory = std::move(memory);
+    _capacity = capacity;
+    _tail -= _head;
+    _head = 0;
+}
+
+} // namespace Protocol
+} // namespace Afina
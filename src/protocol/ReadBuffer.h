@@ -0,0 +1,78 @@
+#ifndef AFINA_PROTOCOL_READ_BUFFER_H
+#define AFINA_PROTOCOL_READ_BUFFER_H
+
+#include <cstddef>
+#include <memory>
+
+#include <sys/types.h>
+
+namespace Afina {
+namespace Protocol {
+
+/**
+ * # Input of the connection
+ * Keeps bytes received and not parsed yet. Commands are parsed right where they were read to and consumed
+ * bytes are skipped by moving the start, so nothing is moved around per command. Rest of the input is moved
+ * to the front only once there is no room after it.
+ *
+ * Buffer grows once a value doesn't fit, so that value arrives by as few reads as possible and is taken out
+ * in one piece. Once everything is consumed buffer gets back to its pooled size.
+ */
+class ReadBuffer {
+public:
+    // Size of the buffer while there is nothing large to hold
+    static const size_t kPooledSize = 4096;
+
+    // Buffer never grows beyond that, larger values are taken out piece by piece
+    static const size_t kMaxSize = 1 << 20;
+
+    ReadBuffer();
+
+    ReadBuffer(const ReadBuffer &) = delete;
+    ReadBuffer &operator=(const ReadBuffer &) = delete;
+
+    /**
+     * Bytes not consumed yet
+     */
+    const char *Data() const { return _memory.get() + _head; }
+    size_t Size() const { return _tail - _head; }
+    bool Empty() const { return _head == _tail; }
+
+    /**
+     * Drops size bytes from the front
+     */
+    void Consume(size_t size);
+
+    /**
+     * Makes room for size bytes of data in one piece, counting those already there. Returns false if
+     * that is more than buffer could hold
+     */
+    bool Reserve(size_t size);
+
+    /**
+     * Reads once from the descriptor into the room after data and returns result of read. Throws
+     * runtime_error if there is no room left: command doesn't fit even into max size
+     */
+    ssize_t Read(int fd);
+
+    /**
+     * Copies bytes to the end of data, throws runtime_error if they don't fit
+     */
+    void Append(const char *data, size_t size);
+
+private:
+    // Returns room after data, making it if there is none
+    size_t room();
+
+    void reallocate(size_t capacity);
+
+    std::unique_ptr<char[]> _memory;
+    size_t _capacity;
+    size_t _head;
+    size_t _tail;
+};
+
+} // namespace Protocol
+} // namespace Afina
+
+#endif // AFINA_PROTOCOL_READ_BUFFER_H
@@ -0,0 +1,61 @@
+#ifndef AFINA_PROTOCOL_SCANNER_H
+#define AFINA_PROTOCOL_SCANNER_H
+
+#include <cstddef>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace Afina {
+namespace Protocol {
+
+/**
+ * # Slice of the input
+ * Part of the buffer being parsed, valid as long as the buffer is
+ */
+struct Slice {
+    const char *data;
+    size_t size;
+};
+
+/**
+ * Returns position of the first ' ' or '\r' in [begin, end), end if there is none. Looks at 32 bytes at a
+ * time with AVX2, 16 with SSE2, whatever build targets, and byte by byte at the tail
+ */
+inline const char *FindDelimiter(const char *begin, const char *end) {
+#if defined(__AVX2__)
+    const __m256i space32 = _mm256_set1_epi8(' ');
+    const __m256i cr32 = _mm256_set1_epi8('\r');
+    for (; end - begin >= 32; begin += 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin));
+        unsigned mask = _mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, space32), _mm256_cmpeq_epi8(chunk, cr32)));
+        if (mask != 0) {
+            return begin + __builtin_ctz(mask);
+        }
+    }
+#endif
+#if defined(__SSE2__)
+    const __m128i space16 = _mm_set1_epi8(' ');
+    const __m128i cr16 = _mm_set1_epi8('\r');
+    for (; end - begin >= 16; begin += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+        unsigned mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, space16), _mm_cmpeq_epi8(chunk, cr16)));
+        if (mask != 0) {
+            return begin + __builtin_ctz(mask);
+        }
+    }
+#endif
+    for (; begin < end; begin++) {
+        if (*begin == ' ' || *begin == '\r') {
+            return begin;
+        }
+    }
+    return end;
+}
+
+} // namespace Protocol
+} // namespace Afina
+
+#endif // AFINA_PROTOCOL_SCANNER_H
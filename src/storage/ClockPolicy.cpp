@@ -0,0 +1,62 @@
+#include "ClockPolicy.h"
+
+namespace Afina {
+namespace Backend {
+
+// See ClockPolicy.h
+void ClockPolicy::Insert(PolicyHook &hook) {
+    hook.flags = 0;
+    if (_hand == nullptr) {
+        hook.prev = &hook;
+        hook.next = &hook;
+        _hand = &hook;
+        return;
+    }
+
+    hook.prev = _hand->prev;
+    hook.next = _hand;
+    _hand->prev->next = &hook;
+    _hand->prev = &hook;
+}
+
+// See ClockPolicy.h
+void ClockPolicy::Access(PolicyHook &hook) { hook.flags |= kReferenced; }
+
+// See ClockPolicy.h
+void ClockPolicy::SharedAccess(PolicyHook &hook) {
+    // Hot item keeps its bit, so its cache line stays shared between readers
+    if ((__atomic_load_n(&hook.flags, __ATOMIC_RELAXED) & kReferenced) == 0) {
+        __atomic_fetch_or(&hook.flags, kReferenced, __ATOMIC_RELAXED);
+    }
+}
+
+// See ClockPolicy.h
+void ClockPolicy::Erase(PolicyHook &hook) {
+    if (hook.next == &hook) {
+        _hand = nullptr;
+        return;
+    }
+
+    if (_hand == &hook) {
+        _hand = hook.next;
+    }
+    hook.prev->next = hook.next;
+    hook.next->prev = hook.prev;
+}
+
+// See ClockPolicy.h
+PolicyHook *ClockPolicy::Victim() {
+    if (_hand == nullptr) {
+        return nullptr;
+    }
+
+    // Terminates after a single round at most: bits are cleared on the way
+    while (_hand->flags & kReferenced) {
+        _hand->flags &= ~kReferenced;
+        _hand = _hand->next;
+    }
+    return _hand;
+}
+
+} // namespace Backend
+} // namespace Afina
@@ -0,0 +1,45 @@
+#ifndef AFINA_STORAGE_CLOCK_POLICY_H
+#define AFINA_STORAGE_CLOCK_POLICY_H
+
+#include "EvictionPolicy.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # CLOCK eviction
+ * Items form a ring with a hand pointing to the next candidate. Access only sets reference bit of
+ * the item, so hit never touches neighbours. Looking for victim hand clears bits of referenced items
+ * giving them second chance and stops at the first item without the bit. New items are placed right
+ * behind the hand, so they are visited last.
+ */
+class ClockPolicy : public EvictionPolicy {
+public:
+    ClockPolicy() : _hand(nullptr) {}
+
+    // Implements EvictionPolicy interface
+    void Insert(PolicyHook &hook) override;
+
+    // Implements EvictionPolicy interface
+    void Access(PolicyHook &hook) override;
+
+    // Implements EvictionPolicy interface, reference bit is set atomically and only if it isn't set yet
+    void SharedAccess(PolicyHook &hook) override;
+
+    // Implements EvictionPolicy interface
+    void Erase(PolicyHook &hook) override;
+
+    // Implements EvictionPolicy interface
+    PolicyHook *Victim() override;
+
+private:
+    static const uint32_t kReferenced = 1;
+
+    // Next candidate for eviction, nullptr if ring is empty
+    PolicyHook *_hand;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_CLOCK_POLICY_H
@@ -0,0 +1,33 @@
+#include "EvictionPolicy.h"
+
+#include <stdexcept>
+
+#include "ClockPolicy.h"
+#include "LRUPolicy.h"
+
+namespace Afina {
+namespace Backend {
+
+// See EvictionPolicy.h
+std::unique_ptr<EvictionPolicy> EvictionPolicy::Create(Type type) {
+    switch (type) {
+    case Type::kLRU:
+        return std::unique_ptr<EvictionPolicy>(new LRUPolicy());
+    case Type::kCLOCK:
+        return std::unique_ptr<EvictionPolicy>(new ClockPolicy());
+    }
+    throw std::invalid_argument("Unknown eviction policy");
+}
+
+// See EvictionPolicy.h
+EvictionPolicy::Type EvictionPolicy::FromName(const std::string &name) {
+    if (name == "lru") {
+        return Type::kLRU;
+    } else if (name == "clock") {
+        return Type::kCLOCK;
+    }
+    throw std::invalid_argument("Unknown eviction policy: " + name);
+}
+
+} // namespace Backend
+} // namespace Afina
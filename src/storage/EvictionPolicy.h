@@ -0,0 +1,85 @@
+#ifndef AFINA_STORAGE_EVICTION_POLICY_H
+#define AFINA_STORAGE_EVICTION_POLICY_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * Intrusive part of the storage node that eviction policy operates on. Policy never allocates,
+ * all its per-item state lives here.
+ */
+struct PolicyHook {
+    PolicyHook *prev;
+    PolicyHook *next;
+
+    // Policy specific state, i.e reference bit of CLOCK
+    uint32_t flags;
+};
+
+/**
+ * # Eviction policy
+ * Decides which item of the storage goes away once there is no room for the new one. Storage reports
+ * every insert, access and removal of the item, and asks for a victim when it needs memory. Policy
+ * doesn't remove victim by itself: storage does it and reports the removal as usual.
+ *
+ * That is NOT thread safe implementation!!
+ */
+class EvictionPolicy {
+public:
+    enum class Type {
+        // Strict LRU: each access moves item to the tail of the list
+        kLRU,
+
+        // CLOCK: access sets reference bit, hand sweeps items clearing bits and picks the first item without one
+        kCLOCK
+    };
+
+    /**
+     * Creates new policy of the given type
+     */
+    static std::unique_ptr<EvictionPolicy> Create(Type type);
+
+    /**
+     * Parses name of the policy as given in command line, throws std::invalid_argument if there is
+     * no such policy
+     */
+    static Type FromName(const std::string &name);
+
+    virtual ~EvictionPolicy() {}
+
+    /**
+     * New item has been added into storage
+     */
+    virtual void Insert(PolicyHook &hook) = 0;
+
+    /**
+     * Item has been read or updated
+     */
+    virtual void Access(PolicyHook &hook) = 0;
+
+    /**
+     * Item has been read by one of the threads that share the storage for reading. Call must be safe against
+     * the same calls from other threads, but nothing else runs meanwhile. Policy that can't note access that
+     * way ignores it
+     */
+    virtual void SharedAccess(PolicyHook &hook) {}
+
+    /**
+     * Item has been removed from storage
+     */
+    virtual void Erase(PolicyHook &hook) = 0;
+
+    /**
+     * Returns item that should be evicted next, nullptr if there are no items
+     */
+    virtual PolicyHook *Victim() = 0;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_EVICTION_POLICY_H
@@ -0,0 +1,198 @@
+#include "FlatCombinedLRU.h"
+
+namespace Afina {
+namespace Backend {
+
+// See FlatCombinedLRU.h
+FlatCombinedLRU::FlatCombinedLRU(size_t max_size, EvictionPolicy::Type policy)
+    : _storage(max_size, policy),
+      _combiner([this](Request *const *requests, size_t count) { apply(requests, count); }) {}
+
+// See FlatCombinedLRU.h
+void FlatCombinedLRU::Start() {
+    _reaper.Start([this](size_t batch) { return run(Request::Type::kReap, nullptr, nullptr, batch); });
+}
+
+// See FlatCombinedLRU.h
+void FlatCombinedLRU::Stop() { _reaper.Stop(); }
+
+// See FlatCombinedLRU.h
+bool FlatCombinedLRU::Put(const std::string &key, const std::string &value) {
+    return run(Request::Type::kPut, &key, &value);
+}
+
+// See FlatCombinedLRU.h
+bool FlatCombinedLRU::PutIfAbsent(const std::string &key, const std::string &value) {
+    return run(Request::Type::kPutIfAbsent, &key, &value);
+}
+
+// See FlatCombinedLRU.h
+bool FlatCombinedLRU::Set(const std::string &key, const std::string &value) {
+    return run(Request::Type::kSet, &key, &value);
+}
+
+// See FlatCombinedLRU.h
+bool FlatCombinedLRU::Put(const std::string &key, const std::string &value, uint32_t flags, int32_t expire) {
+    return run(Request::Type::kPut, &key, &value, flags, expire);
+}
+
+// See FlatCombinedLRU.h
+bool FlatCombinedLRU::PutIfAbsent(const std::string &key, const std::string &value, uint32_t flags,
+                                  int32_t expire) {
+    return run(Request::Type::kPutIfAbsent, &key, &value, flags, expire);
+}
+
+// See FlatCombinedLRU.h
+bool FlatCombinedLRU::Set(const std::string &key, const std::string &value, uint32_t flags, int32_t expire) {
+    return run(Request::Type::kSet, &key, &value, flags, expire);
+}
+
+// See FlatCombinedLRU.h
+Storage::CasResult FlatCombinedLRU::CompareAndSet(const std::string &key, const std::string &value, uint32_t flags,
+                                                  int32_t expire, uint64_t cas) {
+    Request request = Request();
+    request.type = Request::Type::kCompareAndSet;
+    request.key = &key;
+    request.value = &value;
+    request.flags = flags;
+    request.expire = expire;
+    request.cas = cas;
+    execute(request);
+    return static_cast<CasResult>(request.result);
+}
+
+// See FlatCombinedLRU.h
+bool FlatCombinedLRU::Modify(const std::string &key, const ModifyCallback &modify) {
+    Request request = Request();
+    request.type = Request::Type::kModify;
+    request.key = &key;
+    request.modify = &modify;
+    execute(request);
+    return request.result != 0;
+}
+
+// See FlatCombinedLRU.h
+bool FlatCombinedLRU::Touch(const std::string &key, int32_t expire, ValueRef *value, ItemMeta *meta) {
+    Request request = Request();
+    request.type = Request::Type::kTouch;
+    request.key = &key;
+    request.expire = expire;
+    request.ref = value;
+    request.meta = meta;
+    execute(request);
+    return request.result != 0;
+}
+
+// See FlatCombinedLRU.h
+bool FlatCombinedLRU::Delete(const std::string &key) { return run(Request::Type::kDelete, &key); }
+
+// See FlatCombinedLRU.h
+bool FlatCombinedLRU::Get(const std::string &key, std::string &value) {
+    ItemMeta meta;
+    return Get(key, value, meta);
+}
+
+// See FlatCombinedLRU.h
+bool FlatCombinedLRU::Get(const std::string &key, std::string &value, ItemMeta &meta) {
+    Request request = Request();
+    request.type = Request::Type::kGet;
+    request.key = &key;
+    request.copy = &value;
+    request.meta = &meta;
+    execute(request);
+    return request.result != 0;
+}
+
+// See FlatCombinedLRU.h
+bool FlatCombinedLRU::Get(const std::string &key, ValueRef &value, ItemMeta &meta) {
+    Request request = Request();
+    request.type = Request::Type::kGetRef;
+    request.key = &key;
+    request.ref = &value;
+    request.meta = &meta;
+    execute(request);
+    return request.result != 0;
+}
+
+// See FlatCombinedLRU.h
+void FlatCombinedLRU::MultiGet(const std::string *keys, size_t count, const MultiGetCallback &found) {
+    Request request = Request();
+    request.type = Request::Type::kMultiGet;
+    request.key = keys;
+    request.count = count;
+    request.found = &found;
+    execute(request);
+}
+
+size_t FlatCombinedLRU::run(Request::Type type, const std::string *key, const std::string *value, uint32_t flags,
+                            int32_t expire) {
+    Request request = Request();
+    request.type = type;
+    request.key = key;
+    request.value = value;
+    request.flags = flags;
+    request.expire = expire;
+    execute(request);
+    return request.result;
+}
+
+void FlatCombinedLRU::execute(Request &request) {
+    _combiner.Execute(request);
+    if (request.error) {
+        std::rethrow_exception(request.error);
+    }
+}
+
+void FlatCombinedLRU::apply(Request *const *requests, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        Request &r = *requests[i];
+        // Failure of one request, e.g. bad_alloc or throwing callback, must not fail the rest of the batch
+        try {
+            apply(r);
+        } catch (...) {
+            r.error = std::current_exception();
+        }
+    }
+}
+
+void FlatCombinedLRU::apply(Request &r) {
+    switch (r.type) {
+    case Request::Type::kPut:
+        r.result = _storage.Put(*r.key, *r.value, r.flags, r.expire);
+        break;
+    case Request::Type::kPutIfAbsent:
+        r.result = _storage.PutIfAbsent(*r.key, *r.value, r.flags, r.expire);
+        break;
+    case Request::Type::kSet:
+        r.result = _storage.Set(*r.key, *r.value, r.flags, r.expire);
+        break;
+    case Request::Type::kCompareAndSet:
+        r.result = static_cast<size_t>(_storage.CompareAndSet(*r.key, *r.value, r.flags, r.expire, r.cas));
+        break;
+    case Request::Type::kModify:
+        r.result = _storage.Modify(*r.key, *r.modify);
+        break;
+    case Request::Type::kTouch:
+        r.result = _storage.Touch(*r.key, r.expire, r.ref, r.meta);
+        break;
+    case Request::Type::kDelete:
+        r.result = _storage.Delete(*r.key);
+        break;
+    case Request::Type::kGet:
+        r.result = _storage.Get(*r.key, *r.copy, *r.meta);
+        break;
+    case Request::Type::kGetRef:
+        r.result = _storage.Get(*r.key, *r.ref, *r.meta);
+        break;
+    case Request::Type::kMultiGet:
+        _storage.MultiGet(r.key, r.count, *r.found);
+        break;
+    case Request::Type::kReap:
+        // Batch size comes in flags
+        r.result = _storage.Reap(r.flags);
+        break;
+    }
+}
+
+} // namespace Backend
+} // namespace Afina
@@ -0,0 +1,143 @@
+#ifndef AFINA_STORAGE_FLAT_COMBINED_LRU_H
+#define AFINA_STORAGE_FLAT_COMBINED_LRU_H
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <string>
+
+#include <afina/Storage.h>
+#include <afina/concurrency/FlatCombine.h>
+
+#include "Reaper.h"
+#include "SimpleLRU.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # SimpleLRU behind flat combining
+ * Same as ThreadSafeSimplLRU, every operation is applied to a single SimpleLRU one at a time, but instead of
+ * fighting for the mutex threads publish operations and one of them applies the whole batch. Under heavy
+ * contention LRU list, index and allocator stay in the cache of the combiner. Without contention every
+ * operation is a batch of one and costs a bit more than the mutex does.
+ */
+class FlatCombinedLRU : public Afina::Storage {
+public:
+    FlatCombinedLRU(size_t max_size = 1024, EvictionPolicy::Type policy = EvictionPolicy::Type::kLRU);
+    ~FlatCombinedLRU() {}
+
+    // Starts background reaping of expired items
+    void Start() override;
+
+    // Stops background reaping
+    void Stop() override;
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value, uint32_t flags, int32_t expire) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t flags, int32_t expire) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value, uint32_t flags, int32_t expire) override;
+
+    // Implements Afina::Storage interface
+    CasResult CompareAndSet(const std::string &key, const std::string &value, uint32_t flags, int32_t expire,
+                            uint64_t cas) override;
+
+    // Implements Afina::Storage interface
+    bool Modify(const std::string &key, const ModifyCallback &modify) override;
+
+    // Implements Afina::Storage interface
+    bool Touch(const std::string &key, int32_t expire, ValueRef *value, ItemMeta *meta) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value, ItemMeta &meta) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, ValueRef &value, ItemMeta &meta) override;
+
+    // Implements Afina::Storage interface, whole batch is a single operation. Callback runs on the thread
+    // that combines, which is not necessarily the calling one
+    void MultiGet(const std::string *keys, size_t count, const MultiGetCallback &found) override;
+
+private:
+    // Operation published by the client thread, lives on its stack
+    struct Request {
+        enum class Type {
+            kPut,
+            kPutIfAbsent,
+            kSet,
+            kCompareAndSet,
+            kModify,
+            kTouch,
+            kDelete,
+            kGet,
+            kGetRef,
+            kMultiGet,
+            kReap
+        };
+
+        Type type;
+        const std::string *key;
+        const std::string *value;
+        uint32_t flags;
+        int32_t expire;
+        uint64_t cas;
+        const ModifyCallback *modify;
+
+        // Outputs, only the ones of the type are set
+        std::string *copy;
+        ValueRef *ref;
+        ItemMeta *meta;
+
+        // Batch of MultiGet
+        size_t count;
+        const MultiGetCallback *found;
+
+        // Result of the operation, number of items for kReap and CasResult for kCompareAndSet
+        size_t result;
+
+        // Thrown while applying, rethrown to the publisher only
+        std::exception_ptr error;
+    };
+
+    // Builds request of the given type and runs it through combiner, returns its result
+    size_t run(Request::Type type, const std::string *key, const std::string *value = nullptr, uint32_t flags = 0,
+               int32_t expire = 0);
+
+    // Runs request through combiner, rethrows what applying it has thrown
+    void execute(Request &request);
+
+    // Applies batch of requests, runs in combiner thread
+    void apply(Request *const *requests, size_t count);
+
+    // Applies single request of the batch
+    void apply(Request &request);
+
+    SimpleLRU _storage;
+    Concurrency::FlatCombine<Request> _combiner;
+
+    Reaper _reaper;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_FLAT_COMBINED_LRU_H
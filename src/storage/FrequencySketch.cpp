@@ -0,0 +1,87 @@
+#include "FrequencySketch.h"
+
+namespace Afina {
+namespace Backend {
+
+namespace {
+
+// Every nibble keeps its 3 lower bits, so that shift right halves each counter
+const uint64_t kResetMask = 0x7777777777777777ULL;
+
+// Seeds of the row hashes
+const uint64_t kSeeds[4] = {0xc3a5c85c97cb3127ULL, 0xb492b66fbe98f273ULL, 0x9ae16a3b2f90404fULL,
+                            0xcbf29ce484222325ULL};
+
+} // namespace
+
+// See FrequencySketch.h
+FrequencySketch::FrequencySketch(size_t capacity) : _additions(0) {
+    // Each word keeps counters of a couple of keys
+    size_t words = 8;
+    while (words * 2 < capacity) {
+        words <<= 1;
+    }
+    _table.resize(words, 0);
+    _mask = words - 1;
+    _sample_size = 10 * (capacity > words ? capacity : words);
+}
+
+// See FrequencySketch.h
+void FrequencySketch::Increment(uint64_t hash) {
+    size_t words[4];
+    uint32_t offsets[4];
+    locate(hash, words, offsets);
+
+    bool added = false;
+    for (uint32_t i = 0; i < 4; i++) {
+        uint64_t &word = _table[words[i]];
+        if (((word >> offsets[i]) & 0xF) != 0xF) {
+            word += uint64_t(1) << offsets[i];
+            added = true;
+        }
+    }
+
+    if (added && ++_additions == _sample_size) {
+        reset();
+    }
+}
+
+// See FrequencySketch.h
+uint32_t FrequencySketch::Frequency(uint64_t hash) const {
+    size_t words[4];
+    uint32_t offsets[4];
+    locate(hash, words, offsets);
+
+    uint32_t frequency = 0xF;
+    for (uint32_t i = 0; i < 4; i++) {
+        uint32_t count = (_table[words[i]] >> offsets[i]) & 0xF;
+        if (count < frequency) {
+            frequency = count;
+        }
+    }
+    return frequency;
+}
+
+void FrequencySketch::locate(uint64_t hash, size_t words[4], uint32_t offsets[4]) const {
+    // Spread bits so that weak hashes still hit all of the words
+    uint64_t spread = hash * 0x9E3779B97F4A7C15ULL;
+    spread ^= spread >> 29;
+
+    // Row i takes one of four counters in the i-th quarter of its word
+    for (uint32_t i = 0; i < 4; i++) {
+        uint64_t h = (spread + kSeeds[i]) * kSeeds[i];
+        h ^= h >> 32;
+        words[i] = h & _mask;
+        offsets[i] = (i * 4 + ((h >> 60) & 3)) * 4;
+    }
+}
+
+void FrequencySketch::reset() {
+    for (auto &word : _table) {
+        word = (word >> 1) & kResetMask;
+    }
+    _additions /= 2;
+}
+
+} // namespace Backend
+} // namespace Afina
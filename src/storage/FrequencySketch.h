@@ -0,0 +1,54 @@
+#ifndef AFINA_STORAGE_FREQUENCY_SKETCH_H
+#define AFINA_STORAGE_FREQUENCY_SKETCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Count-min sketch of access frequencies
+ * Estimates how many times key has been seen recently. There are four rows of 4 bits counters packed
+ * into 64 bits words, each word keeps four counters of every row. Every row hashes key with its own
+ * seed to pick a word and a counter there, so keys colliding in one row rarely collide in the others.
+ * Estimate is the minimum of four counters, the whole sketch takes about 4 bytes per expected key.
+ *
+ * Aging: once number of increments reaches 10 times of capacity all counters are halved, so the
+ * sketch follows popularity changes and old hits fade out.
+ *
+ * That is NOT thread safe implementation!!
+ */
+class FrequencySketch {
+public:
+    explicit FrequencySketch(size_t capacity);
+
+    /**
+     * Counts one more access of key with given hash
+     */
+    void Increment(uint64_t hash);
+
+    /**
+     * Returns estimated number of accesses of key with given hash, at most 15
+     */
+    uint32_t Frequency(uint64_t hash) const;
+
+private:
+    // Words of the table and bit offsets in them of the key counters, one per row
+    void locate(uint64_t hash, size_t words[4], uint32_t offsets[4]) const;
+
+    void reset();
+
+    std::vector<uint64_t> _table;
+    size_t _mask;
+
+    // Increments since the last reset and their limit
+    size_t _additions;
+    size_t _sample_size;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_FREQUENCY_SKETCH_H
@@ -0,0 +1,180 @@
+#ifndef AFINA_STORAGE_HASH_INDEX_H
+#define AFINA_STORAGE_HASH_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Open addressing index
+ * Robin Hood hash table that maps keys to the intrusive nodes of the storage. Table doesn't own
+ * nodes and doesn't keep keys: each slot holds pointer to the node, 32 bits of key hash and distance
+ * from the slot hash points to. Hash is checked before key comparison, so a lookup usually touches a
+ * single cache line of slots and one node.
+ *
+ * KeyEqual must be callable as bool(const Node &, const std::string &) and compare key stored
+ * in the node with the given one.
+ *
+ * That is NOT thread safe implementation!!
+ */
+template <typename Node, typename KeyEqual> class HashIndex {
+public:
+    explicit HashIndex(size_t capacity = 16) : _size(0) {
+        size_t n = 16;
+        while (n < capacity) {
+            n <<= 1;
+        }
+        _slots.resize(n);
+    }
+
+    /**
+     * Hash function nodes must be indexed by
+     */
+    static uint32_t Hash(const std::string &key) { return static_cast<uint32_t>(std::hash<std::string>()(key)); }
+
+    /**
+     * Returns node associated with the given key or nullptr if there is no such
+     */
+    Node *Find(uint32_t hash, const std::string &key) const {
+        size_t mask = _slots.size() - 1;
+        size_t pos = hash & mask;
+        for (uint32_t dist = 1;; dist++, pos = (pos + 1) & mask) {
+            const Slot &slot = _slots[pos];
+            // Empty slot or slot of the "richer" key: robin hood invariant says there is no such key further
+            if (slot.dist < dist) {
+                return nullptr;
+            }
+            if (slot.hash == hash && _equal(*slot.node, key)) {
+                return slot.node;
+            }
+        }
+    }
+
+    /**
+     * Hints CPU to bring home slot of the given hash into cache, so that lookup issued a bit later
+     * doesn't stall on it. Batched lookups hash a few keys ahead and prefetch their slots
+     */
+    void Prefetch(uint32_t hash) const { __builtin_prefetch(&_slots[hash & (_slots.size() - 1)]); }
+
+    /**
+     * Adds node into the index. Caller must guarantee that node's key isn't present yet
+     */
+    void Insert(uint32_t hash, Node *node) {
+        if ((_size + 1) * 8 > _slots.size() * 7) {
+            rehash(_slots.size() * 2);
+        }
+        place(Slot{node, hash, 1});
+        _size++;
+    }
+
+    /**
+     * Points index entry of the given node to its new location, returns false if node wasn't indexed
+     */
+    bool Replace(uint32_t hash, const Node *node, Node *moved) {
+        Slot *slot = lookup(hash, node);
+        if (slot == nullptr) {
+            return false;
+        }
+        slot->node = moved;
+        return true;
+    }
+
+    /**
+     * Removes exactly given node from index, returns false if it wasn't indexed
+     */
+    bool Erase(uint32_t hash, const Node *node) {
+        Slot *slot = lookup(hash, node);
+        if (slot == nullptr) {
+            return false;
+        }
+
+        // Backward shift: pull following slots one step closer to their home
+        size_t mask = _slots.size() - 1;
+        size_t pos = slot - &_slots[0];
+        size_t next = (pos + 1) & mask;
+        while (_slots[next].dist > 1) {
+            _slots[pos] = _slots[next];
+            _slots[pos].dist--;
+            pos = next;
+            next = (next + 1) & mask;
+        }
+        _slots[pos] = Slot();
+        _size--;
+        return true;
+    }
+
+    void Clear() {
+        for (auto &slot : _slots) {
+            slot = Slot();
+        }
+        _size = 0;
+    }
+
+    size_t Size() const { return _size; }
+
+private:
+    struct Slot {
+        Node *node = nullptr;
+        uint32_t hash = 0;
+
+        // Distance from home slot plus one, 0 means empty slot
+        uint32_t dist = 0;
+
+        Slot() {}
+        Slot(Node *n, uint32_t h, uint32_t d) : node(n), hash(h), dist(d) {}
+    };
+
+    Slot *lookup(uint32_t hash, const Node *node) {
+        size_t mask = _slots.size() - 1;
+        size_t pos = hash & mask;
+        for (uint32_t dist = 1;; dist++, pos = (pos + 1) & mask) {
+            Slot &slot = _slots[pos];
+            if (slot.dist < dist) {
+                return nullptr;
+            }
+            if (slot.node == node) {
+                return &slot;
+            }
+        }
+    }
+
+    void place(Slot slot) {
+        size_t mask = _slots.size() - 1;
+        for (size_t pos = slot.hash & mask;; pos = (pos + 1) & mask, slot.dist++) {
+            if (_slots[pos].dist == 0) {
+                _slots[pos] = slot;
+                return;
+            }
+            // Take the place from the key that is closer to its home than we are
+            if (_slots[pos].dist < slot.dist) {
+                std::swap(_slots[pos], slot);
+            }
+        }
+    }
+
+    void rehash(size_t capacity) {
+        std::vector<Slot> old(capacity);
+        std::swap(old, _slots);
+        for (auto &slot : old) {
+            if (slot.dist != 0) {
+                slot.dist = 1;
+                place(slot);
+            }
+        }
+    }
+
+    std::vector<Slot> _slots;
+    size_t _size;
+    KeyEqual _equal;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_HASH_INDEX_H
@@ -0,0 +1,30 @@
+#include "LRUPolicy.h"
+
+namespace Afina {
+namespace Backend {
+
+// See LRUPolicy.h
+void LRUPolicy::Insert(PolicyHook &hook) {
+    hook.prev = _list.prev;
+    hook.next = &_list;
+    _list.prev->next = &hook;
+    _list.prev = &hook;
+}
+
+// See LRUPolicy.h
+void LRUPolicy::Access(PolicyHook &hook) {
+    Erase(hook);
+    Insert(hook);
+}
+
+// See LRUPolicy.h
+void LRUPolicy::Erase(PolicyHook &hook) {
+    hook.prev->next = hook.next;
+    hook.next->prev = hook.prev;
+}
+
+// See LRUPolicy.h
+PolicyHook *LRUPolicy::Victim() { return _list.next == &_list ? nullptr : _list.next; }
+
+} // namespace Backend
+} // namespace Afina
@@ -0,0 +1,40 @@
+#ifndef AFINA_STORAGE_LRU_POLICY_H
+#define AFINA_STORAGE_LRU_POLICY_H
+
+#include "EvictionPolicy.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # LRU eviction
+ * Items are ordered in the circular list by "freshness": next to the sentinel is the item that
+ * wasn't used for the longest time, access moves item to the tail.
+ */
+class LRUPolicy : public EvictionPolicy {
+public:
+    LRUPolicy() {
+        _list.prev = &_list;
+        _list.next = &_list;
+    }
+
+    // Implements EvictionPolicy interface
+    void Insert(PolicyHook &hook) override;
+
+    // Implements EvictionPolicy interface
+    void Access(PolicyHook &hook) override;
+
+    // Implements EvictionPolicy interface
+    void Erase(PolicyHook &hook) override;
+
+    // Implements EvictionPolicy interface
+    PolicyHook *Victim() override;
+
+private:
+    PolicyHook _list;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_LRU_POLICY_H
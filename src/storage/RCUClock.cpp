@@ -0,0 +1,441 @@
+#include "RCUClock.h"
+
+#include "TimerWheel.h"
+
+#include <cstring>
+#include <functional>
+#include <new>
+
+namespace Afina {
+namespace Backend {
+
+namespace {
+
+uint32_t hash_of(const std::string &key) { return static_cast<uint32_t>(std::hash<std::string>()(key)); }
+
+} // namespace
+
+RCUClock::Table::Table(size_t capacity) : mask(capacity - 1), slots(new std::atomic<Item *>[capacity]) {
+    for (size_t i = 0; i < capacity; i++) {
+        slots[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+RCUClock::Table::~Table() { delete[] slots; }
+
+RCUClock::RCUClock(size_t max_size)
+    : _max_size(max_size), _table(new Table(capacity_for(0))), _cur_size(0), _items(0), _tombstones(0), _hand(0),
+      _reap_cursor(0), _next_cas(1) {}
+
+RCUClock::~RCUClock() {
+    Table *table = _table.load();
+    for (size_t i = 0; i <= table->mask; i++) {
+        Item *item = table->slots[i].load();
+        if (item != nullptr && item != tombstone()) {
+            release_item(item);
+        }
+    }
+    delete table;
+}
+
+// See MapBasedGlobalLockImpl.h
+bool RCUClock::Put(const std::string &key, const std::string &value) { return store(key, value, 0, 0, true, true); }
+
+// See MapBasedGlobalLockImpl.h
+bool RCUClock::PutIfAbsent(const std::string &key, const std::string &value) {
+    return store(key, value, 0, 0, true, false);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool RCUClock::Set(const std::string &key, const std::string &value) { return store(key, value, 0, 0, false, true); }
+
+// See MapBasedGlobalLockImpl.h
+bool RCUClock::Put(const std::string &key, const std::string &value, uint32_t flags, int32_t expire) {
+    return store(key, value, flags, expire, true, true);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool RCUClock::PutIfAbsent(const std::string &key, const std::string &value, uint32_t flags, int32_t expire) {
+    return store(key, value, flags, expire, true, false);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool RCUClock::Set(const std::string &key, const std::string &value, uint32_t flags, int32_t expire) {
+    return store(key, value, flags, expire, false, true);
+}
+
+// See RCUClock.h
+Storage::CasResult RCUClock::CompareAndSet(const std::string &key, const std::string &value, uint32_t flags,
+                                           int32_t expire, uint64_t cas) {
+    uint32_t hash = hash_of(key);
+    uint32_t now = UnixTime();
+    size_t pos = 0;
+    std::lock_guard<std::mutex> lock(_write_lock);
+    Item *item = find(hash, key, now, pos);
+    if (item == nullptr) {
+        return CasResult::kNotFound;
+    }
+    if (item->cas != cas) {
+        return CasResult::kExists;
+    }
+    return store_locked(hash, key, value, flags, ExpirationTime(expire, now), now, false, true)
+               ? CasResult::kStored
+               : CasResult::kNotStored;
+}
+
+// See RCUClock.h
+bool RCUClock::Modify(const std::string &key, const ModifyCallback &modify) {
+    uint32_t hash = hash_of(key);
+    uint32_t now = UnixTime();
+    size_t pos = 0;
+    std::lock_guard<std::mutex> lock(_write_lock);
+    Item *item = find(hash, key, now, pos);
+    if (item == nullptr) {
+        return false;
+    }
+
+    std::string value(item->value(), item->value_size);
+    if (!modify(value)) {
+        return true;
+    }
+    return store_locked(hash, key, value, item->flags, item->deadline, now, false, true);
+}
+
+// See RCUClock.h
+bool RCUClock::Touch(const std::string &key, int32_t expire, ValueRef *value, ItemMeta *meta) {
+    uint32_t hash = hash_of(key);
+    uint32_t now = UnixTime();
+    size_t pos = 0;
+    std::lock_guard<std::mutex> lock(_write_lock);
+    Item *item = find(hash, key, now, pos);
+    if (item == nullptr) {
+        return false;
+    }
+
+    // Items are immutable, so the copy with the new expiration time and the same version replaces it
+    uint32_t deadline = ExpirationTime(expire, now);
+    Item *touched = item;
+    if (deadline == 0 || deadline > now) {
+        touched = make_item(hash, key, std::string(item->value(), item->value_size), item->flags, deadline);
+        touched->cas = item->cas;
+        Table *table = _table.load(std::memory_order_relaxed);
+        table->slots[pos].store(touched, std::memory_order_release);
+        _epoch.Retire(item, release_item);
+    }
+
+    // Item is alive while we hold the lock, whichever one it is
+    if (value != nullptr) {
+        touched->refs.fetch_add(1, std::memory_order_relaxed);
+        *value = ValueRef(touched->value(), touched->value_size, touched, release_item);
+    }
+    if (meta != nullptr) {
+        *meta = meta_of(touched);
+        meta->deadline = deadline;
+    }
+    if (touched == item) {
+        erase_slot(pos);
+    }
+    return true;
+}
+
+// See MapBasedGlobalLockImpl.h
+bool RCUClock::Delete(const std::string &key) {
+    uint32_t hash = hash_of(key);
+
+    std::lock_guard<std::mutex> lock(_write_lock);
+    Table *table = _table.load(std::memory_order_relaxed);
+    for (size_t pos = hash & table->mask;; pos = (pos + 1) & table->mask) {
+        Item *item = table->slots[pos].load(std::memory_order_relaxed);
+        if (item == nullptr) {
+            return false;
+        }
+        if (item != tombstone() && item->hash == hash && item->key_size == key.size() &&
+            std::memcmp(item->key(), key.data(), key.size()) == 0) {
+            bool expired = is_expired(item, UnixTime());
+            erase_slot(pos);
+            return !expired;
+        }
+    }
+}
+
+// See MapBasedGlobalLockImpl.h
+bool RCUClock::Get(const std::string &key, std::string &value) {
+    ItemMeta meta;
+    return Get(key, value, meta);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool RCUClock::Get(const std::string &key, std::string &value, ItemMeta &meta) {
+    Concurrency::Epoch::Guard guard = _epoch.Enter();
+    Item *item = lookup(key);
+    if (item == nullptr) {
+        return false;
+    }
+
+    value.assign(item->value(), item->value_size);
+    meta = meta_of(item);
+    return true;
+}
+
+// See MapBasedGlobalLockImpl.h
+bool RCUClock::Get(const std::string &key, ValueRef &value, ItemMeta &meta) {
+    Concurrency::Epoch::Guard guard = _epoch.Enter();
+    Item *item = lookup(key);
+    if (item == nullptr) {
+        return false;
+    }
+
+    // Item can't be released while we are in the epoch, so it is safe to count one more reference
+    item->refs.fetch_add(1, std::memory_order_relaxed);
+    value = ValueRef(item->value(), item->value_size, item, release_item);
+    meta = meta_of(item);
+    return true;
+}
+
+// See RCUClock.h
+void RCUClock::MultiGet(const std::string *keys, size_t count, const MultiGetCallback &found) {
+    Concurrency::Epoch::Guard guard = _epoch.Enter();
+    ValueRef value;
+    for (size_t i = 0; i < count; i++) {
+        Item *item = lookup(keys[i]);
+        if (item == nullptr) {
+            continue;
+        }
+        item->refs.fetch_add(1, std::memory_order_relaxed);
+        value = ValueRef(item->value(), item->value_size, item, release_item);
+        found(i, value, meta_of(item));
+    }
+}
+
+RCUClock::Item *RCUClock::lookup(const std::string &key) {
+    uint32_t hash = hash_of(key);
+    Table *table = _table.load(std::memory_order_acquire);
+    for (size_t pos = hash & table->mask;; pos = (pos + 1) & table->mask) {
+        Item *item = table->slots[pos].load(std::memory_order_acquire);
+        if (item == nullptr) {
+            return nullptr;
+        }
+        if (item != tombstone() && item->hash == hash && item->key_size == key.size() &&
+            std::memcmp(item->key(), key.data(), key.size()) == 0) {
+            // Expired item stays in the table until some writer comes across it
+            if (item->deadline != 0 && is_expired(item, UnixTime())) {
+                return nullptr;
+            }
+
+            // Avoid writing into shared cache line when bit is there already
+            if (!item->referenced.load(std::memory_order_relaxed)) {
+                item->referenced.store(true, std::memory_order_relaxed);
+            }
+            return item;
+        }
+    }
+}
+
+RCUClock::Item *RCUClock::find(uint32_t hash, const std::string &key, uint32_t now, size_t &pos) {
+    Table *table = _table.load(std::memory_order_relaxed);
+    for (pos = hash & table->mask;; pos = (pos + 1) & table->mask) {
+        Item *item = table->slots[pos].load(std::memory_order_relaxed);
+        if (item == nullptr) {
+            return nullptr;
+        }
+        if (item != tombstone() && item->hash == hash && item->key_size == key.size() &&
+            std::memcmp(item->key(), key.data(), key.size()) == 0) {
+            return is_expired(item, now) ? nullptr : item;
+        }
+    }
+}
+
+bool RCUClock::store(const std::string &key, const std::string &value, uint32_t flags, int32_t expire, bool insert,
+                     bool update) {
+    uint32_t hash = hash_of(key);
+    uint32_t now = UnixTime();
+    std::lock_guard<std::mutex> lock(_write_lock);
+    return store_locked(hash, key, value, flags, ExpirationTime(expire, now), now, insert, update);
+}
+
+bool RCUClock::store_locked(uint32_t hash, const std::string &key, const std::string &value, uint32_t flags,
+                            uint32_t deadline, uint32_t now, bool insert, bool update) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+    reap(now);
+
+    // Keep at least half of the slots empty so that probes stay short
+    Table *table = _table.load(std::memory_order_relaxed);
+    if ((_items + _tombstones + 1) * 2 > table->mask + 1) {
+        rebuild(capacity_for(_items + 1));
+        table = _table.load(std::memory_order_relaxed);
+    }
+
+    size_t free_pos = table->mask + 1;
+    size_t pos = hash & table->mask;
+    Item *found = nullptr;
+    for (;; pos = (pos + 1) & table->mask) {
+        Item *item = table->slots[pos].load(std::memory_order_relaxed);
+        if (item == nullptr) {
+            break;
+        }
+        if (item == tombstone()) {
+            if (free_pos > table->mask) {
+                free_pos = pos;
+            }
+        } else if (item->hash == hash && item->key_size == key.size() &&
+                   std::memcmp(item->key(), key.data(), key.size()) == 0) {
+            found = item;
+            break;
+        }
+    }
+
+    // Expired item is the same as absent one, but its slot could be reused
+    bool present = found != nullptr && !is_expired(found, now);
+    if ((!present && !insert) || (present && !update)) {
+        if (found != nullptr && !present) {
+            erase_slot(pos);
+        }
+        return false;
+    }
+
+    // Stored and expired at once, so previous value is gone anyway
+    if (deadline != 0 && deadline <= now) {
+        if (found != nullptr) {
+            erase_slot(pos);
+        }
+        return true;
+    }
+
+    Item *fresh = make_item(hash, key, value, flags, deadline);
+    if (found != nullptr) {
+        _cur_size = _cur_size - found->value_size + value.size();
+        table->slots[pos].store(fresh, std::memory_order_release);
+        _epoch.Retire(found, release_item);
+    } else {
+        if (free_pos > table->mask) {
+            free_pos = pos;
+        } else {
+            _tombstones--;
+        }
+        _cur_size += key.size() + value.size();
+        _items++;
+        table->slots[free_pos].store(fresh, std::memory_order_release);
+    }
+
+    evict();
+    return true;
+}
+
+void RCUClock::evict() {
+    Table *table = _table.load(std::memory_order_relaxed);
+    uint32_t now = UnixTime();
+    while (_cur_size > _max_size) {
+        size_t pos = _hand++ & table->mask;
+        Item *item = table->slots[pos].load(std::memory_order_relaxed);
+        if (item == nullptr || item == tombstone()) {
+            continue;
+        }
+
+        // Second chance for items that were read since the last pass of the hand, expired ones go first
+        if (item->referenced.load(std::memory_order_relaxed) && !is_expired(item, now)) {
+            item->referenced.store(false, std::memory_order_relaxed);
+            continue;
+        }
+        erase_slot(pos);
+    }
+}
+
+void RCUClock::reap(uint32_t now) {
+    Table *table = _table.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < kReapPerOperation; i++) {
+        size_t pos = _reap_cursor++ & table->mask;
+        Item *item = table->slots[pos].load(std::memory_order_relaxed);
+        if (item != nullptr && item != tombstone() && is_expired(item, now)) {
+            erase_slot(pos);
+        }
+    }
+}
+
+void RCUClock::erase_slot(size_t pos) {
+    Table *table = _table.load(std::memory_order_relaxed);
+    Item *item = table->slots[pos].load(std::memory_order_relaxed);
+
+    // Nothing could be placed behind an empty slot, so the chain could be cut right here
+    if (table->slots[(pos + 1) & table->mask].load(std::memory_order_relaxed) == nullptr) {
+        table->slots[pos].store(nullptr, std::memory_order_release);
+    } else {
+        table->slots[pos].store(tombstone(), std::memory_order_release);
+        _tombstones++;
+    }
+
+    _cur_size -= item->key_size + item->value_size;
+    _items--;
+    _epoch.Retire(item, release_item);
+}
+
+void RCUClock::rebuild(size_t capacity) {
+    Table *old = _table.load(std::memory_order_relaxed);
+    Table *table = new Table(capacity);
+    for (size_t i = 0; i <= old->mask; i++) {
+        Item *item = old->slots[i].load(std::memory_order_relaxed);
+        if (item == nullptr || item == tombstone()) {
+            continue;
+        }
+
+        size_t pos = item->hash & table->mask;
+        while (table->slots[pos].load(std::memory_order_relaxed) != nullptr) {
+            pos = (pos + 1) & table->mask;
+        }
+        table->slots[pos].store(item, std::memory_order_relaxed);
+    }
+
+    // Items are shared by both tables, only the old array of slots goes away
+    _table.store(table, std::memory_order_release);
+    _epoch.Retire(old, free_table);
+    _tombstones = 0;
+    _hand = 0;
+    _reap_cursor = 0;
+}
+
+size_t RCUClock::capacity_for(size_t items) {
+    size_t capacity = 16;
+    while (capacity < items * 4) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+RCUClock::Item *RCUClock::make_item(uint32_t hash, const std::string &key, const std::string &value,
+                                     uint32_t flags, uint32_t deadline) {
+    char *memory = new char[sizeof(Item) + key.size() + value.size()];
+    Item *item = new (memory) Item;
+    item->hash = hash;
+    item->key_size = key.size();
+    item->value_size = value.size();
+    item->deadline = deadline;
+    item->flags = flags;
+    item->cas = _next_cas++;
+    item->referenced.store(true, std::memory_order_relaxed);
+    item->refs.store(1, std::memory_order_relaxed);
+    std::memcpy(item->data(), key.data(), key.size());
+    std::memcpy(item->data() + key.size(), value.data(), value.size());
+    return item;
+}
+
+void RCUClock::release_item(void *memory) {
+    Item *item = static_cast<Item *>(memory);
+    if (item->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        item->~Item();
+        delete[] static_cast<char *>(memory);
+    }
+}
+
+ItemMeta RCUClock::meta_of(const Item *item) {
+    ItemMeta meta;
+    meta.flags = item->flags;
+    meta.deadline = item->deadline;
+    meta.cas = item->cas;
+    return meta;
+}
+
+void RCUClock::free_table(void *table) { delete static_cast<Table *>(table); }
+
+} // namespace Backend
+} // namespace Afina
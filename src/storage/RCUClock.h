@@ -0,0 +1,171 @@
+#ifndef AFINA_STORAGE_RCU_CLOCK_H
+#define AFINA_STORAGE_RCU_CLOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include <afina/Storage.h>
+#include <afina/concurrency/Epoch.h>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Storage with lock free reads
+ * Items are immutable once published and live in the open addressing table of atomic pointers. Get
+ * never takes a lock: it pins itself into the current epoch, probes the table and copies value out.
+ * Writers are serialized by a mutex, replace items and tables by a single pointer store and retire old
+ * versions into the epoch so that memory is released only after all readers that could see it leave.
+ *
+ * Eviction is CLOCK over the table slots: Get sets reference bit of the item, writer that needs room
+ * sweeps the hand clearing bits and evicts the first item without one. So recency is approximated and
+ * a read never writes anything shared except that bit, and only if it isn't set yet.
+ *
+ * Budget is counted in key+value bytes.
+ *
+ * Expired items are invisible for readers, writers remove them: each write checks a few slots behind its
+ * own cursor and the hand evicts expired items first.
+ *
+ * Since items are immutable, Get could return reference right into the item instead of a copy. Such
+ * reference keeps the item alive after it is replaced or evicted, that memory is out of the budget.
+ */
+class RCUClock : public Afina::Storage {
+public:
+    explicit RCUClock(size_t max_size = 1024);
+    ~RCUClock();
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value, uint32_t flags, int32_t expire) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t flags, int32_t expire) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value, uint32_t flags, int32_t expire) override;
+
+    // Implements Afina::Storage interface
+    CasResult CompareAndSet(const std::string &key, const std::string &value, uint32_t flags, int32_t expire,
+                            uint64_t cas) override;
+
+    // Implements Afina::Storage interface
+    bool Modify(const std::string &key, const ModifyCallback &modify) override;
+
+    // Implements Afina::Storage interface
+    bool Touch(const std::string &key, int32_t expire, ValueRef *value, ItemMeta *meta) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value, ItemMeta &meta) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, ValueRef &value, ItemMeta &meta) override;
+
+    // Implements Afina::Storage interface, whole batch is read within a single epoch
+    void MultiGet(const std::string *keys, size_t count, const MultiGetCallback &found) override;
+
+private:
+    // Immutable key/value pair followed by key and value bytes
+    struct Item {
+        uint32_t hash;
+        uint32_t key_size;
+        uint32_t value_size;
+
+        // Absolute expiration time, 0 if item never expires
+        uint32_t deadline;
+
+        // Client flags and version of the item, see ItemMeta
+        uint32_t flags;
+        uint64_t cas;
+
+        // CLOCK reference bit
+        std::atomic<bool> referenced;
+
+        // One reference belongs to the table, others to ValueRefs given out by Get. Table drops its one
+        // once readers that could see the item leave the epoch
+        std::atomic<uint32_t> refs;
+
+        const char *key() const { return reinterpret_cast<const char *>(this + 1); }
+        const char *value() const { return key() + key_size; }
+        char *data() { return reinterpret_cast<char *>(this + 1); }
+    };
+
+    struct Table {
+        explicit Table(size_t capacity);
+        ~Table();
+
+        size_t mask;
+        std::atomic<Item *> *slots;
+    };
+
+    Item *make_item(uint32_t hash, const std::string &key, const std::string &value, uint32_t flags,
+                    uint32_t deadline);
+    static void release_item(void *item);
+    static ItemMeta meta_of(const Item *item);
+    static void free_table(void *table);
+
+    // Marks slot of the deleted item, so that probing goes on through it
+    static Item *tombstone() { return reinterpret_cast<Item *>(uintptr_t(1)); }
+
+    static bool is_expired(const Item *item, uint32_t now) { return item->deadline != 0 && item->deadline <= now; }
+
+    // Must be called within the epoch
+    Item *lookup(const std::string &key);
+
+    // Must be called under _write_lock, returns live item and its slot
+    Item *find(uint32_t hash, const std::string &key, uint32_t now, size_t &pos);
+
+    bool store(const std::string &key, const std::string &value, uint32_t flags, int32_t expire, bool insert,
+               bool update);
+
+    // Same as store, but must be called under _write_lock
+    bool store_locked(uint32_t hash, const std::string &key, const std::string &value, uint32_t flags,
+                      uint32_t deadline, uint32_t now, bool insert, bool update);
+    void evict();
+    void reap(uint32_t now);
+    void erase_slot(size_t pos);
+    void rebuild(size_t capacity);
+    static size_t capacity_for(size_t items);
+
+    // Maximum number of key+value bytes could be stored
+    const size_t _max_size;
+
+    // Current table, replaced as a whole on resize
+    std::atomic<Table *> _table;
+
+    // Serializes writers, readers never take it
+    std::mutex _write_lock;
+
+    // State below is guarded by _write_lock
+    size_t _cur_size;
+    size_t _items;
+    size_t _tombstones;
+    size_t _hand;
+    size_t _reap_cursor;
+    uint64_t _next_cas;
+
+    // Number of slots each write checks for expired items
+    static const size_t kReapPerOperation = 4;
+
+    Concurrency::Epoch _epoch;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_RCU_CLOCK_H
@@ -0,0 +1,44 @@
+#include "Reaper.h"
+
+namespace Afina {
+namespace Backend {
+
+// See Reaper.h
+void Reaper::Start(std::function<size_t(size_t batch)> step, size_t batch, std::chrono::milliseconds period) {
+    std::lock_guard<std::mutex> lock(_lock);
+    if (_running) {
+        return;
+    }
+
+    _running = true;
+    _thread = std::thread(&Reaper::run, this, std::move(step), batch, period);
+}
+
+// See Reaper.h
+void Reaper::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _running = false;
+    }
+    _stop.notify_all();
+
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+void Reaper::run(std::function<size_t(size_t batch)> step, size_t batch, std::chrono::milliseconds period) {
+    std::unique_lock<std::mutex> lock(_lock);
+    while (_running) {
+        lock.unlock();
+        size_t reaped = step(batch);
+        lock.lock();
+
+        if (reaped < batch) {
+            _stop.wait_for(lock, period, [this] { return !_running; });
+        }
+    }
+}
+
+} // namespace Backend
+} // namespace Afina
@@ -0,0 +1,50 @@
+#ifndef AFINA_STORAGE_REAPER_H
+#define AFINA_STORAGE_REAPER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Background reaping of expired items
+ * Runs step in a dedicated thread. Step removes a batch of expired items and returns how many of them it
+ * has removed: full batch means there is more work, so the next step follows right away, otherwise
+ * thread sleeps for a period. Step is expected to hold storage locks for a single batch only, so that
+ * clients never wait for the whole storm of expirations.
+ */
+class Reaper {
+public:
+    Reaper() : _running(false) {}
+    ~Reaper() { Stop(); }
+
+    /**
+     * Starts background thread, does nothing if it is running already
+     */
+    void Start(std::function<size_t(size_t batch)> step, size_t batch = 64,
+               std::chrono::milliseconds period = std::chrono::milliseconds(250));
+
+    /**
+     * Stops background thread and waits for it
+     */
+    void Stop();
+
+private:
+    void run(std::function<size_t(size_t batch)> step, size_t batch, std::chrono::milliseconds period);
+
+    std::thread _thread;
+
+    std::mutex _lock;
+    std::condition_variable _stop;
+    bool _running;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_REAPER_H
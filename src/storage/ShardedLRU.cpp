@@ -0,0 +1,193 @@
+#include "ShardedLRU.h"
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+namespace Afina {
+namespace Backend {
+
+// See ShardedLRU.h
+ShardedLRU::ShardedLRU(size_t max_size, size_t n_shards, EvictionPolicy::Type policy) {
+    if (n_shards == 0) {
+        throw std::invalid_argument("Number of shards must be positive");
+    }
+    if (max_size / n_shards < SimpleLRU::kMinSize) {
+        throw std::invalid_argument(std::to_string(n_shards) + " shards need at least " +
+                                    std::to_string(n_shards * SimpleLRU::kMinSize) + " bytes of memory");
+    }
+
+    // Split budget so that sum of all shards is exactly max_size
+    _shards.reserve(n_shards);
+    for (size_t i = 0; i < n_shards; i++) {
+        size_t shard_size = max_size / n_shards + (i < max_size % n_shards ? 1 : 0);
+        _shards.emplace_back(new Shard(shard_size, policy));
+    }
+}
+
+// See ShardedLRU.h
+void ShardedLRU::Start() {
+    _reaper.Start([this](size_t batch) {
+        // Any shard with a full batch has more to reap
+        bool more = false;
+        for (auto &shard : _shards) {
+            std::lock_guard<std::mutex> l(shard->lock);
+            more |= shard->storage.Reap(batch) == batch;
+        }
+        return more ? batch : size_t(0);
+    });
+}
+
+// See ShardedLRU.h
+void ShardedLRU::Stop() { _reaper.Stop(); }
+
+// See ShardedLRU.h
+bool ShardedLRU::Put(const std::string &key, const std::string &value) {
+    Shard &shard = shard_for(key);
+    std::lock_guard<std::mutex> l(shard.lock);
+    return shard.storage.Put(key, value);
+}
+
+// See ShardedLRU.h
+bool ShardedLRU::PutIfAbsent(const std::string &key, const std::string &value) {
+    Shard &shard = shard_for(key);
+    std::lock_guard<std::mutex> l(shard.lock);
+    return shard.storage.PutIfAbsent(key, value);
+}
+
+// See ShardedLRU.h
+bool ShardedLRU::Set(const std::string &key, const std::string &value) {
+    Shard &shard = shard_for(key);
+    std::lock_guard<std::mutex> l(shard.lock);
+    return shard.storage.Set(key, value);
+}
+
+// See ShardedLRU.h
+bool ShardedLRU::Put(const std::string &key, const std::string &value, uint32_t flags, int32_t expire) {
+    Shard &shard = shard_for(key);
+    std::lock_guard<std::mutex> l(shard.lock);
+    return shard.storage.Put(key, value, flags, expire);
+}
+
+// See ShardedLRU.h
+bool ShardedLRU::PutIfAbsent(const std::string &key, const std::string &value, uint32_t flags, int32_t expire) {
+    Shard &shard = shard_for(key);
+    std::lock_guard<std::mutex> l(shard.lock);
+    return shard.storage.PutIfAbsent(key, value, flags, expire);
+}
+
+// See ShardedLRU.h
+bool ShardedLRU::Set(const std::string &key, const std::string &value, uint32_t flags, int32_t expire) {
+    Shard &shard = shard_for(key);
+    std::lock_guard<std::mutex> l(shard.lock);
+    return shard.storage.Set(key, value, flags, expire);
+}
+
+// See ShardedLRU.h
+Storage::CasResult ShardedLRU::CompareAndSet(const std::string &key, const std::string &value, uint32_t flags,
+                                             int32_t expire, uint64_t cas) {
+    Shard &shard = shard_for(key);
+    std::lock_guard<std::mutex> l(shard.lock);
+    return shard.storage.CompareAndSet(key, value, flags, expire, cas);
+}
+
+// See ShardedLRU.h
+bool ShardedLRU::Modify(const std::string &key, const ModifyCallback &modify) {
+    Shard &shard = shard_for(key);
+    std::lock_guard<std::mutex> l(shard.lock);
+    return shard.storage.Modify(key, modify);
+}
+
+// See ShardedLRU.h
+bool ShardedLRU::Touch(const std::string &key, int32_t expire, ValueRef *value, ItemMeta *meta) {
+    Shard &shard = shard_for(key);
+    std::lock_guard<std::mutex> l(shard.lock);
+    return shard.storage.Touch(key, expire, value, meta);
+}
+
+// See ShardedLRU.h
+bool ShardedLRU::Delete(const std::string &key) {
+    Shard &shard = shard_for(key);
+    std::lock_guard<std::mutex> l(shard.lock);
+    return shard.storage.Delete(key);
+}
+
+// See ShardedLRU.h
+bool ShardedLRU::Get(const std::string &key, std::string &value) {
+    Shard &shard = shard_for(key);
+    std::lock_guard<std::mutex> l(shard.lock);
+    return shard.storage.Get(key, value);
+}
+
+// See ShardedLRU.h
+bool ShardedLRU::Get(const std::string &key, std::string &value, ItemMeta &meta) {
+    Shard &shard = shard_for(key);
+    std::lock_guard<std::mutex> l(shard.lock);
+    return shard.storage.Get(key, value, meta);
+}
+
+// See ShardedLRU.h
+bool ShardedLRU::Get(const std::string &key, ValueRef &value, ItemMeta &meta) {
+    Shard &shard = shard_for(key);
+    std::lock_guard<std::mutex> l(shard.lock);
+    return shard.storage.Get(key, value, meta);
+}
+
+// See ShardedLRU.h
+void ShardedLRU::MultiGet(const std::string *keys, size_t count, const MultiGetCallback &found) {
+    if (count == 1 || _shards.size() == 1) {
+        Shard &shard = *_shards[count == 1 ? shard_index(keys[0]) : 0];
+        std::lock_guard<std::mutex> l(shard.lock);
+        shard.storage.MultiGet(keys, count, found);
+        return;
+    }
+
+    // Counting sort of key positions by shard, all the scratch arrays are carved out of one buffer
+    // that lives on stack unless batch is large
+    size_t n_shards = _shards.size();
+    size_t local[kLocalScratch];
+    std::unique_ptr<size_t[]> heap;
+    size_t *scratch = local;
+    if (2 * count + 2 * n_shards + 1 > kLocalScratch) {
+        heap.reset(new size_t[2 * count + 2 * n_shards + 1]);
+        scratch = heap.get();
+    }
+    size_t *shard_of = scratch;
+    size_t *order = shard_of + count;
+    size_t *starts = order + count;
+    size_t *next = starts + n_shards + 1;
+
+    std::fill(starts, starts + n_shards + 1, 0);
+    for (size_t i = 0; i < count; i++) {
+        shard_of[i] = shard_index(keys[i]);
+        starts[shard_of[i] + 1]++;
+    }
+    for (size_t s = 0; s < n_shards; s++) {
+        starts[s + 1] += starts[s];
+        next[s] = starts[s];
+    }
+    for (size_t i = 0; i < count; i++) {
+        order[next[shard_of[i]]++] = i;
+    }
+
+    for (size_t s = 0; s < n_shards; s++) {
+        if (starts[s] == starts[s + 1]) {
+            continue;
+        }
+        Shard &shard = *_shards[s];
+        std::lock_guard<std::mutex> l(shard.lock);
+        shard.storage.MultiGet(keys, order + starts[s], starts[s + 1] - starts[s], found);
+    }
+}
+
+ShardedLRU::Shard &ShardedLRU::shard_for(const std::string &key) { return *_shards[shard_index(key)]; }
+
+size_t ShardedLRU::shard_index(const std::string &key) const {
+    // Use high bits of the hash: low ones are what hash tables inside of shard
+    // are going to use, so keys of one shard must not be biased there
+    size_t hash = std::hash<std::string>()(key);
+    return (hash >> (sizeof(size_t) * 4)) % _shards.size();
+}
+
+} // namespace Backend
+} // namespace Afina
@@ -0,0 +1,108 @@
+#ifndef AFINA_STORAGE_SHARDED_LRU_H
+#define AFINA_STORAGE_SHARDED_LRU_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <afina/Storage.h>
+#include <afina/concurrency/CacheAligned.h>
+
+#include "Reaper.h"
+#include "SimpleLRU.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # Lock-striped SimpleLRU
+ * Keys are hashed into N independent SimpleLRU shards, each one guarded by its own
+ * mutex. Shards get equal parts of the max_size budget, so total amount of stored
+ * bytes never exceeds max_size, but a single key/value pair must fit into one shard.
+ * Every shard needs SimpleLRU::kMinSize at least.
+ *
+ * Eviction policy works within a shard only.
+ */
+class ShardedLRU : public Afina::Storage {
+public:
+    ShardedLRU(size_t max_size = 4 * SimpleLRU::kMinSize, size_t n_shards = 4,
+               EvictionPolicy::Type policy = EvictionPolicy::Type::kLRU);
+    ~ShardedLRU() {}
+
+    // Starts background reaping of expired items
+    void Start() override;
+
+    // Stops background reaping
+    void Stop() override;
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value, uint32_t flags, int32_t expire) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t flags, int32_t expire) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value, uint32_t flags, int32_t expire) override;
+
+    // Implements Afina::Storage interface
+    CasResult CompareAndSet(const std::string &key, const std::string &value, uint32_t flags, int32_t expire,
+                            uint64_t cas) override;
+
+    // Implements Afina::Storage interface
+    bool Modify(const std::string &key, const ModifyCallback &modify) override;
+
+    // Implements Afina::Storage interface
+    bool Touch(const std::string &key, int32_t expire, ValueRef *value, ItemMeta *meta) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value, ItemMeta &meta) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, ValueRef &value, ItemMeta &meta) override;
+
+    // Implements Afina::Storage interface: keys are grouped by shard, so that every shard is locked
+    // once per batch, and reported shard by shard
+    void MultiGet(const std::string *keys, size_t count, const MultiGetCallback &found) override;
+
+private:
+    // Every shard lives in its own cache lines so that lock of one shard doesn't
+    // bounce together with neighbours
+    struct alignas(64) Shard : Concurrency::CacheAligned {
+        Shard(size_t max_size, EvictionPolicy::Type policy) : storage(max_size, policy) {}
+
+        std::mutex lock;
+        SimpleLRU storage;
+    };
+
+    // Number of words MultiGet sorts keys in without going to heap
+    static const size_t kLocalScratch = 256;
+
+    Shard &shard_for(const std::string &key);
+    size_t shard_index(const std::string &key) const;
+
+    std::vector<std::unique_ptr<Shard>> _shards;
+
+    // Walks through the shards reaping a batch from each one at a time
+    Reaper _reaper;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_SHARDED_LRU_H
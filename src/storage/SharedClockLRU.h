@@ -0,0 +1,135 @@
+#ifndef AFINA_STORAGE_SHARED_CLOCK_LRU_H
+#define AFINA_STORAGE_SHARED_CLOCK_LRU_H
+
+#include <mutex>
+#include <string>
+
+#include <afina/concurrency/SharedMutex.h>
+
+#include "Reaper.h"
+#include "SimpleLRU.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # SimpleLRU with shared reads
+ * Same storage as ThreadSafeSimplLRU, but under reader-writer lock: writes take it exclusively, reads take it
+ * shared and go by SharedGet that changes nothing. Eviction is CLOCK, so that read notes access by setting
+ * reference bit of the item instead of moving it in the list. Reads on different CPUs then don't touch any
+ * common cache line unless they read the same items, and those keep their bits set.
+ *
+ * Expired items found by reads stay until the next write or background reaping removes them.
+ */
+class SharedClockLRU : public SimpleLRU {
+public:
+    SharedClockLRU(size_t max_size = 1024) : SimpleLRU(max_size, EvictionPolicy::Type::kCLOCK) {}
+    ~SharedClockLRU() {}
+
+    // Starts background reaping of expired items
+    void Start() override {
+        _reaper.Start([this](size_t batch) {
+            std::lock_guard<Concurrency::SharedMutex> l(_lock);
+            return SimpleLRU::Reap(batch);
+        });
+    }
+
+    // Stops background reaping
+    void Stop() override { _reaper.Stop(); }
+
+    // see SimpleLRU.h
+    bool Put(const std::string &key, const std::string &value) override {
+        std::lock_guard<Concurrency::SharedMutex> l(_lock);
+        return SimpleLRU::Put(key, value);
+    }
+
+    // see SimpleLRU.h
+    bool PutIfAbsent(const std::string &key, const std::string &value) override {
+        std::lock_guard<Concurrency::SharedMutex> l(_lock);
+        return SimpleLRU::PutIfAbsent(key, value);
+    }
+
+    // see SimpleLRU.h
+    bool Set(const std::string &key, const std::string &value) override {
+        std::lock_guard<Concurrency::SharedMutex> l(_lock);
+        return SimpleLRU::Set(key, value);
+    }
+
+    // see SimpleLRU.h
+    bool Put(const std::string &key, const std::string &value, uint32_t flags, int32_t expire) override {
+        std::lock_guard<Concurrency::SharedMutex> l(_lock);
+        return SimpleLRU::Put(key, value, flags, expire);
+    }
+
+    // see SimpleLRU.h
+    bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t flags, int32_t expire) override {
+        std::lock_guard<Concurrency::SharedMutex> l(_lock);
+        return SimpleLRU::PutIfAbsent(key, value, flags, expire);
+    }
+
+    // see SimpleLRU.h
+    bool Set(const std::string &key, const std::string &value, uint32_t flags, int32_t expire) override {
+        std::lock_guard<Concurrency::SharedMutex> l(_lock);
+        return SimpleLRU::Set(key, value, flags, expire);
+    }
+
+    // see SimpleLRU.h
+    CasResult CompareAndSet(const std::string &key, const std::string &value, uint32_t flags, int32_t expire,
+                            uint64_t cas) override {
+        std::lock_guard<Concurrency::SharedMutex> l(_lock);
+        return SimpleLRU::CompareAndSet(key, value, flags, expire, cas);
+    }
+
+    // see SimpleLRU.h
+    bool Modify(const std::string &key, const ModifyCallback &modify) override {
+        std::lock_guard<Concurrency::SharedMutex> l(_lock);
+        return SimpleLRU::Modify(key, modify);
+    }
+
+    // see SimpleLRU.h
+    bool Touch(const std::string &key, int32_t expire, ValueRef *value, ItemMeta *meta) override {
+        std::lock_guard<Concurrency::SharedMutex> l(_lock);
+        return SimpleLRU::Touch(key, expire, value, meta);
+    }
+
+    // see SimpleLRU.h
+    bool Delete(const std::string &key) override {
+        std::lock_guard<Concurrency::SharedMutex> l(_lock);
+        return SimpleLRU::Delete(key);
+    }
+
+    // see SimpleLRU.h
+    bool Get(const std::string &key, std::string &value) override {
+        ItemMeta meta;
+        Concurrency::SharedLock l(_lock);
+        return SimpleLRU::SharedGet(key, value, meta);
+    }
+
+    // see SimpleLRU.h
+    bool Get(const std::string &key, std::string &value, ItemMeta &meta) override {
+        Concurrency::SharedLock l(_lock);
+        return SimpleLRU::SharedGet(key, value, meta);
+    }
+
+    // see SimpleLRU.h
+    bool Get(const std::string &key, ValueRef &value, ItemMeta &meta) override {
+        Concurrency::SharedLock l(_lock);
+        return SimpleLRU::SharedGet(key, value, meta);
+    }
+
+    // see SimpleLRU.h, lock is taken once for the whole batch
+    void MultiGet(const std::string *keys, size_t count, const MultiGetCallback &found) override {
+        Concurrency::SharedLock l(_lock);
+        SimpleLRU::SharedMultiGet(keys, count, found);
+    }
+
+private:
+    Concurrency::SharedMutex _lock;
+
+    Reaper _reaper;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_SHARED_CLOCK_LRU_H
@@ -1,138 +1,447 @@
 #include "SimpleLRU.h"
 
-#include <iostream>
-#include <utility>
+#include <new>
 
 namespace Afina {
 namespace Backend {
 
+// See MapBasedGlobalLockImpl.h, qualified calls keep the lock of ThreadSafeSimplLRU from being taken twice
+bool SimpleLRU::Put(const std::string &key, const std::string &value) { return SimpleLRU::Put(key, value, 0, 0); }
+
+// See MapBasedGlobalLockImpl.h
+bool SimpleLRU::PutIfAbsent(const std::string &key, const std::string &value) {
+    return SimpleLRU::PutIfAbsent(key, value, 0, 0);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool SimpleLRU::Set(const std::string &key, const std::string &value) { return SimpleLRU::Set(key, value, 0, 0); }
+
 // See MapBasedGlobalLockImpl.h
-bool SimpleLRU::Put(const std::string &key, const std::string &value) {
+bool SimpleLRU::Put(const std::string &key, const std::string &value, uint32_t flags, int32_t expire) {
     if (key.size() + value.size() > _max_size) {
         return false;
     }
 
-    auto it = put_if_absent(key, value);
-    if (it == _lru_index.end()) {
+    uint32_t now = _clock();
+    reap(now, kReapPerOperation);
+
+    uint32_t hash = lru_index::Hash(key);
+    uint32_t deadline = ExpirationTime(expire, now);
+    lru_node *node = find(hash, key, now);
+    if (is_expired(deadline, now)) {
+        // Stored and expired at once, so previous value is gone anyway
+        if (node != nullptr) {
+            delete_node(*node);
+        }
         return true;
     }
 
-    move_to_tail(it);
-
-    while (value.size() - it->second.get().value.size() + _cur_size > _max_size) {
-        delete_oldest_node();
+    if (node != nullptr) {
+        return update(*node, key, value, flags, deadline, now);
     }
-
-    _cur_size += value.size() - it->second.get().value.size();
-    it->second.get().value = value;
-    it->second.get().key = key;
-    return true;
+    return insert(key, hash, value, flags, deadline, false);
 }
 
 // See MapBasedGlobalLockImpl.h
-bool SimpleLRU::PutIfAbsent(const std::string &key, const std::string &value) {
+bool SimpleLRU::PutIfAbsent(const std::string &key, const std::string &value, uint32_t flags, int32_t expire) {
     if (key.size() + value.size() > _max_size) {
         return false;
     }
 
-    return put_if_absent(key, value) == _lru_index.end();
+    uint32_t now = _clock();
+    reap(now, kReapPerOperation);
+
+    uint32_t hash = lru_index::Hash(key);
+    uint32_t deadline = ExpirationTime(expire, now);
+    if (find(hash, key, now) != nullptr) {
+        return false;
+    }
+    if (is_expired(deadline, now)) {
+        return true;
+    }
+    return insert(key, hash, value, flags, deadline, false);
 }
 
 // See MapBasedGlobalLockImpl.h
-bool SimpleLRU::Set(const std::string &key, const std::string &value) {
-    auto it = _lru_index.find(std::reference_wrapper<const std::string>(key));
-    if (it == _lru_index.end()) {
+bool SimpleLRU::Set(const std::string &key, const std::string &value, uint32_t flags, int32_t expire) {
+    uint32_t now = _clock();
+    reap(now, kReapPerOperation);
+
+    lru_node *node = find(lru_index::Hash(key), key, now);
+    if (node == nullptr) {
         return false;
     }
 
-    if (key.size() + value.size() > _max_size) {
+    return update(*node, key, value, flags, ExpirationTime(expire, now), now);
+}
+
+// See SimpleLRU.h
+Storage::CasResult SimpleLRU::CompareAndSet(const std::string &key, const std::string &value, uint32_t flags,
+                                            int32_t expire, uint64_t cas) {
+    uint32_t now = _clock();
+    reap(now, kReapPerOperation);
+
+    lru_node *node = find(lru_index::Hash(key), key, now);
+    if (node == nullptr) {
+        return CasResult::kNotFound;
+    }
+    if (node->cas != cas) {
+        return CasResult::kExists;
+    }
+    return update(*node, key, value, flags, ExpirationTime(expire, now), now) ? CasResult::kStored
+                                                                              : CasResult::kNotStored;
+}
+
+// See SimpleLRU.h
+bool SimpleLRU::Modify(const std::string &key, const ModifyCallback &modify) {
+    uint32_t now = _clock();
+    reap(now, kReapPerOperation);
+
+    lru_node *node = find(lru_index::Hash(key), key, now);
+    if (node == nullptr) {
         return false;
     }
 
-    move_to_tail(it);
+    std::string value(node->value(), node->value_size);
+    if (!modify(value)) {
+        policy_of(*node).Access(node->hook);
+        return true;
+    }
+    return update(*node, key, value, node->flags, node->timer.deadline, now);
+}
 
-    while (value.size() - it->second.get().value.size() + _cur_size > _max_size) {
-        delete_oldest_node();
+// See SimpleLRU.h
+bool SimpleLRU::Touch(const std::string &key, int32_t expire, ValueRef *value, ItemMeta *meta) {
+    uint32_t now = _clock();
+    lru_node *node = find(lru_index::Hash(key), key, now);
+    if (node == nullptr) {
+        return false;
+    }
+
+    uint32_t deadline = ExpirationTime(expire, now);
+    _timers.Cancel(node->timer);
+    node->timer.deadline = deadline;
+    if (value != nullptr) {
+        *value = ValueRef::Copy(node->value(), node->value_size);
+    }
+    if (meta != nullptr) {
+        *meta = meta_of(*node);
+    }
+
+    if (is_expired(deadline, now)) {
+        delete_node(*node);
+    } else {
+        if (deadline != 0) {
+            _timers.Schedule(node->timer, deadline);
+        }
+        policy_of(*node).Access(node->hook);
     }
-    _cur_size += value.size() - it->second.get().value.size();
-    it->second.get().value = value;
-    it->second.get().key = key;
     return true;
 }
 
 // See MapBasedGlobalLockImpl.h
 bool SimpleLRU::Delete(const std::string &key) {
-    auto it = _lru_index.find(std::reference_wrapper<const std::string>(key));
-    if (it == _lru_index.end()) {
+    lru_node *node = find(lru_index::Hash(key), key, _clock());
+    if (node == nullptr) {
         return false;
     }
 
-    lru_node &del_node = it->second.get();
-    _lru_index.erase(key);
-    swap(del_node.prev->next, del_node.next);
-    del_node.next->prev = del_node.prev;
-    del_node.next = nullptr;
+    delete_node(*node);
     return true;
 }
 
 // See MapBasedGlobalLockImpl.h
 bool SimpleLRU::Get(const std::string &key, std::string &value) {
-    auto it = _lru_index.find(std::reference_wrapper<const std::string>(key));
-    if (it == _lru_index.end()) {
+    ItemMeta meta;
+    return SimpleLRU::Get(key, value, meta);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool SimpleLRU::Get(const std::string &key, std::string &value, ItemMeta &meta) {
+    lru_node *node = access(key);
+    if (node == nullptr) {
+        return false;
+    }
+
+    value.assign(node->value(), node->value_size);
+    meta = meta_of(*node);
+    return true;
+}
+
+// See MapBasedGlobalLockImpl.h
+bool SimpleLRU::Get(const std::string &key, ValueRef &value, ItemMeta &meta) {
+    lru_node *node = access(key);
+    if (node == nullptr) {
         return false;
     }
-    value = it->second.get().value;
+
+    // Chunk could be reused by the very next write, so the only copy goes into the buffer of reference
+    value = ValueRef::Copy(node->value(), node->value_size);
+    meta = meta_of(*node);
     return true;
 }
 
-SimpleLRU::lru_node *SimpleLRU::add_node_to_tail(std::string key, std::string value) {
+// See SimpleLRU.h
+void SimpleLRU::MultiGet(const std::string *keys, size_t count, const MultiGetCallback &found) {
+    MultiGet(keys, nullptr, count, found);
+}
+
+// See SimpleLRU.h
+void SimpleLRU::MultiGet(const std::string *keys, const size_t *order, size_t count, const MultiGetCallback &found) {
+    multi_get(keys, order, count, found,
+              [this](uint32_t hash, const std::string &key) { return access(hash, key); });
+}
+
+// See SimpleLRU.h
+bool SimpleLRU::SharedGet(const std::string &key, std::string &value, ItemMeta &meta) {
+    lru_node *node = peek(lru_index::Hash(key), key);
+    if (node == nullptr) {
+        return false;
+    }
+
+    value.assign(node->value(), node->value_size);
+    meta = meta_of(*node);
+    return true;
+}
+
+// See SimpleLRU.h
+bool SimpleLRU::SharedGet(const std::string &key, ValueRef &value, ItemMeta &meta) {
+    lru_node *node = peek(lru_index::Hash(key), key);
+    if (node == nullptr) {
+        return false;
+    }
+
+    value = ValueRef::Copy(node->value(), node->value_size);
+    meta = meta_of(*node);
+    return true;
+}
+
+// See SimpleLRU.h
+void SimpleLRU::SharedMultiGet(const std::string *keys, size_t count, const MultiGetCallback &found) {
+    multi_get(keys, nullptr, count, found, [this](uint32_t hash, const std::string &key) { return peek(hash, key); });
+}
+
+template <typename Lookup>
+void SimpleLRU::multi_get(const std::string *keys, const size_t *order, size_t count, const MultiGetCallback &found,
+                          Lookup lookup) {
+    // Ring of hashes computed kPrefetchDistance keys ahead of the lookup
+    uint32_t hashes[kPrefetchDistance];
+    auto key_at = [keys, order](size_t i) -> const std::string & { return keys[order == nullptr ? i : order[i]]; };
+    for (size_t i = 0; i < count && i < kPrefetchDistance; i++) {
+        hashes[i] = lru_index::Hash(key_at(i));
+        _lru_index.Prefetch(hashes[i]);
+    }
+
+    ValueRef value;
+    for (size_t i = 0; i < count; i++) {
+        uint32_t hash = hashes[i % kPrefetchDistance];
+        if (i + kPrefetchDistance < count) {
+            hashes[i % kPrefetchDistance] = lru_index::Hash(key_at(i + kPrefetchDistance));
+            _lru_index.Prefetch(hashes[i % kPrefetchDistance]);
+        }
+
+        lru_node *node = lookup(hash, key_at(i));
+        if (node == nullptr) {
+            continue;
+        }
+        value = ValueRef::Copy(node->value(), node->value_size);
+        found(order == nullptr ? i : order[i], value, meta_of(*node));
+    }
+}
+
+// See SimpleLRU.h
+size_t SimpleLRU::Reap(size_t limit) { return reap(_clock(), limit); }
+
+size_t SimpleLRU::reap(uint32_t now, size_t limit) {
+    return _timers.Advance(now, limit, [this](TimerHook &timer) { delete_node(*node_of(timer)); });
+}
+
+SimpleLRU::lru_node *SimpleLRU::find(uint32_t hash, const std::string &key, uint32_t now) {
+    lru_node *node = _lru_index.Find(hash, key);
+    if (node != nullptr && node->timer.deadline != 0 && is_expired(node->timer.deadline, now)) {
+        delete_node(*node);
+        return nullptr;
+    }
+    return node;
+}
+
+SimpleLRU::lru_node *SimpleLRU::access(const std::string &key) { return access(lru_index::Hash(key), key); }
+
+SimpleLRU::lru_node *SimpleLRU::access(uint32_t hash, const std::string &key) {
+    lru_node *node = _lru_index.Find(hash, key);
+    if (node == nullptr) {
+        return nullptr;
+    }
+
+    // Lazy expiration, clock is consulted only for items that have expiration time
+    if (node->timer.deadline != 0 && is_expired(node->timer.deadline, _clock())) {
+        delete_node(*node);
+        return nullptr;
+    }
+
+    policy_of(*node).Access(node->hook);
+    return node;
+}
+
+SimpleLRU::lru_node *SimpleLRU::peek(uint32_t hash, const std::string &key) {
+    lru_node *node = _lru_index.Find(hash, key);
+    if (node == nullptr || (node->timer.deadline != 0 && is_expired(node->timer.deadline, _clock()))) {
+        return nullptr;
+    }
+
+    policy_of(*node).SharedAccess(node->hook);
+    return node;
+}
+
+bool SimpleLRU::insert(const std::string &key, uint32_t hash, const std::string &value, uint32_t flags,
+                       uint32_t deadline, bool update) {
+    // Key that replace_value had no room for is still an update, admission doesn't apply to it
+    Allocator::Pointer chunk = allocate(sizeof(lru_node) + key.size() + value.size(), update ? nullptr : &key);
+    if (chunk.get() == nullptr) {
+        return false;
+    }
+
+    lru_node *node = new (chunk.get()) lru_node;
+    node->self = chunk;
+    node->hash = hash;
+    node->key_size = key.size();
+    node->value_size = value.size();
+    std::memcpy(node->key(), key.data(), key.size());
+    std::memcpy(node->value(), value.data(), value.size());
+
+    node->timer.prev = node->timer.next = nullptr;
+    set_meta(*node, flags, deadline);
+
+    policy_of(*node).Insert(node->hook);
+    _lru_index.Insert(hash, node);
     _cur_size += key.size() + value.size();
-    auto *new_node = new lru_node{std::move(key), std::move(value), _lru_tail->prev, nullptr};
-    new_node->next = std::unique_ptr<lru_node>(new_node);
-    std::swap(new_node->next, _lru_tail->prev->next);
-    _lru_tail->prev = new_node;
-    return new_node;
+    return true;
 }
 
-void SimpleLRU::delete_oldest_node() {
-    lru_node *old_node = _lru_head->next.get();
-    if (old_node == nullptr) {
-        return;
+bool SimpleLRU::update(lru_node &node, const std::string &key, const std::string &value, uint32_t flags,
+                       uint32_t deadline, uint32_t now) {
+    if (key.size() + value.size() > _max_size) {
+        return false;
+    }
+
+    // Stored and expired at once, so previous value is gone anyway
+    if (is_expired(deadline, now)) {
+        delete_node(node);
+        return true;
     }
-    _cur_size -= old_node->key.size() + old_node->value.size();
-    _lru_index.erase(old_node->key);
-    old_node->next->prev = _lru_head.get();
-    swap(_lru_head->next, old_node->next);
-    old_node->next = nullptr;
+
+    if (replace_value(node, value, flags, deadline)) {
+        return true;
+    }
+
+    // Old value goes away first, so that its memory could serve the new one
+    uint32_t hash = node.hash;
+    delete_node(node);
+    return insert(key, hash, value, flags, deadline, true);
 }
 
-void SimpleLRU::move_to_tail(std::map<std::reference_wrapper<const std::string>, std::reference_wrapper<lru_node>,
-                                      std::less<std::string>>::iterator &it) {
-    it->second.get().next->prev = it->second.get().prev;
-    swap(it->second.get().prev->next, it->second.get().next);
-    it->second.get().prev = _lru_tail->prev;
-    swap(it->second.get().next, _lru_tail->prev->next);
-    _lru_tail->prev = &it->second.get();
+bool SimpleLRU::replace_value(lru_node &node, const std::string &value, uint32_t flags, uint32_t deadline) {
+    // Value that needs chunk of another size is stored by the new node
+    size_t old_size = sizeof(lru_node) + node.key_size + node.value_size;
+    size_t new_size = sizeof(lru_node) + node.key_size + value.size();
+    if (_allocator.chunk_size(old_size) != _allocator.chunk_size(new_size)) {
+        return false;
+    }
+
+    _timers.Cancel(node.timer);
+    _cur_size = _cur_size - node.value_size + value.size();
+    node.value_size = value.size();
+    std::memcpy(node.value(), value.data(), value.size());
+
+    node.timer.prev = node.timer.next = nullptr;
+    set_meta(node, flags, deadline);
+
+    // Update is an access as well
+    policy_of(node).Access(node.hook);
+    return true;
 }
 
-std::map<std::reference_wrapper<const std::string>, std::reference_wrapper<SimpleLRU::lru_node>,
-         std::less<std::string>>::iterator
-SimpleLRU::put_if_absent(const std::string &key, const std::string &value) {
-    auto it = _lru_index.find(std::reference_wrapper<const std::string>(key));
+Allocator::Pointer SimpleLRU::allocate(size_t size, const std::string *candidate) {
+    // Items larger than a page need consecutive free pages, which victim of their own class doesn't give
+    size_t klass = _allocator.size_class(size);
+    EvictionPolicy *policy = klass + 1 < _allocator.size_classes() ? _policies[klass].get() : nullptr;
+    while (true) {
+        Allocator::Pointer chunk = _allocator.alloc(size, std::nothrow);
+        if (chunk.get() != nullptr) {
+            return chunk;
+        }
+
+        // Chunk of the victim from the same class serves the request for sure, otherwise whole pages
+        // are needed and the cheapest ones are cleared, see SimpleLRU.h
+        std::vector<lru_node *> victims;
+        PolicyHook *hook = policy != nullptr ? policy->Victim() : nullptr;
+        if (hook != nullptr) {
+            victims.push_back(node_of(hook));
+        } else {
+            for (void *address : _allocator.reclaim(size)) {
+                victims.push_back(static_cast<lru_node *>(address));
+            }
+        }
+        if (victims.empty()) {
+            return Allocator::Pointer();
+        }
 
-    if (it != _lru_index.end()) {
-        return it;
+        lru_node &first = *victims.front();
+        if (candidate != nullptr && _admission_filter &&
+            !_admission_filter(*candidate, std::string(first.key(), first.key_size))) {
+            return Allocator::Pointer();
+        }
+        candidate = nullptr;
+
+        for (lru_node *victim : victims) {
+            evict(*victim);
+        }
     }
+}
 
-    while (key.size() + value.size() + _cur_size > _max_size) {
-        delete_oldest_node();
+void SimpleLRU::evict(lru_node &victim) {
+    if (_eviction_listener) {
+        std::string key(victim.key(), victim.key_size);
+        std::string value(victim.value(), victim.value_size);
+        ItemMeta meta = meta_of(victim);
+        delete_node(victim);
+        _eviction_listener(key, value, meta);
+    } else {
+        delete_node(victim);
     }
+}
+
+ItemMeta SimpleLRU::meta_of(lru_node &node) {
+    ItemMeta meta;
+    meta.flags = node.flags;
+    meta.deadline = node.timer.deadline;
+    meta.cas = node.cas;
+    return meta;
+}
+
+void SimpleLRU::set_meta(lru_node &node, uint32_t flags, uint32_t deadline) {
+    node.flags = flags;
+    node.cas = _next_cas++;
+    node.timer.deadline = deadline;
+    if (deadline != 0) {
+        _timers.Schedule(node.timer, deadline);
+    }
+}
+
+void SimpleLRU::delete_node(lru_node &node) {
+    policy_of(node).Erase(node.hook);
+    free_node(node);
+}
+
+void SimpleLRU::free_node(lru_node &node) {
+    _timers.Cancel(node.timer);
+    _cur_size -= node.key_size + node.value_size;
+    _lru_index.Erase(node.hash, &node);
 
-    lru_node *new_node = add_node_to_tail(key, value);
-    _lru_index.emplace(std::reference_wrapper<const std::string>(new_node->key),
-                       std::reference_wrapper<lru_node>(*new_node));
-    return _lru_index.end();
+    Allocator::Pointer chunk = node.self;
+    node.~lru_node();
+    _allocator.free(chunk);
 }
 
 } // namespace Backend
-} // namespace Afina
\ No newline at end of file
+} // namespace Afina
@@ -1,44 +1,61 @@
 #ifndef AFINA_STORAGE_SIMPLE_LRU_H
 #define AFINA_STORAGE_SIMPLE_LRU_H
 
-#include <map>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
 #include <memory>
-#include <mutex>
+#include <stdexcept>
 #include <string>
-#include <utility>
+#include <vector>
 
 #include <afina/Storage.h>
+#include <afina/allocator/Pointer.h>
+#include <afina/allocator/Simple.h>
+
+#include "EvictionPolicy.h"
+#include "HashIndex.h"
+#include "TimerWheel.h"
 
 namespace Afina {
 namespace Backend {
 
 /**
- * # Map based implementation
+ * # Hash index based implementation
  * That is NOT thread safe implementaiton!!
+ *
+ * Storage owns memory area of _max_size bytes and carves items out of it using slab allocator,
+ * so node header, key and value of the each item live in a single chunk and there is no heap
+ * allocation once storage warmed up. Every item costs about a hundred bytes of header and page rounding
+ * on top of key and value, so area must be at least kMinSize.
+ *
+ * If allocator has no room for the new item then the oldest item of the same size class is evicted,
+ * its chunk is exactly what new item needs (memcached style). Class that has no items yet takes the page
+ * with the least items in use, only those are evicted. So the new item never flushes items of other
+ * classes hoping that some page gets free.
+ *
+ * Which item is the oldest one is up to eviction policy, strict LRU by default.
+ *
+ * Items with expiration time are kept in the timer wheel. Expired item is removed once it is accessed,
+ * besides that every write reaps a few expired items and owner could reap more with Reap.
  */
 class SimpleLRU : public Afina::Storage {
 public:
-    explicit SimpleLRU(size_t max_size = 1024) : _max_size(max_size), _cur_size(0) {
-        // it's two additional nodes for more comfortable deleting
-        _lru_head = std::unique_ptr<lru_node>(new lru_node);
-        _lru_head->prev = nullptr;
-        _lru_head->next = std::unique_ptr<lru_node>(_lru_tail);
-        _lru_tail->prev = _lru_head.get();
-        _lru_tail->next = nullptr;
-    }
+    // Smallest memory area that keeps a few items
+    static const size_t kMinSize = 1024;
 
-    ~SimpleLRU() {
-        _lru_index.clear();
-        if (_lru_head != nullptr) {
-            while (_lru_head != nullptr) {
-                auto prev = std::move(_lru_head);
-                _lru_head = std::move(prev->next);
-                prev.reset();
-            }
-            // TODO: Here is stack overflow
+    explicit SimpleLRU(size_t max_size = kMinSize, EvictionPolicy::Type policy = EvictionPolicy::Type::kLRU)
+        : _max_size(checked_size(max_size)), _cur_size(0), _arena(new char[max_size]),
+          _allocator(_arena.get(), max_size), _timers(0), _clock(UnixTime), _next_cas(1) {
+        for (size_t i = 0; i < _allocator.size_classes(); i++) {
+            _policies.push_back(EvictionPolicy::Create(policy));
         }
     }
 
+    // Nodes live in the arena and have no resources to release
+    ~SimpleLRU() {}
+
     // Implements Afina::Storage interface
     bool Put(const std::string &key, const std::string &value) override;
 
@@ -48,46 +65,201 @@ public:
     // Implements Afina::Storage interface
     bool Set(const std::string &key, const std::string &value) override;
 
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value, uint32_t flags, int32_t expire) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t flags, int32_t expire) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value, uint32_t flags, int32_t expire) override;
+
+    // Implements Afina::Storage interface
+    CasResult CompareAndSet(const std::string &key, const std::string &value, uint32_t flags, int32_t expire,
+                            uint64_t cas) override;
+
+    // Implements Afina::Storage interface
+    bool Modify(const std::string &key, const ModifyCallback &modify) override;
+
+    // Implements Afina::Storage interface, item stays in its chunk and only moves in the timer wheel
+    bool Touch(const std::string &key, int32_t expire, ValueRef *value, ItemMeta *meta) override;
+
     // Implements Afina::Storage interface
     bool Delete(const std::string &key) override;
 
     // Implements Afina::Storage interface
     bool Get(const std::string &key, std::string &value) override;
 
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value, ItemMeta &meta) override;
+
+    // Implements Afina::Storage interface, value is copied since its chunk could be reused right after
+    bool Get(const std::string &key, ValueRef &value, ItemMeta &meta) override;
+
+    // Implements Afina::Storage interface, keys are reported in order
+    void MultiGet(const std::string *keys, size_t count, const MultiGetCallback &found) override;
+
+    /**
+     * Same as MultiGet, but looks up only keys[order[0]], ..., keys[order[count - 1]]. Callback gets
+     * positions in keys, not in order
+     */
+    void MultiGet(const std::string *keys, const size_t *order, size_t count, const MultiGetCallback &found);
+
+    /**
+     * Get that doesn't change the storage, so that any number of them could run at once as long as nothing
+     * else does. Access is noted by SharedAccess of the policy, expired item is reported missing and left
+     * for the next write or Reap to remove
+     */
+    bool SharedGet(const std::string &key, std::string &value, ItemMeta &meta);
+    bool SharedGet(const std::string &key, ValueRef &value, ItemMeta &meta);
+
+    /**
+     * MultiGet that doesn't change the storage, same as SharedGet
+     */
+    void SharedMultiGet(const std::string *keys, size_t count, const MultiGetCallback &found);
+
+    /**
+     * Removes up to limit of expired items, returns number of removed ones
+     */
+    size_t Reap(size_t limit);
+
+    /**
+     * Returns number of bytes of the memory area item with key and value of the given sizes takes, header
+     * and rounding up to the chunk size included
+     */
+    size_t ItemSize(size_t key_size, size_t value_size) const {
+        return _allocator.chunk_size(sizeof(lru_node) + key_size + value_size);
+    }
+
+    // Returns current unix time in seconds
+    using Clock = std::function<uint32_t()>;
+
+    /**
+     * Replaces source of the current time, must be called before any item with expiration time is stored
+     */
+    void SetClock(Clock clock) { _clock = std::move(clock); }
+
+    // Gets key, value and metadata of the item evicted to make room, explicitly deleted or expired items
+    // aren't reported. Listener must not touch the storage that reports eviction
+    using EvictionListener =
+        std::function<void(const std::string &key, const std::string &value, const ItemMeta &meta)>;
+
+    // Gets key of the new item and key of the item that is going to be evicted for it, returns
+    // false if new item should be rejected instead
+    using AdmissionFilter = std::function<bool(const std::string &candidate, const std::string &victim)>;
+
+    void SetEvictionListener(EvictionListener listener) { _eviction_listener = std::move(listener); }
+
+    /**
+     * Filter is consulted once per insertion of the new key, before the first eviction it causes.
+     * Updates of existing keys are always admitted
+     */
+    void SetAdmissionFilter(AdmissionFilter filter) { _admission_filter = std::move(filter); }
+
 private:
-    // LRU cache node
+    // LRU cache node, header of the allocator chunk followed by key and value bytes
     using lru_node = struct lru_node {
-        std::string key;
-        std::string value;
-        lru_node *prev;
-        std::unique_ptr<lru_node> next;
+        // Must be the first member, see node_of
+        PolicyHook hook;
+
+        // Handle of the chunk node lives in
+        Allocator::Pointer self;
+
+        // Expiration time of the item, 0 if item never expires
+        TimerHook timer;
+
+        uint32_t hash;
+        uint32_t key_size;
+        uint32_t value_size;
+
+        // Client flags and version of the item, see ItemMeta
+        uint32_t flags;
+        uint64_t cas;
+
+        char *key() { return reinterpret_cast<char *>(this + 1); }
+        char *value() { return key() + key_size; }
+    };
+
+    struct lru_key_equal {
+        bool operator()(lru_node &node, const std::string &key) const {
+            return node.key_size == key.size() && std::memcmp(node.key(), key.data(), key.size()) == 0;
+        }
     };
+    using lru_index = HashIndex<lru_node, lru_key_equal>;
 
-    // Maximum number of bytes could be stored in this cache.
-    // i.e all (keys+values) must be less the _max_size
+    // Size of the memory area items are allocated from
     std::size_t _max_size;
+
+    // Number of bytes taken by keys and values currently stored
     std::size_t _cur_size;
 
-    // Main storage of lru_nodes, elements in this list ordered descending by "freshness": in the head
-    // element that wasn't used for longest time.
-    //
-    // List owns all nodes
-    std::unique_ptr<lru_node> _lru_head;
-    lru_node *_lru_tail = new lru_node;
-    // Index of nodes from list above, allows fast random access to elements by lru_node#key
-    std::map<std::reference_wrapper<const std::string>, std::reference_wrapper<lru_node>, std::less<std::string>>
-        _lru_index;
-
-    lru_node *add_node_to_tail(std::string key, std::string value);
-    void delete_oldest_node();
-    void move_to_tail(std::map<std::reference_wrapper<const std::string>, std::reference_wrapper<lru_node>,
-                               std::less<std::string>>::iterator &it);
-    std::map<std::reference_wrapper<const std::string>, std::reference_wrapper<lru_node>,
-             std::less<std::string>>::iterator
-    put_if_absent(const std::string &key, const std::string &value);
+    // Memory of the items, all nodes are allocated here
+    std::unique_ptr<char[]> _arena;
+    Allocator::Simple _allocator;
+
+    // Orders nodes for eviction, one policy per size class of the allocator, see allocate
+    std::vector<std::unique_ptr<EvictionPolicy>> _policies;
+
+    // Index of all nodes, allows fast random access to elements by lru_node#key
+    lru_index _lru_index;
+
+    // Expiration times of the nodes
+    TimerWheel _timers;
+    Clock _clock;
+
+    // Version assigned to the next stored item
+    uint64_t _next_cas;
+
+    EvictionListener _eviction_listener;
+    AdmissionFilter _admission_filter;
+
+    // Number of expired items each write reaps at most
+    static const size_t kReapPerOperation = 4;
+
+    // Number of keys MultiGet hashes ahead of the lookup, so that index slots are prefetched in time
+    static const size_t kPrefetchDistance = 8;
+
+    static lru_node *node_of(PolicyHook *hook) { return reinterpret_cast<lru_node *>(hook); }
+    static lru_node *node_of(TimerHook &timer) {
+        return reinterpret_cast<lru_node *>(reinterpret_cast<char *>(&timer) - offsetof(lru_node, timer));
+    }
+    static bool is_expired(uint32_t deadline, uint32_t now) { return deadline != 0 && deadline <= now; }
+    static ItemMeta meta_of(lru_node &node);
+
+    static size_t checked_size(size_t max_size) {
+        if (max_size < kMinSize) {
+            throw std::invalid_argument("Storage needs at least " + std::to_string(kMinSize) + " bytes of memory");
+        }
+        return max_size;
+    }
+
+    size_t reap(uint32_t now, size_t limit);
+    lru_node *find(uint32_t hash, const std::string &key, uint32_t now);
+    lru_node *access(const std::string &key);
+    lru_node *access(uint32_t hash, const std::string &key);
+    lru_node *peek(uint32_t hash, const std::string &key);
+    template <typename Lookup>
+    void multi_get(const std::string *keys, const size_t *order, size_t count, const MultiGetCallback &found,
+                   Lookup lookup);
+    bool insert(const std::string &key, uint32_t hash, const std::string &value, uint32_t flags, uint32_t deadline,
+                bool update);
+    bool update(lru_node &node, const std::string &key, const std::string &value, uint32_t flags, uint32_t deadline,
+                uint32_t now);
+    bool replace_value(lru_node &node, const std::string &value, uint32_t flags, uint32_t deadline);
+    void set_meta(lru_node &node, uint32_t flags, uint32_t deadline);
+    Allocator::Pointer allocate(size_t size, const std::string *candidate);
+    void evict(lru_node &victim);
+    void delete_node(lru_node &node);
+
+    // Policy that orders nodes of the size class node belongs to. Class is derived from the sizes rather than
+    // kept in the node, so that header doesn't grow
+    EvictionPolicy &policy_of(lru_node &node) {
+        return *_policies[_allocator.size_class(sizeof(lru_node) + node.key_size + node.value_size)];
+    }
+    void free_node(lru_node &node);
 };
 
 } // namespace Backend
 } // namespace Afina
 
-#endif // AFINA_STORAGE_SIMPLE_LRU_H
\ No newline at end of file
+#endif // AFINA_STORAGE_SIMPLE_LRU_H
@@ -5,6 +5,9 @@
 #include <mutex>
 #include <string>
 
+#include <afina/concurrency/Mutex.h>
+
+#include "Reaper.h"
 #include "SimpleLRU.h"
 
 namespace Afina {
@@ -17,47 +20,116 @@ namespace Backend {
  */
 class ThreadSafeSimplLRU : public SimpleLRU {
 public:
-    ThreadSafeSimplLRU(size_t max_size = 1024) : SimpleLRU(max_size) {}
+    ThreadSafeSimplLRU(size_t max_size = 1024, EvictionPolicy::Type policy = EvictionPolicy::Type::kLRU)
+        : SimpleLRU(max_size, policy), exist_user("storage.mt_lru") {}
     ~ThreadSafeSimplLRU() {}
 
+    // Starts background reaping of expired items
+    void Start() override {
+        _reaper.Start([this](size_t batch) {
+            std::lock_guard<Concurrency::Mutex> l(exist_user);
+            return SimpleLRU::Reap(batch);
+        });
+    }
+
+    // Stops background reaping
+    void Stop() override { _reaper.Stop(); }
+
     // see SimpleLRU.h
     bool Put(const std::string &key, const std::string &value) override {
         // TODO: sinchronization
-        std::lock_guard<std::mutex> l(exist_user);
+        std::lock_guard<Concurrency::Mutex> l(exist_user);
         return SimpleLRU::Put(key, value);
     }
 
     // see SimpleLRU.h
     bool PutIfAbsent(const std::string &key, const std::string &value) override {
         // TODO: sinchronization
-        std::lock_guard<std::mutex> l(exist_user);
+        std::lock_guard<Concurrency::Mutex> l(exist_user);
         return SimpleLRU::PutIfAbsent(key, value);
     }
 
     // see SimpleLRU.h
     bool Set(const std::string &key, const std::string &value) override {
         // TODO: sinchronization
-        std::lock_guard<std::mutex> l(exist_user);
+        std::lock_guard<Concurrency::Mutex> l(exist_user);
         return SimpleLRU::Set(key, value);
     }
 
+    // see SimpleLRU.h
+    bool Put(const std::string &key, const std::string &value, uint32_t flags, int32_t expire) override {
+        std::lock_guard<Concurrency::Mutex> l(exist_user);
+        return SimpleLRU::Put(key, value, flags, expire);
+    }
+
+    // see SimpleLRU.h
+    bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t flags, int32_t expire) override {
+        std::lock_guard<Concurrency::Mutex> l(exist_user);
+        return SimpleLRU::PutIfAbsent(key, value, flags, expire);
+    }
+
+    // see SimpleLRU.h
+    bool Set(const std::string &key, const std::string &value, uint32_t flags, int32_t expire) override {
+        std::lock_guard<Concurrency::Mutex> l(exist_user);
+        return SimpleLRU::Set(key, value, flags, expire);
+    }
+
+    // see SimpleLRU.h
+    CasResult CompareAndSet(const std::string &key, const std::string &value, uint32_t flags, int32_t expire,
+                            uint64_t cas) override {
+        std::lock_guard<Concurrency::Mutex> l(exist_user);
+        return SimpleLRU::CompareAndSet(key, value, flags, expire, cas);
+    }
+
+    // see SimpleLRU.h
+    bool Modify(const std::string &key, const ModifyCallback &modify) override {
+        std::lock_guard<Concurrency::Mutex> l(exist_user);
+        return SimpleLRU::Modify(key, modify);
+    }
+
+    // see SimpleLRU.h
+    bool Touch(const std::string &key, int32_t expire, ValueRef *value, ItemMeta *meta) override {
+        std::lock_guard<Concurrency::Mutex> l(exist_user);
+        return SimpleLRU::Touch(key, expire, value, meta);
+    }
+
     // see SimpleLRU.h
     bool Delete(const std::string &key) override {
         // TODO: sinchronization
-        std::lock_guard<std::mutex> l(exist_user);
+        std::lock_guard<Concurrency::Mutex> l(exist_user);
         return SimpleLRU::Delete(key);
     }
 
     // see SimpleLRU.h
     bool Get(const std::string &key, std::string &value) override {
         // TODO: sinchronization
-        std::lock_guard<std::mutex> l(exist_user);
+        std::lock_guard<Concurrency::Mutex> l(exist_user);
         return SimpleLRU::Get(key, value);
     }
 
+    // see SimpleLRU.h
+    bool Get(const std::string &key, std::string &value, ItemMeta &meta) override {
+        std::lock_guard<Concurrency::Mutex> l(exist_user);
+        return SimpleLRU::Get(key, value, meta);
+    }
+
+    // see SimpleLRU.h
+    bool Get(const std::string &key, ValueRef &value, ItemMeta &meta) override {
+        std::lock_guard<Concurrency::Mutex> l(exist_user);
+        return SimpleLRU::Get(key, value, meta);
+    }
+
+    // see SimpleLRU.h, lock is taken once for the whole batch
+    void MultiGet(const std::string *keys, size_t count, const MultiGetCallback &found) override {
+        std::lock_guard<Concurrency::Mutex> l(exist_user);
+        SimpleLRU::MultiGet(keys, count, found);
+    }
+
 private:
-    // TODO: sinchronization primitives
-    std::mutex exist_user;
+    // Guards the whole storage, profiled as storage.mt_lru
+    Concurrency::Mutex exist_user;
+
+    Reaper _reaper;
 };
 
 } // namespace Backend
@@ -0,0 +1,143 @@
+#include "TimerWheel.h"
+
+#include <ctime>
+
+namespace Afina {
+namespace Backend {
+
+namespace {
+
+// memcached treats larger exptime as absolute unix time
+const int32_t kMaxRelativeExpire = 60 * 60 * 24 * 30;
+
+} // namespace
+
+// See TimerWheel.h
+uint32_t ExpirationTime(int32_t expire, uint32_t now) {
+    if (expire == 0) {
+        return 0;
+    } else if (expire < 0) {
+        return 1;
+    } else if (expire <= kMaxRelativeExpire) {
+        return now + expire;
+    }
+    return expire;
+}
+
+// See TimerWheel.h
+uint32_t UnixTime() { return static_cast<uint32_t>(std::time(nullptr)); }
+
+// See TimerWheel.h
+TimerWheel::TimerWheel(uint32_t now) : _current(now), _size(0) {
+    for (auto &level : _slots) {
+        for (auto &slot : level) {
+            slot.prev = slot.next = &slot;
+        }
+    }
+    _expired.prev = _expired.next = &_expired;
+}
+
+// See TimerWheel.h
+void TimerWheel::Schedule(TimerHook &hook, uint32_t deadline) {
+    hook.deadline = deadline;
+    place(hook);
+    _size++;
+}
+
+// See TimerWheel.h
+void TimerWheel::Cancel(TimerHook &hook) {
+    if (hook.prev == nullptr) {
+        return;
+    }
+    unlink(hook);
+    _size--;
+}
+
+// See TimerWheel.h
+size_t TimerWheel::Advance(uint32_t now, size_t limit, const std::function<void(TimerHook &)> &fire) {
+    size_t fired = 0;
+    while (fired < limit) {
+        if (_expired.next != &_expired) {
+            TimerHook &hook = *_expired.next;
+            unlink(hook);
+            _size--;
+            fire(hook);
+            fired++;
+        } else if (_current >= now) {
+            break;
+        } else if (_size == 0) {
+            // Nothing to cascade, so there is no point to walk through empty slots
+            _current = now;
+        } else {
+            tick();
+        }
+    }
+    return fired;
+}
+
+void TimerWheel::tick() {
+    _current++;
+
+    // Spread upper levels first, they may put timers into the lower slots being cascaded right after
+    for (uint32_t level = kLevels - 1; level > 0; level--) {
+        uint32_t shift = level * kSlotBits;
+        if ((_current & ((1u << shift) - 1)) == 0) {
+            cascade(_slots[level][(_current >> shift) & (kSlots - 1)]);
+        }
+    }
+    cascade(_slots[0][_current & (kSlots - 1)]);
+}
+
+void TimerWheel::place(TimerHook &hook) {
+    if (hook.deadline <= _current) {
+        link(_expired, hook);
+        return;
+    }
+
+    uint32_t delta = hook.deadline - _current;
+    uint32_t level = 0;
+    while (level < kLevels - 1 && delta >= (1u << ((level + 1) * kSlotBits))) {
+        level++;
+    }
+
+    // Timers beyond the wheel span wait in the farthest slot and get placed again on cascade
+    uint32_t span = 1u << ((level + 1) * kSlotBits);
+    uint32_t at = delta < span ? hook.deadline : _current + span - 1;
+    link(_slots[level][(at >> (level * kSlotBits)) & (kSlots - 1)], hook);
+}
+
+void TimerWheel::cascade(TimerHook &slot) {
+    if (slot.next == &slot) {
+        return;
+    }
+
+    // Take the whole slot away, placement may put timers back into it
+    TimerHook list;
+    list.next = slot.next;
+    list.prev = slot.prev;
+    list.next->prev = &list;
+    list.prev->next = &list;
+    slot.prev = slot.next = &slot;
+
+    while (list.next != &list) {
+        TimerHook &hook = *list.next;
+        unlink(hook);
+        place(hook);
+    }
+}
+
+void TimerWheel::link(TimerHook &list, TimerHook &hook) {
+    hook.prev = list.prev;
+    hook.next = &list;
+    list.prev->next = &hook;
+    list.prev = &hook;
+}
+
+void TimerWheel::unlink(TimerHook &hook) {
+    hook.prev->next = hook.next;
+    hook.next->prev = hook.prev;
+    hook.prev = hook.next = nullptr;
+}
+
+} // namespace Backend
+} // namespace Afina
@@ -0,0 +1,97 @@
+#ifndef AFINA_STORAGE_TIMER_WHEEL_H
+#define AFINA_STORAGE_TIMER_WHEEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * Converts memcached exptime into absolute unix time in seconds: 0 stays 0 meaning "never", values up to
+ * 30 days are relative to now, larger ones are absolute already. Negative exptime gives time in the past
+ */
+uint32_t ExpirationTime(int32_t expire, uint32_t now);
+
+/**
+ * Current unix time in seconds
+ */
+uint32_t UnixTime();
+
+/**
+ * Intrusive part of the storage node that timer wheel operates on
+ */
+struct TimerHook {
+    // Siblings in the slot, nullptr if timer isn't scheduled
+    TimerHook *prev;
+    TimerHook *next;
+
+    // Absolute time timer fires at
+    uint32_t deadline;
+};
+
+/**
+ * # Hierarchical timer wheel
+ * Four levels of 64 slots, slot of the level L covers 64^L seconds, so wheel spans 194 days and any
+ * timer is scheduled or cancelled in O(1). Time moves forward by ticks of one second: tick fires the
+ * current slot of the first level, once it wraps around the next slot of the upper level is spread down
+ * between lower levels. Timers beyond the span sit in the last level and get rescheduled on cascade.
+ *
+ * Advance has a limit of timers to fire, so a storm of expirations is spread over several calls.
+ *
+ * That is NOT thread safe implementation!!
+ */
+class TimerWheel {
+public:
+    explicit TimerWheel(uint32_t now);
+
+    /**
+     * Schedules timer to fire at the given time, hook must not be scheduled yet. Timer in the past
+     * fires on the next Advance
+     */
+    void Schedule(TimerHook &hook, uint32_t deadline);
+
+    /**
+     * Removes timer from the wheel, does nothing if timer isn't scheduled
+     */
+    void Cancel(TimerHook &hook);
+
+    /**
+     * Moves wheel time forward to now and calls fire for expired timers, at most limit of them.
+     * Fired timer is unscheduled before the call, fire is free to schedule or cancel any timer.
+     * Returns number of fired timers
+     */
+    size_t Advance(uint32_t now, size_t limit, const std::function<void(TimerHook &)> &fire);
+
+    /**
+     * Number of scheduled timers
+     */
+    size_t Size() const { return _size; }
+
+private:
+    static const uint32_t kLevels = 4;
+    static const uint32_t kSlotBits = 6;
+    static const uint32_t kSlots = 1 << kSlotBits;
+
+    void tick();
+    void place(TimerHook &hook);
+    void cascade(TimerHook &slot);
+
+    static void link(TimerHook &list, TimerHook &hook);
+    static void unlink(TimerHook &hook);
+
+    // Time of the last processed tick
+    uint32_t _current;
+    size_t _size;
+
+    TimerHook _slots[kLevels][kSlots];
+
+    // Timers which time has come but that aren't fired yet
+    TimerHook _expired;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_TIMER_WHEEL_H
@@ -0,0 +1,113 @@
+#include "TinyLFU.h"
+
+#include <functional>
+#include <stdexcept>
+
+namespace Afina {
+namespace Backend {
+
+// See TinyLFU.h
+TinyLFU::TinyLFU(size_t max_size)
+    : _sketch(max_size / kAverageItemSize), _window(window_size(max_size)), _main(max_size - window_size(max_size)) {
+    // Window victims compete for the place in the main storage, their expiration time is absolute
+    // already, so it passes as is
+    _window.SetEvictionListener([this](const std::string &key, const std::string &value, const ItemMeta &meta) {
+        _main.Put(key, value, meta.flags, static_cast<int32_t>(meta.deadline));
+    });
+    _main.SetAdmissionFilter([this](const std::string &candidate, const std::string &victim) {
+        return _sketch.Frequency(hash_of(candidate)) > _sketch.Frequency(hash_of(victim));
+    });
+}
+
+// See MapBasedGlobalLockImpl.h
+bool TinyLFU::Put(const std::string &key, const std::string &value) { return Put(key, value, 0, 0); }
+
+// See MapBasedGlobalLockImpl.h
+bool TinyLFU::PutIfAbsent(const std::string &key, const std::string &value) { return PutIfAbsent(key, value, 0, 0); }
+
+// See MapBasedGlobalLockImpl.h
+bool TinyLFU::Set(const std::string &key, const std::string &value) { return Set(key, value, 0, 0); }
+
+// See MapBasedGlobalLockImpl.h
+bool TinyLFU::Put(const std::string &key, const std::string &value, uint32_t flags, int32_t expire) {
+    _sketch.Increment(hash_of(key));
+    if (_window.Set(key, value, flags, expire) || _main.Set(key, value, flags, expire)) {
+        return true;
+    }
+
+    // Items larger than the whole window go straight to the admission
+    return _window.Put(key, value, flags, expire) || _main.Put(key, value, flags, expire);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool TinyLFU::PutIfAbsent(const std::string &key, const std::string &value, uint32_t flags, int32_t expire) {
+    std::string existing;
+    if (_window.Get(key, existing) || _main.Get(key, existing)) {
+        return false;
+    }
+    return Put(key, value, flags, expire);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool TinyLFU::Set(const std::string &key, const std::string &value, uint32_t flags, int32_t expire) {
+    _sketch.Increment(hash_of(key));
+    return _window.Set(key, value, flags, expire) || _main.Set(key, value, flags, expire);
+}
+
+// See MapBasedGlobalLockImpl.h
+Storage::CasResult TinyLFU::CompareAndSet(const std::string &key, const std::string &value, uint32_t flags,
+                                          int32_t expire, uint64_t cas) {
+    _sketch.Increment(hash_of(key));
+    CasResult result = _window.CompareAndSet(key, value, flags, expire, cas);
+    return result != CasResult::kNotFound ? result : _main.CompareAndSet(key, value, flags, expire, cas);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool TinyLFU::Modify(const std::string &key, const ModifyCallback &modify) {
+    _sketch.Increment(hash_of(key));
+    return _window.Modify(key, modify) || _main.Modify(key, modify);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool TinyLFU::Touch(const std::string &key, int32_t expire, ValueRef *value, ItemMeta *meta) {
+    _sketch.Increment(hash_of(key));
+    return _window.Touch(key, expire, value, meta) || _main.Touch(key, expire, value, meta);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool TinyLFU::Delete(const std::string &key) { return _window.Delete(key) || _main.Delete(key); }
+
+// See MapBasedGlobalLockImpl.h
+bool TinyLFU::Get(const std::string &key, std::string &value) {
+    _sketch.Increment(hash_of(key));
+    return _window.Get(key, value) || _main.Get(key, value);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool TinyLFU::Get(const std::string &key, std::string &value, ItemMeta &meta) {
+    _sketch.Increment(hash_of(key));
+    return _window.Get(key, value, meta) || _main.Get(key, value, meta);
+}
+
+// See MapBasedGlobalLockImpl.h
+bool TinyLFU::Get(const std::string &key, ValueRef &value, ItemMeta &meta) {
+    _sketch.Increment(hash_of(key));
+    return _window.Get(key, value, meta) || _main.Get(key, value, meta);
+}
+
+uint64_t TinyLFU::hash_of(const std::string &key) { return std::hash<std::string>()(key); }
+
+size_t TinyLFU::window_size(size_t max_size) {
+    if (max_size < 2 * SimpleLRU::kMinSize) {
+        throw std::invalid_argument("Storage needs at least " + std::to_string(2 * SimpleLRU::kMinSize) +
+                                    " bytes of memory");
+    }
+
+    // Tiny storages still need a window able to keep a few items
+    size_t size = max_size / 100;
+    size_t min_size = max_size / 2 < 4096 ? max_size / 2 : 4096;
+    return size < min_size ? min_size : size;
+}
+
+} // namespace Backend
+} // namespace Afina
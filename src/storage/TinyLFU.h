@@ -0,0 +1,84 @@
+#ifndef AFINA_STORAGE_TINY_LFU_H
+#define AFINA_STORAGE_TINY_LFU_H
+
+#include <string>
+
+#include <afina/Storage.h>
+
+#include "FrequencySketch.h"
+#include "SimpleLRU.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # W-TinyLFU admission
+ * New keys land into a small window LRU (1% of the budget). Items evicted from the window are candidates
+ * for the main LRU, candidate is admitted only if it was seen more often than the item main storage
+ * would evict for it. Frequencies are estimated by the count-min sketch that counts every read and
+ * write, so the single pass scan over cold keys stays in the window and can't wash the hot set out.
+ * Both window and main storage need SimpleLRU::kMinSize at least.
+ *
+ * That is NOT thread safe implementaiton!!
+ */
+class TinyLFU : public Afina::Storage {
+public:
+    explicit TinyLFU(size_t max_size = 2 * SimpleLRU::kMinSize);
+    ~TinyLFU() {}
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value, uint32_t flags, int32_t expire) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value, uint32_t flags, int32_t expire) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value, uint32_t flags, int32_t expire) override;
+
+    // Implements Afina::Storage interface
+    CasResult CompareAndSet(const std::string &key, const std::string &value, uint32_t flags, int32_t expire,
+                            uint64_t cas) override;
+
+    // Implements Afina::Storage interface
+    bool Modify(const std::string &key, const ModifyCallback &modify) override;
+
+    // Implements Afina::Storage interface
+    bool Touch(const std::string &key, int32_t expire, ValueRef *value, ItemMeta *meta) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value, ItemMeta &meta) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, ValueRef &value, ItemMeta &meta) override;
+
+private:
+    // Expected size of the item, used to estimate how many keys sketch should track
+    static const size_t kAverageItemSize = 64;
+
+    static uint64_t hash_of(const std::string &key);
+    static size_t window_size(size_t max_size);
+
+    FrequencySketch _sketch;
+    SimpleLRU _window;
+    SimpleLRU _main;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_TINY_LFU_H
@@ -1,4 +1,5 @@
 #include "gtest/gtest.h"
+#include <algorithm>
 #include <iostream>
 #include <set>
 #include <vector>
@@ -124,6 +125,19 @@ TEST(SimpleTest, AllocReuse) {
     }
 }
 
+// Frees every n-th pointer, so that each slab page gets holes
+static void freeEach(Simple &a, vector<Pointer> &ptrs, size_t n) {
+    vector<Pointer> rest;
+    for (size_t i = 0; i < ptrs.size(); i++) {
+        if (i % n == 1) {
+            a.free(ptrs[i]);
+        } else {
+            rest.push_back(ptrs[i]);
+        }
+    }
+    ptrs.swap(rest);
+}
+
 TEST(SimpleTest, DefragMove) {
     Simple a(buf, sizeof(buf));
 
@@ -132,13 +146,7 @@ TEST(SimpleTest, DefragMove) {
     int size = 135;
 
     ASSERT_TRUE(fillUp(a, size, ptrs));
-    a.free(ptrs[1]);
-    a.free(ptrs[10]);
-    a.free(ptrs[15]);
-
-    ptrs.erase(ptrs.begin() + 15);
-    ptrs.erase(ptrs.begin() + 10);
-    ptrs.erase(ptrs.begin() + 1);
+    freeEach(a, ptrs, 3);
 
     for (Pointer &p : ptrs) {
         auto r = initialPtrs.insert(p.get());
@@ -197,14 +205,7 @@ TEST(SimpleTest, DefragAvailable) {
     int size = 135;
 
     ASSERT_TRUE(fillUp(a, size, ptrs));
-
-    a.free(ptrs[1]);
-    a.free(ptrs[10]);
-    a.free(ptrs[15]);
-
-    ptrs.erase(ptrs.begin() + 15);
-    ptrs.erase(ptrs.begin() + 10);
-    ptrs.erase(ptrs.begin() + 1);
+    freeEach(a, ptrs, 2);
 
     try {
         Pointer p = a.alloc(size * 2);
@@ -224,6 +225,44 @@ TEST(SimpleTest, DefragAvailable) {
     }
 }
 
+TEST(SimpleTest, ReclaimLeastUsedPage) {
+    Simple a(buf, sizeof(buf));
+
+    vector<Pointer> ptrs;
+    size_t size = 135;
+    ASSERT_TRUE(fillUp(a, size, ptrs));
+    EXPECT_EQ(a.alloc(1000, std::nothrow).get(), nullptr);
+
+    // First page is carved first, most of its chunks go away
+    for (size_t i = 0; i < 10; i++) {
+        if (i != 3 && i != 7) {
+            a.free(ptrs[i]);
+        }
+    }
+
+    set<void *> alive;
+    for (Pointer &p : ptrs) {
+        if (p.get() != nullptr) {
+            alive.insert(p.get());
+        }
+    }
+    vector<void *> chunks = a.reclaim(1000);
+    ASSERT_FALSE(chunks.empty());
+    EXPECT_LT(chunks.size(), alive.size() / 8);
+    EXPECT_NE(find(chunks.begin(), chunks.end(), ptrs[3].get()), chunks.end());
+    EXPECT_NE(find(chunks.begin(), chunks.end(), ptrs[7].get()), chunks.end());
+
+    // Freeing exactly those makes room for the other class
+    for (Pointer &p : ptrs) {
+        if (p.get() != nullptr && find(chunks.begin(), chunks.end(), p.get()) != chunks.end()) {
+            EXPECT_TRUE(alive.count(p.get()) == 1);
+            a.free(p);
+        }
+    }
+    Pointer large = a.alloc(1000, std::nothrow);
+    EXPECT_NE(large.get(), nullptr);
+}
+
 TEST(SimpleTest, ReallocFromEmpty) {
     Simple a(buf, sizeof(buf));
 
@@ -257,17 +296,21 @@ TEST(SimpleTest, ReallocGrowInplace) {
     Pointer p = a.alloc(size);
     writeTo(p, size);
 
+    // Growth inside of the size class chunk
+    size_t grown = a.chunk_size(size);
+    EXPECT_GE(grown, size);
+
     void *ptr = p.get();
-    a.realloc(p, size * 2);
+    a.realloc(p, grown);
 
     EXPECT_EQ(p.get(), ptr);
     EXPECT_TRUE(isDataOk(p, size));
 
     Pointer p2 = a.alloc(size);
-    writeTo(p, size * 2);
+    writeTo(p, grown);
     writeTo(p2, size);
 
-    EXPECT_TRUE(isDataOk(p, size * 2));
+    EXPECT_TRUE(isDataOk(p, grown));
     EXPECT_TRUE(isDataOk(p2, size));
 
     a.free(p);
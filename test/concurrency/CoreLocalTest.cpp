@@ -0,0 +1,63 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/CoreLocal.h>
+
+using namespace Afina::Concurrency;
+
+TEST(CoreLocalTest, Slots) {
+    CoreLocal<int> local;
+    ASSERT_EQ(NumberOfCores(), local.Size());
+    ASSERT_LT(CurrentCore() % local.Size(), local.Size());
+
+    // Slots are value initialized and distinct
+    int n = 0;
+    local.ForEach([&n](int &value) {
+        EXPECT_EQ(0, value);
+        value = ++n;
+    });
+    ASSERT_EQ(n * (n + 1) / 2, local.Aggregate(0, [](int sum, int value) { return sum + value; }));
+}
+
+// Every slot starts a cache line of its own, also when slots have destructors and array gets a cookie
+TEST(CoreLocalTest, SlotsAligned) {
+    std::vector<std::unique_ptr<CoreLocal<std::atomic<uint64_t>>>> counters;
+    std::vector<std::unique_ptr<CoreLocal<std::string>>> strings;
+    for (int i = 0; i < 100; i++) {
+        counters.emplace_back(new CoreLocal<std::atomic<uint64_t>>());
+        strings.emplace_back(new CoreLocal<std::string>());
+    }
+
+    for (size_t i = 0; i < counters.size(); i++) {
+        counters[i]->ForEach([](std::atomic<uint64_t> &value) { EXPECT_EQ(0, uintptr_t(&value) % 64); });
+        strings[i]->ForEach([](std::string &value) { EXPECT_EQ(0, uintptr_t(&value) % 64); });
+    }
+}
+
+// Increments from all threads are counted no matter which CPUs they run on and migrate to
+TEST(CoreLocalTest, Counter) {
+    const int n_threads = 8;
+    const int n_adds = 100000;
+
+    CoreCounter counter;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < n_threads; t++) {
+        threads.emplace_back([&counter]() {
+            for (int i = 0; i < n_adds; i++) {
+                counter.Add();
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    counter.Add(5);
+
+    ASSERT_EQ(uint64_t(n_threads) * n_adds + 5, counter.Get());
+}
@@ -0,0 +1,80 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <afina/concurrency/Executor.h>
+
+using namespace Afina::Concurrency;
+
+// Every task submitted from outside gets executed before Stop(true) returns
+TEST(ExecutorTest, RunsAll) {
+    std::atomic<int> done(0);
+    Executor executor("test", 2, 4, 10000, std::chrono::milliseconds(100));
+    for (int i = 0; i < 1000; i++) {
+        ASSERT_TRUE(executor.Execute([&done](int n) { done += n; }, 1));
+    }
+    executor.Stop(true);
+
+    ASSERT_EQ(1000, done.load());
+    ASSERT_EQ(Executor::State::kStopped, executor.GetState());
+    ASSERT_EQ(0, executor.Threads());
+    ASSERT_FALSE(executor.Execute([] {}));
+}
+
+// Tasks spawned by tasks go to the deque of the spawning thread, idle threads steal them
+TEST(ExecutorTest, NestedSteal) {
+    std::atomic<int> done(0);
+    Executor executor("test", 4, 4, 0, std::chrono::milliseconds(100));
+
+    std::function<void(int)> spread = [&](int depth) {
+        done++;
+        if (depth > 0) {
+            executor.Execute(spread, depth - 1);
+            executor.Execute(spread, depth - 1);
+        }
+    };
+    ASSERT_TRUE(executor.Execute(spread, 12));
+
+    for (int i = 0; i < 1000 && done.load() < (1 << 13) - 1; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    executor.Stop(true);
+    ASSERT_EQ((1 << 13) - 1, done.load());
+}
+
+// Pool grows up to high watermark, then queues, then rejects; idle threads exit down to low watermark
+TEST(ExecutorTest, Watermarks) {
+    std::mutex lock;
+    std::condition_variable cv;
+    bool release = false;
+    std::atomic<int> started(0);
+    auto block = [&] {
+        started++;
+        std::unique_lock<std::mutex> l(lock);
+        cv.wait(l, [&] { return release; });
+    };
+
+    Executor executor("test", 1, 3, 1, std::chrono::milliseconds(50));
+    ASSERT_EQ(1, executor.Threads());
+    for (int i = 0; i < 4; i++) {
+        ASSERT_TRUE(executor.Execute(block));
+    }
+    ASSERT_EQ(3, executor.Threads());
+    ASSERT_FALSE(executor.Execute(block));
+
+    {
+        std::lock_guard<std::mutex> l(lock);
+        release = true;
+    }
+    cv.notify_all();
+
+    for (int i = 0; i < 200 && (started.load() < 4 || executor.Threads() > 1); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(4, started.load());
+    ASSERT_EQ(1, executor.Threads());
+}
@@ -0,0 +1,111 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/FlatCombine.h>
+
+using namespace Afina::Concurrency;
+
+namespace {
+
+struct Add {
+    long delta;
+    long result;
+};
+
+} // namespace
+
+// Every operation is applied exactly once and sees the state left by the previous ones
+TEST(FlatCombineTest, Counter) {
+    const int n_threads = 8;
+    const int n_ops = 20000;
+
+    long counter = 0;
+    std::atomic<size_t> batches(0);
+    std::atomic<bool> inside(false);
+    FlatCombine<Add> combiner(
+        [&](Add *const *ops, size_t count) {
+            EXPECT_FALSE(inside.exchange(true));
+            for (size_t i = 0; i < count; i++) {
+                counter += ops[i]->delta;
+                ops[i]->result = counter;
+            }
+            batches++;
+            inside.store(false);
+        },
+        4);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < n_threads; t++) {
+        threads.emplace_back([&combiner]() {
+            long last = 0;
+            for (int i = 0; i < n_ops; i++) {
+                Add op{1, 0};
+                combiner.Execute(op);
+                // Counter only grows, so thread sees its own operations in order
+                EXPECT_GT(op.result, last);
+                last = op.result;
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    ASSERT_EQ(n_threads * n_ops, counter);
+    ASSERT_LE(batches.load(), size_t(n_threads * n_ops));
+}
+
+// Batch that throws fails all of its publishers and leaves combiner free for the next ones
+TEST(FlatCombineTest, ApplyThrows) {
+    const int n_threads = 8;
+    const int n_ops = 5000;
+
+    // Batch is applied all or nothing, negative delta fails it
+    long counter = 0;
+    FlatCombine<Add> combiner(
+        [&](Add *const *ops, size_t count) {
+            for (size_t i = 0; i < count; i++) {
+                if (ops[i]->delta < 0) {
+                    throw std::runtime_error("negative delta");
+                }
+            }
+            for (size_t i = 0; i < count; i++) {
+                counter += ops[i]->delta;
+                ops[i]->result = counter;
+            }
+        },
+        4);
+
+    Add bad{-1, 0};
+    EXPECT_THROW(combiner.Execute(bad), std::runtime_error);
+
+    std::atomic<long> applied(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < n_threads; t++) {
+        threads.emplace_back([&combiner, &applied, t]() {
+            for (int i = 0; i < n_ops; i++) {
+                bool fails = (i + t) % 7 == 0;
+                Add op{fails ? -1 : 1, 0};
+                try {
+                    combiner.Execute(op);
+                    EXPECT_FALSE(fails);
+                    applied++;
+                } catch (std::runtime_error &) {
+                }
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    ASSERT_EQ(applied.load(), counter);
+    Add good{1, 0};
+    combiner.Execute(good);
+    ASSERT_EQ(applied.load() + 1, good.result);
+}
@@ -0,0 +1,62 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/Mutex.h>
+
+using namespace Afina::Concurrency;
+
+TEST(MutexTest, TryLock) {
+    Mutex mutex("test.mutex.try_lock");
+    ASSERT_TRUE(mutex.try_lock());
+    ASSERT_FALSE(mutex.try_lock());
+    mutex.unlock();
+    ASSERT_TRUE(mutex.try_lock());
+    mutex.unlock();
+
+    LockProfile &profile = LockProfile::Get("test.mutex.try_lock");
+    ASSERT_EQ(2, profile.Acquisitions());
+    ASSERT_EQ(0, profile.Contended());
+}
+
+// Threads that wait for the lock, spinning or sleeping, get it one by one and show up in the profile
+TEST(MutexTest, Contention) {
+    const int n_threads = 8;
+    const int n_locks = 20000;
+
+    Mutex mutex("test.mutex.contention");
+    long counter = 0;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < n_threads; t++) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < n_locks; i++) {
+                std::lock_guard<Mutex> lock(mutex);
+                counter++;
+                // Let others queue up from time to time
+                if (i % 1000 == 0) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    ASSERT_EQ(n_threads * n_locks, counter);
+
+    LockProfile &profile = LockProfile::Get("test.mutex.contention");
+    ASSERT_EQ(uint64_t(n_threads) * n_locks, profile.Acquisitions());
+    ASSERT_GT(profile.Contended(), 0);
+    ASSERT_GT(profile.WaitTime(), 0);
+    ASSERT_GE(profile.WaitTime(), profile.MaxWaitTime());
+    ASSERT_GT(profile.HoldTime(), 0);
+
+    // Profiles are listed by name
+    std::vector<std::string> names;
+    LockProfile::ForEach([&names](const LockProfile &p) { names.push_back(p.Name()); });
+    ASSERT_TRUE(std::is_sorted(names.begin(), names.end()));
+    ASSERT_NE(names.end(), std::find(names.begin(), names.end(), "test.mutex.contention"));
+}
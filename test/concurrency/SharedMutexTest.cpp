@@ -0,0 +1,79 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/SharedMutex.h>
+
+using namespace Afina::Concurrency;
+
+// Readers hold lock together, writer waits for them and keeps new readers out
+TEST(SharedMutexTest, Exclusion) {
+    SharedMutex mutex;
+
+    mutex.lock_shared();
+    ASSERT_TRUE(mutex.try_lock_shared());
+    ASSERT_FALSE(mutex.try_lock());
+    mutex.unlock_shared();
+
+    std::atomic<bool> locked(false);
+    std::thread writer([&]() {
+        std::lock_guard<SharedMutex> lock(mutex);
+        locked = true;
+    });
+
+    // Once writer is waiting, new readers back off. Writer still waits for the one that is inside
+    while (mutex.try_lock_shared()) {
+        mutex.unlock_shared();
+        std::this_thread::yield();
+    }
+    ASSERT_FALSE(locked.load());
+    mutex.unlock_shared();
+    writer.join();
+    ASSERT_TRUE(locked.load());
+
+    ASSERT_TRUE(mutex.try_lock());
+    ASSERT_FALSE(mutex.try_lock_shared());
+    mutex.unlock();
+    ASSERT_TRUE(mutex.try_lock_shared());
+    mutex.unlock_shared();
+}
+
+// Writers change a pair of values that readers must always see equal
+TEST(SharedMutexTest, ReadersAndWriters) {
+    const int n_readers = 6;
+    const int n_writers = 2;
+    const int n_writes = 20000;
+
+    SharedMutex mutex;
+    long first = 0, second = 0;
+    std::atomic<int> writers_left(n_writers);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < n_writers; t++) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < n_writes; i++) {
+                std::lock_guard<SharedMutex> lock(mutex);
+                first++;
+                second++;
+            }
+            writers_left--;
+        });
+    }
+    for (int t = 0; t < n_readers; t++) {
+        threads.emplace_back([&]() {
+            while (writers_left.load() > 0) {
+                SharedLock lock(mutex);
+                EXPECT_EQ(first, second);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    ASSERT_EQ(n_writers * n_writes, first);
+    ASSERT_EQ(first, second);
+}
@@ -0,0 +1,98 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/ThreadLocal.h>
+
+using namespace Afina::Concurrency;
+
+namespace {
+
+// Counts instances alive
+struct Tracked {
+    explicit Tracked(std::atomic<int> &alive) : alive(alive), value(0) { alive++; }
+    ~Tracked() { alive--; }
+
+    std::atomic<int> &alive;
+    std::atomic<int> value;
+};
+
+} // namespace
+
+// Every thread gets a value of its own, others see all of them while threads are alive
+TEST(ThreadLocalTest, ForEach) {
+    const int n_threads = 4;
+
+    std::atomic<int> alive(0);
+    ThreadLocal<Tracked> local([&alive]() { return std::unique_ptr<Tracked>(new Tracked(alive)); });
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    int ready = 0;
+    bool done = false;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < n_threads; t++) {
+        threads.emplace_back([&, t]() {
+            ASSERT_EQ(&local.Get(), &local.Get());
+            local.Get().value = t + 1;
+
+            std::unique_lock<std::mutex> lock(mutex);
+            ready++;
+            cv.notify_all();
+            cv.wait(lock, [&done]() { return done; });
+        });
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&ready]() { return ready == n_threads; });
+    }
+
+    int sum = 0;
+    local.ForEach([&sum](Tracked &tracked) { sum += tracked.value; });
+    ASSERT_EQ(n_threads * (n_threads + 1) / 2, sum);
+    ASSERT_EQ(n_threads, local.Size());
+    ASSERT_EQ(n_threads, alive.load());
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        done = true;
+        cv.notify_all();
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    // Values are gone along with their threads
+    ASSERT_EQ(0, local.Size());
+    ASSERT_EQ(0, alive.load());
+}
+
+// Values of instance destroyed before the thread exits are released by the instance, new instance starts over
+TEST(ThreadLocalTest, InstanceDestroyed) {
+    std::atomic<int> alive(0);
+    auto factory = [&alive]() { return std::unique_ptr<Tracked>(new Tracked(alive)); };
+
+    std::thread thread([&]() {
+        for (int i = 0; i < 3; i++) {
+            ThreadLocal<Tracked> local(factory);
+            ASSERT_EQ(0, local.Get().value.load());
+            local.Get().value = 1;
+            ASSERT_EQ(1, alive.load());
+        }
+        ASSERT_EQ(0, alive.load());
+
+        ThreadLocal<Tracked> first(factory), second(factory);
+        first.Get().value = 1;
+        second.Get().value = 2;
+        ASSERT_EQ(1, first.Get().value.load());
+        ASSERT_EQ(2, second.Get().value.load());
+    });
+    thread.join();
+    ASSERT_EQ(0, alive.load());
+}
@@ -0,0 +1,259 @@
+#include "gtest/gtest.h"
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/Mutex.h>
+#include <afina/execute/Cas.h>
+#include <afina/execute/Decr.h>
+#include <afina/execute/Delete.h>
+#include <afina/execute/Gat.h>
+#include <afina/execute/Get.h>
+#include <afina/execute/Incr.h>
+#include <afina/execute/Prepend.h>
+#include <afina/execute/Set.h>
+#include <afina/execute/Stats.h>
+#include <afina/execute/Touch.h>
+
+#include "storage/FlatCombinedLRU.h"
+#include "storage/RCUClock.h"
+#include "storage/ShardedLRU.h"
+#include "storage/SharedClockLRU.h"
+#include "storage/SimpleLRU.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+
+using namespace Afina;
+using namespace Afina::Backend;
+using namespace Afina::Execute;
+
+// Values come from the network with trailing \r\n, commands keep it
+TEST(CommandsTest, DeleteAndPrepend) {
+    SimpleLRU storage;
+    std::string out;
+
+    Set("k", 7, 0).Execute(storage, "world\r\n", out);
+    Prepend("k", 0, 0).Execute(storage, "hello \r\n", out);
+    ASSERT_EQ("STORED", out);
+    Get({"k"}).Execute(storage, "", out);
+    ASSERT_EQ("VALUE k 7 11\r\nhello world\r\nEND", out);
+
+    Prepend("none", 0, 0).Execute(storage, "x\r\n", out);
+    ASSERT_EQ("NOT_STORED", out);
+
+    Delete("k").Execute(storage, "", out);
+    ASSERT_EQ("DELETED", out);
+    Delete("k").Execute(storage, "", out);
+    ASSERT_EQ("NOT_FOUND", out);
+}
+
+TEST(CommandsTest, IncrDecr) {
+    SimpleLRU storage;
+    std::string out;
+
+    Incr("n", 1).Execute(storage, "", out);
+    ASSERT_EQ("NOT_FOUND", out);
+
+    Set("n", 0, 0).Execute(storage, "10\r\n", out);
+    Incr("n", 5).Execute(storage, "", out);
+    ASSERT_EQ("15", out);
+    Decr("n", 20).Execute(storage, "", out);
+    ASSERT_EQ("0", out);
+
+    Set("n", 0, 0).Execute(storage, "18446744073709551615\r\n", out);
+    Incr("n", 2).Execute(storage, "", out);
+    ASSERT_EQ("1", out);
+
+    Set("s", 0, 0).Execute(storage, "abc\r\n", out);
+    Incr("s", 1).Execute(storage, "", out);
+    ASSERT_EQ(0, out.find("CLIENT_ERROR"));
+}
+
+TEST(CommandsTest, CasAndGets) {
+    SimpleLRU storage;
+    std::string out;
+
+    Cas("k", 0, 0, 1).Execute(storage, "v\r\n", out);
+    ASSERT_EQ("NOT_FOUND", out);
+
+    Set("k", 0, 0).Execute(storage, "v\r\n", out);
+    std::string value;
+    ItemMeta meta;
+    ASSERT_TRUE(storage.Get("k", value, meta));
+
+    Get({"k"}, true).Execute(storage, "", out);
+    ASSERT_EQ("VALUE k 0 1 " + std::to_string(meta.cas) + "\r\nv\r\nEND", out);
+
+    Cas("k", 0, 0, meta.cas + 1).Execute(storage, "w\r\n", out);
+    ASSERT_EQ("EXISTS", out);
+    Cas("k", 3, 0, meta.cas).Execute(storage, "w\r\n", out);
+    ASSERT_EQ("STORED", out);
+    Cas("k", 3, 0, meta.cas).Execute(storage, "x\r\n", out);
+    ASSERT_EQ("EXISTS", out);
+
+    Get({"k"}).Execute(storage, "", out);
+    ASSERT_EQ("VALUE k 3 1\r\nw\r\nEND", out);
+}
+
+TEST(CommandsTest, TouchAndGat) {
+    SimpleLRU storage;
+    std::string out;
+
+    Touch("k", 100).Execute(storage, "", out);
+    ASSERT_EQ("NOT_FOUND", out);
+
+    Set("k", 5, 0).Execute(storage, "v\r\n", out);
+    std::string value;
+    ItemMeta meta;
+    ASSERT_TRUE(storage.Get("k", value, meta));
+    uint64_t cas = meta.cas;
+
+    Touch("k", 100).Execute(storage, "", out);
+    ASSERT_EQ("TOUCHED", out);
+    ASSERT_TRUE(storage.Get("k", value, meta));
+    ASSERT_EQ(5, meta.flags);
+    ASSERT_NE(0, meta.deadline);
+    ASSERT_EQ(cas, meta.cas);
+
+    Gat(0, {"k", "none"}).Execute(storage, "", out);
+    ASSERT_EQ("VALUE k 5 1\r\nv\r\nEND", out);
+    ASSERT_TRUE(storage.Get("k", value, meta));
+    ASSERT_EQ(0, meta.deadline);
+
+    // Negative expire time makes item expired at once
+    Gat(-1, {"k"}).Execute(storage, "", out);
+    Get({"k"}).Execute(storage, "", out);
+    ASSERT_EQ("END", out);
+}
+
+// Sharded storage reports keys shard by shard, response still goes in the order of keys
+TEST(CommandsTest, MultiGetOrder) {
+    ShardedLRU storage(1024 * 64, 8);
+    std::vector<std::string> keys;
+    std::string expected;
+    for (int i = 0; i < 16; i++) {
+        std::string value = std::to_string(i);
+        keys.push_back("k" + value);
+        storage.Put(keys.back(), value + "\r\n");
+        expected += "VALUE k" + value + " 0 " + std::to_string(value.size()) + "\r\n" + value + "\r\n";
+    }
+    keys.push_back("missing");
+    keys.push_back("k3");
+    expected += "VALUE k3 0 1\r\n3\r\nEND";
+
+    std::string out;
+    Get(keys).Execute(storage, "", out);
+    ASSERT_EQ(expected, out);
+}
+
+// Combiner runs lookups of other threads, every item must still land into the response of its own command
+TEST(CommandsTest, MultiGetCombined) {
+    const int n_threads = 8;
+    FlatCombinedLRU storage(1024 * 64);
+    std::vector<std::string> keys;
+    std::string expected;
+    for (int i = 0; i < 24; i++) {
+        std::string value = std::to_string(i);
+        keys.push_back("k" + value);
+        storage.Put(keys.back(), value + "\r\n");
+        expected += "VALUE k" + value + " 0 " + std::to_string(value.size()) + "\r\n" + value + "\r\n";
+    }
+    expected += "END";
+
+    // Some threads fit into the buffer on the stack, some don't
+    std::vector<int> mismatches(n_threads, 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < n_threads; t++) {
+        threads.emplace_back([&, t]() {
+            size_t count = t % 2 == 0 ? 16 : keys.size();
+            std::string want = t % 2 == 0 ? expected.substr(0, expected.find("VALUE k16 ")) + "END" : expected;
+            std::string out;
+            for (int i = 0; i < 2000; i++) {
+                Get(keys.data(), count).Execute(storage, "", out);
+                mismatches[t] += out != want;
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    for (int t = 0; t < n_threads; t++) {
+        EXPECT_EQ(0, mismatches[t]) << "thread " << t;
+    }
+}
+
+// Concurrent incr, cas and touch of the same keys must not lose any update
+template <typename Storage> void ConcurrentUpdates() {
+    const int n_threads = 4, n_updates = 500;
+    Storage storage(1024 * 64);
+    storage.Put("incr", "0\r\n");
+    storage.Put("cas", "0\r\n");
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < n_threads; t++) {
+        threads.emplace_back([&storage]() {
+            std::string out, value;
+            ItemMeta meta;
+            for (int i = 0; i < n_updates; i++) {
+                Incr("incr", 1).Execute(storage, "", out);
+                Touch("incr", 0).Execute(storage, "", out);
+                do {
+                    storage.Get("cas", value, meta);
+                    Cas("cas", 0, 0, meta.cas).Execute(storage, std::to_string(std::stoul(value) + 1) + "\r\n", out);
+                } while (out == "EXISTS");
+                Touch("cas", 0).Execute(storage, "", out);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    std::string expected = std::to_string(n_threads * n_updates) + "\r\n", value;
+    ASSERT_TRUE(storage.Get("incr", value));
+    EXPECT_EQ(expected, value);
+    ASSERT_TRUE(storage.Get("cas", value));
+    EXPECT_EQ(expected, value);
+}
+
+TEST(CommandsTest, ConcurrentUpdatesLocked) { ConcurrentUpdates<ThreadSafeSimplLRU>(); }
+TEST(CommandsTest, ConcurrentUpdatesShared) { ConcurrentUpdates<SharedClockLRU>(); }
+TEST(CommandsTest, ConcurrentUpdatesSharded) { ConcurrentUpdates<ShardedLRU>(); }
+TEST(CommandsTest, ConcurrentUpdatesCombined) { ConcurrentUpdates<FlatCombinedLRU>(); }
+TEST(CommandsTest, ConcurrentUpdatesRCU) { ConcurrentUpdates<RCUClock>(); }
+
+// Counters are server wide, so only the change made by the test is checked
+TEST(CommandsTest, StatsGetHits) {
+    SimpleLRU storage;
+    Stats::Counters &counters = Stats::Global();
+    uint64_t hits = counters.get_hits.Get();
+    uint64_t misses = counters.get_misses.Get();
+
+    std::string out;
+    Set("a", 0, 0).Execute(storage, "1\r\n", out);
+    Get({"a", "b", "a"}).Execute(storage, "", out);
+    ASSERT_EQ(hits + 2, counters.get_hits.Get());
+    ASSERT_EQ(misses + 1, counters.get_misses.Get());
+
+    Stats().Execute(storage, "", out);
+    ASSERT_NE(std::string::npos, out.find("STAT get_hits " + std::to_string(hits + 2) + "\r\n"));
+    ASSERT_EQ("END", out.substr(out.size() - 3));
+}
+
+// Every named lock gets its counters, locks of the same name share them
+TEST(CommandsTest, StatsLocks) {
+    Concurrency::Mutex first("test.commands"), second("test.commands");
+    for (int i = 0; i < 3; i++) {
+        std::lock_guard<Concurrency::Mutex> lock(i % 2 == 0 ? first : second);
+    }
+
+    SimpleLRU storage;
+    std::string out;
+    Stats(Stats::Group::kLocks).Execute(storage, "", out);
+    ASSERT_NE(std::string::npos, out.find("STAT test.commands:acquired 3\r\n"));
+    ASSERT_NE(std::string::npos, out.find("STAT test.commands:contended 0\r\n"));
+    ASSERT_NE(std::string::npos, out.find("STAT test.commands:hold_ns "));
+    ASSERT_EQ(std::string::npos, out.find("get_hits"));
+    ASSERT_EQ("END", out.substr(out.size() - 3));
+}
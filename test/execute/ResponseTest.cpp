@@ -0,0 +1,105 @@
+#include "gtest/gtest.h"
+
+#include <string>
+#include <vector>
+
+#include <afina/execute/Get.h>
+#include <afina/execute/Response.h>
+
+#include "storage/RCUClock.h"
+#include "storage/SimpleLRU.h"
+
+using namespace Afina;
+using namespace Afina::Backend;
+using namespace Afina::Execute;
+
+namespace {
+
+std::string Flatten(const Response &response, size_t offset) {
+    std::vector<struct iovec> iov(16);
+    iov.resize(response.Fill(&iov[0], iov.size(), offset));
+
+    std::string result;
+    for (auto &v : iov) {
+        result.append(static_cast<char *>(v.iov_base), v.iov_len);
+    }
+    return result;
+}
+
+} // namespace
+
+TEST(ResponseTest, Segments) {
+    std::string value(Response::kInlineValueSize + 1, 'v');
+
+    Response response;
+    response.Append("VALUE ");
+    response.Append("key\r\n");
+    response.Append(ValueRef::Copy(value.data(), value.size()));
+    response.Append("\r\nEND", 5);
+    EXPECT_EQ(16 + value.size(), response.Size());
+
+    // Text written one after another goes by the single vector
+    struct iovec iov[8];
+    EXPECT_EQ(3, response.Fill(iov, 8, 0));
+    EXPECT_EQ(1, response.Fill(iov, 1, 0));
+
+    EXPECT_EQ("VALUE key\r\n" + value + "\r\nEND", Flatten(response, 0));
+    EXPECT_EQ("vv\r\nEND", Flatten(response, 9 + value.size()));
+    EXPECT_EQ("", Flatten(response, response.Size()));
+
+    std::string out = "> ";
+    response.AppendTo(out);
+    EXPECT_EQ("> VALUE key\r\n" + value + "\r\nEND", out);
+}
+
+TEST(ResponseTest, SmallValuesInline) {
+    std::string value = "value";
+
+    // Responses of pipelined commands run together with small values copied in
+    Response response;
+    for (int i = 0; i < 3; i++) {
+        response.Append("VALUE key\r\n");
+        response.Append(ValueRef::Copy(value.data(), value.size()));
+        response.Append("\r\nEND\r\n");
+    }
+
+    struct iovec iov[8];
+    EXPECT_EQ(1, response.Fill(iov, 8, 0));
+    EXPECT_EQ(3 * 23, response.Size());
+    EXPECT_EQ("END\r\nVALUE key\r\nvalue\r\nEND\r\n", Flatten(response, 41));
+}
+
+TEST(ResponseTest, GetFlags) {
+    SimpleLRU storage(1024 * 64);
+    storage.Put("a", "first", 17, 0);
+    storage.Put("b", "second\r\n", 0, 0);
+
+    // Command references keys, they have to outlive it
+    std::vector<std::string> keys = {"a", "missing", "b"};
+    Get command(keys);
+    std::string out;
+    command.Execute(storage, "", out);
+    EXPECT_EQ("VALUE a 17 5\r\nfirst\r\nVALUE b 0 6\r\nsecond\r\nEND", out);
+}
+
+TEST(ResponseTest, ValueOutlivesItem) {
+    RCUClock storage(4096);
+    std::string value(Response::kInlineValueSize + 1, 'v');
+    storage.Put("key", value);
+
+    Response response;
+    std::vector<std::string> keys = {"key"};
+    Get command(keys);
+    command.Execute(storage, "", response);
+
+    // Response still references the old item
+    storage.Put("key", "other");
+    storage.Delete("key");
+    for (int i = 0; i < 1000; i++) {
+        storage.Put("Key " + std::to_string(i), "filler");
+    }
+
+    std::string out;
+    response.AppendTo(out);
+    EXPECT_EQ("VALUE key 0 " + std::to_string(value.size()) + "\r\n" + value + "\r\nEND", out);
+}
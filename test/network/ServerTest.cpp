@@ -0,0 +1,252 @@
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <afina/logging/Config.h>
+#include <afina/network/Server.h>
+
+#include "logging/ServiceImpl.h"
+#include "network/mt_nonblocking/ServerImpl.h"
+#include "network/st_nonblocking/ServerImpl.h"
+#include "network/uring/Ring.h"
+#include "network/uring/ServerImpl.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+
+using namespace Afina;
+
+namespace {
+
+// Loggers are registered globally, so all the servers share one service
+std::shared_ptr<Logging::Service> Logs() {
+    static std::shared_ptr<Logging::Service> service = []() {
+        std::shared_ptr<Logging::Config> config(new Logging::Config);
+        Logging::Appender &console = config->appenders["console"];
+        console.type = Logging::Appender::Type::STDERR;
+        console.color = false;
+
+        Logging::Logger &logger = config->loggers["root"];
+        logger.level = Logging::Logger::Level::ERROR;
+        logger.appenders.push_back("console");
+        logger.format = "[%H:%M:%S %z] [thread %t] [%n] [%l] %v";
+
+        std::shared_ptr<Logging::Service> result(new Logging::ServiceImpl(config));
+        result->Start();
+        return result;
+    }();
+    return service;
+}
+
+// Port nobody listens on right now, engines bind it by themselves
+uint16_t FreePort() {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    socklen_t size = sizeof(address);
+    if (bind(fd, reinterpret_cast<sockaddr *>(&address), size) != 0 ||
+        getsockname(fd, reinterpret_cast<sockaddr *>(&address), &size) != 0) {
+        close(fd);
+        throw std::runtime_error("Failed to find free port");
+    }
+    close(fd);
+    return ntohs(address.sin_port);
+}
+
+// Blocking connection to the server, every read gives up after a few seconds
+class Client {
+public:
+    explicit Client(uint16_t port) : _fd(-1) {
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(port);
+
+        // Workers may still be on the way to listen
+        for (int attempt = 0; attempt < 100 && _fd == -1; attempt++) {
+            _fd = socket(AF_INET, SOCK_STREAM, 0);
+            if (connect(_fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) {
+                close(_fd);
+                _fd = -1;
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        }
+        if (_fd == -1) {
+            throw std::runtime_error("Failed to connect");
+        }
+
+        timeval timeout = {5, 0};
+        setsockopt(_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    }
+    ~Client() { close(_fd); }
+
+    void Send(const std::string &data) {
+        for (size_t sent = 0; sent < data.size();) {
+            ssize_t n = send(_fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) {
+                throw std::runtime_error("Failed to send");
+            }
+            sent += n;
+        }
+    }
+
+    // Reads exactly size bytes unless server goes silent or closes connection
+    std::string Read(size_t size) {
+        std::string result(size, '\0');
+        size_t done = 0;
+        while (done < size) {
+            ssize_t n = recv(_fd, &result[done], size - done, 0);
+            if (n <= 0) {
+                break;
+            }
+            done += n;
+        }
+        result.resize(done);
+        return result;
+    }
+
+private:
+    int _fd;
+};
+
+// Runs set/get, a pipelined batch and a command split over several writes from a few clients at once, then
+// a malformed command
+void Exchange(Network::Server &server, uint16_t port, size_t n_clients) {
+    std::vector<std::thread> clients;
+    std::vector<std::string> failures(n_clients);
+    for (size_t c = 0; c < n_clients; c++) {
+        clients.emplace_back([port, c, &failures]() {
+            try {
+                Client client(port);
+                std::string key = "key" + std::to_string(c);
+
+                client.Send("set " + key + " 3 0 5\r\nvalue\r\nget " + key + "\r\n");
+                std::string expected = "STORED\r\nVALUE " + key + " 3 5\r\nvalue\r\nEND\r\n";
+                std::string answer = client.Read(expected.size());
+                if (answer != expected) {
+                    failures[c] = "set/get: " + answer;
+                    return;
+                }
+
+                std::string batch, batch_expected;
+                for (int i = 0; i < 100; i++) {
+                    std::string k = key + "." + std::to_string(i);
+                    batch += "set " + k + " 0 0 1\r\nx\r\nget " + k + "\r\n";
+                    batch_expected += "STORED\r\nVALUE " + k + " 0 1\r\nx\r\nEND\r\n";
+                }
+                client.Send(batch);
+                answer = client.Read(batch_expected.size());
+                if (answer != batch_expected) {
+                    failures[c] = "pipeline: " + answer.substr(0, 200);
+                    return;
+                }
+
+                std::string split = "get " + key + "\r\n";
+                for (char ch : split) {
+                    client.Send(std::string(1, ch));
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                expected = "VALUE " + key + " 3 5\r\nvalue\r\nEND\r\n";
+                answer = client.Read(expected.size());
+                if (answer != expected) {
+                    failures[c] = "split: " + answer;
+                }
+            } catch (std::exception &e) {
+                failures[c] = e.what();
+            }
+        });
+    }
+    for (auto &t : clients) {
+        t.join();
+    }
+
+    // Command that can't be parsed gets a proper error line, then connection is closed
+    {
+        Client client(port);
+        client.Send("bogus key\r\n");
+        std::string answer = client.Read(1024);
+        EXPECT_EQ("CLIENT_ERROR Unknown command name: bogus\r\n", answer);
+    }
+
+    server.Stop();
+    server.Join();
+    for (size_t c = 0; c < n_clients; c++) {
+        EXPECT_EQ("", failures[c]) << "client " << c;
+    }
+}
+
+std::shared_ptr<Afina::Storage> MakeStorage() {
+    return std::make_shared<Backend::ThreadSafeSimplLRU>(1024 * 1024);
+}
+
+} // namespace
+
+TEST(ServerTest, UringSingleThread) {
+    if (!Network::Uring::Supported()) {
+        std::cerr << "io_uring is not available, skipped" << std::endl;
+        return;
+    }
+
+    uint16_t port = FreePort();
+    Network::Uring::ServerImpl server(MakeStorage(), Logs(), true);
+    server.Start(port, 1, 1);
+    Exchange(server, port, 4);
+}
+
+TEST(ServerTest, UringWorkers) {
+    if (!Network::Uring::Supported()) {
+        std::cerr << "io_uring is not available, skipped" << std::endl;
+        return;
+    }
+
+    uint16_t port = FreePort();
+    Network::Uring::ServerImpl server(MakeStorage(), Logs());
+    server.Start(port, 1, 3);
+    Exchange(server, port, 8);
+}
+
+// Engines uring falls back to when kernel can't run it
+TEST(ServerTest, NonblockingSingleThread) {
+    uint16_t port = FreePort();
+    Network::STnonblock::ServerImpl server(MakeStorage(), Logs());
+    server.Start(port, 1, 1);
+    Exchange(server, port, 4);
+}
+
+TEST(ServerTest, ReusePortWorkers) {
+    uint16_t port = FreePort();
+    Network::MTnonblock::ServerImpl server(MakeStorage(), Logs(), Network::MTnonblock::ServerImpl::Mode::kReusePort);
+    server.Start(port, 1, 3);
+    Exchange(server, port, 8);
+}
+
+// Worker that can't bind reports it from Start, server still goes down cleanly
+TEST(ServerTest, ReusePortBusy) {
+    uint16_t port = FreePort();
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    ASSERT_EQ(0, bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)));
+    ASSERT_EQ(0, listen(fd, 1));
+
+    {
+        Network::MTnonblock::ServerImpl server(MakeStorage(), Logs(),
+                                               Network::MTnonblock::ServerImpl::Mode::kReusePort);
+        EXPECT_THROW(server.Start(port, 1, 3), std::runtime_error);
+    }
+    close(fd);
+}
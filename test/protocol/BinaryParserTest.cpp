@@ -0,0 +1,191 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+
+#include <afina/execute/Command.h>
+#include <afina/execute/Response.h>
+
+#include <protocol/Parser.h>
+#include <storage/SimpleLRU.h>
+
+using namespace Afina;
+
+namespace {
+
+std::string Number(uint64_t value, size_t size) {
+    std::string result(size, '\0');
+    for (size_t i = size; i > 0; i--) {
+        result[i - 1] = char(value & 0xff);
+        value >>= 8;
+    }
+    return result;
+}
+
+uint64_t Load(const std::string &data, size_t offset, size_t size) {
+    uint64_t result = 0;
+    for (size_t i = 0; i < size; i++) {
+        result = (result << 8) | uint8_t(data[offset + i]);
+    }
+    return result;
+}
+
+std::string Request(uint8_t opcode, const std::string &extras, const std::string &key, const std::string &value,
+                    uint32_t opaque = 0) {
+    std::string header = Number(0x80, 1) + Number(opcode, 1) + Number(key.size(), 2) + Number(extras.size(), 1) +
+                         Number(0, 3) + Number(extras.size() + key.size() + value.size(), 4) + Number(opaque, 4) +
+                         Number(0, 8);
+    return header + extras + key + value;
+}
+
+// Feeds requests to the parser in pieces of chunk bytes the way connections do, returns all the responses
+std::string Process(Protocol::Parser &parser, Storage &storage, const std::string &input, size_t chunk) {
+    Execute::Response output;
+    Execute::Command *command = nullptr;
+    std::string argument;
+    size_t arg_remains = 0;
+    for (size_t pos = 0; pos < input.size();) {
+        size_t size = std::min(chunk, input.size() - pos);
+        if (command == nullptr) {
+            size_t parsed = 0;
+            if (parser.Parse(input.data() + pos, size, parsed)) {
+                command = parser.Build(arg_remains);
+                arg_remains += parser.Trailer();
+            }
+            pos += parsed;
+            size -= parsed;
+        }
+        if (command != nullptr && arg_remains > 0) {
+            size_t to_read = std::min(arg_remains, size);
+            argument.append(input.data() + pos, to_read);
+            pos += to_read;
+            arg_remains -= to_read;
+        }
+        if (command != nullptr && arg_remains == 0) {
+            parser.Run(storage, argument, output);
+            command = nullptr;
+            argument.clear();
+            parser.Reset();
+        }
+    }
+
+    std::string result;
+    output.AppendTo(result);
+    return result;
+}
+
+} // namespace
+
+// Verify stored value is returned with its flags, whole and split requests
+TEST(BinaryParserTest, SetGet) {
+    std::string input = Request(0x01, Number(17, 4) + Number(0, 4), "key", "value", 7) +
+                        Request(0x00, "", "key", "", 8) + Request(0x0c, "", "key", "", 9);
+    for (size_t chunk : {input.size(), size_t(1), size_t(5)}) {
+        Backend::SimpleLRU storage;
+        Protocol::Parser parser;
+        std::string out = Process(parser, storage, input, chunk);
+
+        // set: header only
+        ASSERT_EQ(24 + 33 + 36, out.size());
+        ASSERT_EQ(0x81, uint8_t(out[0]));
+        ASSERT_EQ(0x01, uint8_t(out[1]));
+        ASSERT_EQ(0, Load(out, 6, 2));
+        ASSERT_EQ(7, Load(out, 12, 4));
+
+        // get: flags in extras, then value
+        std::string get = out.substr(24, 33);
+        ASSERT_EQ(0, Load(get, 6, 2));
+        ASSERT_EQ(4, Load(get, 4, 1));
+        ASSERT_EQ(9, Load(get, 8, 4));
+        ASSERT_EQ(8, Load(get, 12, 4));
+        ASSERT_NE(0, Load(get, 16, 8));
+        ASSERT_EQ(17, Load(get, 24, 4));
+        ASSERT_EQ("value", get.substr(28));
+
+        // getk: key goes before the value
+        std::string getk = out.substr(24 + 33);
+        ASSERT_EQ(3, Load(getk, 2, 2));
+        ASSERT_EQ("keyvalue", getk.substr(28));
+    }
+}
+
+// Verify keys and values that text protocol can't carry come back as they are
+TEST(BinaryParserTest, BinaryKeys) {
+    std::string key("a \r\nVALUE b 1 2 3\r\n\0", 21);
+    std::string value = "x\r\nEND\r\n y";
+    Backend::SimpleLRU storage;
+    Protocol::Parser parser;
+    std::string input = Request(0x01, Number(3, 4) + Number(0, 4), key, value, 1) + Request(0x0c, "", key, "", 2) +
+                        Request(0x05, Number(1, 8) + Number(0, 8) + Number(0, 4), key, "", 3);
+    std::string out;
+    ASSERT_NO_THROW(out = Process(parser, storage, input, 1024));
+
+    std::string getk = out.substr(24);
+    ASSERT_EQ(0, Load(getk, 6, 2));
+    ASSERT_EQ(2, Load(getk, 12, 4));
+    ASSERT_EQ(key.size(), Load(getk, 2, 2));
+    ASSERT_EQ(3, Load(getk, 24, 4));
+    ASSERT_EQ(key + value, getk.substr(28, key.size() + value.size()));
+
+    // incr of the value that is not a number
+    std::string incr = getk.substr(28 + key.size() + value.size());
+    ASSERT_EQ(0x06, Load(incr, 6, 2));
+    ASSERT_EQ(3, Load(incr, 12, 4));
+}
+
+// Verify quiet requests answer only on miss or failure, noop closes the batch
+TEST(BinaryParserTest, QuietBatch) {
+    Backend::SimpleLRU storage;
+    storage.Put("a", "1\r\n");
+
+    Protocol::Parser parser;
+    std::string out = Process(parser, storage,
+                              Request(0x11, Number(0, 8), "b", "2") + Request(0x09, "", "missing", "") +
+                                  Request(0x0d, "", "a", "", 1) + Request(0x0d, "", "b", "", 2) +
+                                  Request(0x0a, "", "", "", 3),
+                              1024);
+
+    ASSERT_EQ(3 * 24 + 4 + 2 + 4 + 2, out.size());
+    ASSERT_EQ(1, Load(out, 12, 4));
+    ASSERT_EQ("a1", out.substr(28, 2));
+    ASSERT_EQ(2, Load(out, 30 + 12, 4));
+    ASSERT_EQ("b2", out.substr(30 + 28, 2));
+    ASSERT_EQ(0x0a, uint8_t(out[60 + 1]));
+    ASSERT_EQ(3, Load(out, 60 + 12, 4));
+}
+
+// Verify incr creates missing item from initial value and then changes it
+TEST(BinaryParserTest, Incr) {
+    Backend::SimpleLRU storage;
+    Protocol::Parser parser;
+    std::string extras = Number(5, 8) + Number(10, 8) + Number(0, 4);
+    std::string out = Process(parser, storage, Request(0x05, extras, "n", "") + Request(0x05, extras, "n", ""), 1024);
+
+    ASSERT_EQ(2 * 32, out.size());
+    ASSERT_EQ(10, Load(out, 24, 8));
+    ASSERT_EQ(15, Load(out, 32 + 24, 8));
+
+    std::string value;
+    ASSERT_TRUE(storage.Get("n", value));
+    ASSERT_EQ("15\r\n", value);
+}
+
+// Verify errors are reported by status and request body is skipped
+TEST(BinaryParserTest, Errors) {
+    Backend::SimpleLRU storage;
+    Protocol::Parser parser;
+    std::string out = Process(parser, storage,
+                              Request(0x42, "xx", "key", "value") + Request(0x01, "", "key", "value") +
+                                  Request(0x00, "", "missing", "") + Request(0x0a, "", "", ""),
+                              1024);
+
+    size_t pos = 0;
+    ASSERT_EQ(0x81, Load(out, pos + 6, 2));
+    pos += 24 + Load(out, pos + 8, 4);
+    ASSERT_EQ(0x04, Load(out, pos + 6, 2));
+    pos += 24 + Load(out, pos + 8, 4);
+    ASSERT_EQ(0x01, Load(out, pos + 6, 2));
+    pos += 24 + Load(out, pos + 8, 4);
+    ASSERT_EQ(0x0a, uint8_t(out[pos + 1]));
+    ASSERT_EQ(pos + 24, out.size());
+}
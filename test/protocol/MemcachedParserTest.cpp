@@ -1,12 +1,19 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <memory>
 #include <string>
 
 #include <afina/execute/Add.h>
+#include <afina/execute/Cas.h>
+#include <afina/execute/Decr.h>
+#include <afina/execute/Delete.h>
+#include <afina/execute/Gat.h>
 #include <afina/execute/Get.h>
+#include <afina/execute/Incr.h>
 #include <afina/execute/Set.h>
 #include <afina/execute/Stats.h>
+#include <afina/execute/Touch.h>
 
 #include <protocol/Parser.h>
 
@@ -27,11 +34,11 @@ TEST(MemcachedParserTest, SimpleSet) {
     ASSERT_EQ("set", parser.Name());
 
     size_t value_size;
-    std::unique_ptr<Execute::Command> cmd = parser.Build(value_size);
+    Execute::Command *cmd = parser.Build(value_size);
     ASSERT_FALSE(cmd == nullptr);
     ASSERT_EQ(6, value_size);
 
-    Execute::Set *tmp = reinterpret_cast<Execute::Set *>(cmd.get());
+    Execute::Set *tmp = reinterpret_cast<Execute::Set *>(cmd);
     ASSERT_EQ("foo", tmp->key());
     ASSERT_EQ(0, tmp->flags());
     ASSERT_EQ(0, tmp->expire());
@@ -48,16 +55,38 @@ TEST(MemcachedParserTest, SimpleAdd) {
     ASSERT_EQ("add", parser.Name());
 
     size_t value_size;
-    std::unique_ptr<Execute::Command> cmd = parser.Build(value_size);
+    Execute::Command *cmd = parser.Build(value_size);
     ASSERT_FALSE(cmd == nullptr);
     ASSERT_EQ(60, value_size);
 
-    Execute::Add *tmp = reinterpret_cast<Execute::Add *>(cmd.get());
+    Execute::Add *tmp = reinterpret_cast<Execute::Add *>(cmd);
     ASSERT_EQ("bar", tmp->key());
     ASSERT_EQ(10, tmp->flags());
     ASSERT_EQ(-1, tmp->expire());
 }
 
+// Verify multi digit expiration time
+TEST(MemcachedParserTest, SetExpire) {
+    Protocol::Parser parser;
+
+    size_t consumed = 0;
+    ASSERT_TRUE(parser.Parse("set foo 0 3600 6\r\nfooval\r\n", consumed));
+
+    size_t value_size;
+    Execute::Command *cmd = parser.Build(value_size);
+    ASSERT_FALSE(cmd == nullptr);
+    ASSERT_EQ(3600, reinterpret_cast<Execute::Set *>(cmd)->expire());
+
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse("set foo 0 -120 6\r\nfooval\r\n", consumed));
+    cmd = parser.Build(value_size);
+    ASSERT_FALSE(cmd == nullptr);
+    ASSERT_EQ(-120, reinterpret_cast<Execute::Set *>(cmd)->expire());
+
+    parser.Reset();
+    ASSERT_THROW(parser.Parse("set foo 0 99999999999 6\r\nfooval\r\n", consumed), std::runtime_error);
+}
+
 // Verify simple get command passed in a single string
 TEST(MemcachedParserTest, SimpleGet) {
     Protocol::Parser parser;
@@ -69,11 +98,11 @@ TEST(MemcachedParserTest, SimpleGet) {
     ASSERT_EQ("get", parser.Name());
 
     size_t value_size;
-    std::unique_ptr<Execute::Command> cmd = parser.Build(value_size);
+    Execute::Command *cmd = parser.Build(value_size);
     ASSERT_FALSE(cmd == nullptr);
     ASSERT_EQ(0, value_size);
 
-    Execute::Get *tmp = reinterpret_cast<Execute::Get *>(cmd.get());
+    Execute::Get *tmp = reinterpret_cast<Execute::Get *>(cmd);
     std::vector<std::string> keys = tmp->keys();
     ASSERT_EQ(3, keys.size());
     ASSERT_EQ("ke", keys[0]);
@@ -91,10 +120,206 @@ TEST(MemcachedParserTest, Stats) {
     ASSERT_EQ("stats", parser.Name());
 
     size_t value_size;
-    std::unique_ptr<Execute::Command> cmd = parser.Build(value_size);
+    Execute::Command *cmd = parser.Build(value_size);
     ASSERT_FALSE(cmd == nullptr);
     ASSERT_EQ(0, value_size);
 
-    Execute::Stats *tmp = reinterpret_cast<Execute::Stats *>(cmd.get());
+    Execute::Stats *tmp = reinterpret_cast<Execute::Stats *>(cmd);
     ASSERT_FALSE(tmp == nullptr);
+    ASSERT_TRUE(tmp->group() == Execute::Stats::Group::kGeneral);
+
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse("stats locks\r\n", consumed));
+    tmp = reinterpret_cast<Execute::Stats *>(parser.Build(value_size));
+    ASSERT_TRUE(tmp->group() == Execute::Stats::Group::kLocks);
+
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse("stats nonsense\r\n", consumed));
+    ASSERT_THROW(parser.Build(value_size), std::runtime_error);
+}
+
+// Verify command line split into pieces gives the same command as the one arrived at once
+TEST(MemcachedParserTest, SplitInput) {
+    const std::string lines[] = {"set some_long_key_to_cross_the_vector_stride 4294967295 -2147483648 1024\r\n",
+                                 "get a bb ccc dddd eeeee ffffff ggggggg hhhhhhhh iiiiiiiii jjjjjjjjjj\r\n",
+                                 "add k 1 2 3\r\n"};
+    for (const std::string &line : lines) {
+        Protocol::Parser whole;
+        size_t consumed = 0;
+        ASSERT_TRUE(whole.Parse(line, consumed));
+        ASSERT_EQ(line.size(), consumed);
+
+        Protocol::Parser split;
+        size_t total = 0;
+        bool cmd_avail = false;
+        for (size_t i = 0; i < line.size() && !cmd_avail; i++) {
+            cmd_avail = split.Parse(&line[i], 1, consumed);
+            total += consumed;
+        }
+        ASSERT_TRUE(cmd_avail);
+        ASSERT_EQ(line.size(), total);
+        ASSERT_EQ(whole.Name(), split.Name());
+
+        size_t whole_size, split_size;
+        Execute::Command *whole_cmd = whole.Build(whole_size);
+        Execute::Command *split_cmd = split.Build(split_size);
+        ASSERT_EQ(whole_size, split_size);
+        if (whole.Name() == "get") {
+            ASSERT_EQ(10, reinterpret_cast<Execute::Get *>(whole_cmd)->keys().size());
+            ASSERT_EQ(reinterpret_cast<Execute::Get *>(whole_cmd)->keys(),
+                      reinterpret_cast<Execute::Get *>(split_cmd)->keys());
+        } else {
+            Execute::Set *w = reinterpret_cast<Execute::Set *>(whole_cmd);
+            Execute::Set *s = reinterpret_cast<Execute::Set *>(split_cmd);
+            ASSERT_EQ(w->key(), s->key());
+            ASSERT_EQ(w->flags(), s->flags());
+            ASSERT_EQ(w->expire(), s->expire());
+        }
+    }
+}
+
+// Verify pipelined commands are taken one by one, incomplete line waits for the rest
+TEST(MemcachedParserTest, Pipelined) {
+    Protocol::Parser parser;
+    std::string input = "get a b\r\nset c 1 2 3\r\nabc\r\nget d";
+
+    size_t consumed = 0;
+    ASSERT_TRUE(parser.Parse(input, consumed));
+    ASSERT_EQ(9, consumed);
+    ASSERT_EQ("get", parser.Name());
+    input.erase(0, consumed);
+
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse(input, consumed));
+    ASSERT_EQ(13, consumed);
+    ASSERT_EQ("set", parser.Name());
+    input.erase(0, consumed + 5);
+
+    parser.Reset();
+    ASSERT_FALSE(parser.Parse(input, consumed));
+    ASSERT_EQ(5, consumed);
+    ASSERT_TRUE(parser.Parse("\r\n", consumed));
+
+    size_t value_size;
+    Execute::Command *cmd = parser.Build(value_size);
+    ASSERT_EQ(std::vector<std::string>{"d"}, reinterpret_cast<Execute::Get *>(cmd)->keys());
+}
+
+// Verify commands with words after the name, whole and split into pieces
+TEST(MemcachedParserTest, WordCommands) {
+    const std::string lines[] = {"delete foo\r\n", "incr foo 42\r\n", "decr foo 7\r\n", "touch foo -1\r\n",
+                                 "gat 100 foo bar\r\n", "gets foo\r\n"};
+    for (const std::string &line : lines) {
+        for (size_t chunk : {line.size(), size_t(1)}) {
+            Protocol::Parser parser;
+            size_t consumed = 0, total = 0;
+            bool cmd_avail = false;
+            for (size_t i = 0; i < line.size() && !cmd_avail; i += consumed) {
+                cmd_avail = parser.Parse(&line[i], std::min(chunk, line.size() - i), consumed);
+                total += consumed;
+            }
+            ASSERT_TRUE(cmd_avail);
+            ASSERT_EQ(line.size(), total);
+
+            size_t value_size;
+            Execute::Command *cmd = parser.Build(value_size);
+            ASSERT_EQ(0, value_size);
+            if (parser.Name() == "delete") {
+                ASSERT_EQ("foo", dynamic_cast<Execute::Delete *>(cmd)->key());
+            } else if (parser.Name() == "incr") {
+                ASSERT_EQ(42, dynamic_cast<Execute::Incr *>(cmd)->delta());
+            } else if (parser.Name() == "decr") {
+                ASSERT_EQ(7, dynamic_cast<Execute::Decr *>(cmd)->delta());
+            } else if (parser.Name() == "touch") {
+                ASSERT_EQ(-1, dynamic_cast<Execute::Touch *>(cmd)->expire());
+            } else if (parser.Name() == "gat") {
+                Execute::Gat *gat = dynamic_cast<Execute::Gat *>(cmd);
+                ASSERT_EQ(100, gat->expire());
+                ASSERT_EQ((std::vector<std::string>{"foo", "bar"}), gat->keys());
+            } else {
+                ASSERT_TRUE(dynamic_cast<Execute::Get *>(cmd)->with_cas());
+            }
+        }
+    }
+}
+
+// Verify cas unique is taken after the bytes
+TEST(MemcachedParserTest, Cas) {
+    const std::string line = "cas foo 1 2 3 18446744073709551615\r\n";
+    for (size_t chunk : {line.size(), size_t(1)}) {
+        Protocol::Parser parser;
+        size_t consumed = 0, total = 0;
+        bool cmd_avail = false;
+        for (size_t i = 0; i < line.size() && !cmd_avail; i += consumed) {
+            cmd_avail = parser.Parse(&line[i], std::min(chunk, line.size() - i), consumed);
+            total += consumed;
+        }
+        ASSERT_TRUE(cmd_avail);
+        ASSERT_EQ(line.size(), total);
+
+        size_t value_size;
+        Execute::Command *cmd = parser.Build(value_size);
+        ASSERT_EQ(3, value_size);
+        Execute::Cas *tmp = dynamic_cast<Execute::Cas *>(cmd);
+        ASSERT_FALSE(tmp == nullptr);
+        ASSERT_EQ("foo", tmp->key());
+        ASSERT_EQ(18446744073709551615ull, tmp->cas());
+    }
+}
+
+// Verify unknown command and missing arguments are reported
+TEST(MemcachedParserTest, Errors) {
+    Protocol::Parser parser;
+    size_t consumed = 0;
+    ASSERT_THROW(parser.Parse("flush_all\r\n", consumed), std::runtime_error);
+
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse("incr foo bar\r\n", consumed));
+    size_t value_size;
+    ASSERT_THROW(parser.Build(value_size), std::runtime_error);
+
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse("delete\r\n", consumed));
+    ASSERT_THROW(parser.Build(value_size), std::runtime_error);
+}
+
+// Verify command is made inside of the parser and references its keys
+TEST(MemcachedParserTest, CommandInPlace) {
+    Protocol::Parser parser;
+    size_t consumed = 0, value_size;
+    ASSERT_TRUE(parser.Parse("set some_key 0 0 1\r\n", consumed));
+    Execute::Command *first = parser.Build(value_size);
+    ASSERT_TRUE(reinterpret_cast<char *>(first) >= reinterpret_cast<char *>(&parser) &&
+                reinterpret_cast<char *>(first) < reinterpret_cast<char *>(&parser + 1));
+
+    parser.Reset();
+    ASSERT_TRUE(parser.Parse("get other_key\r\n", consumed));
+    Execute::Command *second = parser.Build(value_size);
+    ASSERT_EQ(first, second);
+    ASSERT_EQ(std::vector<std::string>{"other_key"}, reinterpret_cast<Execute::Get *>(second)->keys());
+}
+
+// Verify parser reports partial command and could switch protocol once cleared
+TEST(MemcachedParserTest, EmptyAndClear) {
+    Protocol::Parser parser;
+    ASSERT_TRUE(parser.Empty());
+
+    size_t consumed = 0, value_size;
+    ASSERT_FALSE(parser.Parse("get fo", consumed));
+    ASSERT_EQ(6, consumed);
+    ASSERT_FALSE(parser.Empty());
+    ASSERT_TRUE(parser.Parse("o\r\n", consumed));
+    parser.Build(value_size);
+    ASSERT_FALSE(parser.Empty());
+
+    parser.Reset();
+    ASSERT_TRUE(parser.Empty());
+
+    // Binary request goes to the text parser unless protocol is forgotten
+    std::string noop("\x80\x0a", 2);
+    noop.append(22, '\0');
+    parser.Clear();
+    ASSERT_TRUE(parser.Parse(noop, consumed));
+    ASSERT_EQ(24, consumed);
+    ASSERT_EQ("noop", parser.Name());
 }
@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+
+#include <unistd.h>
+
+#include <protocol/ReadBuffer.h>
+
+using namespace Afina;
+
+// Verify consumed bytes are skipped and data is moved to the front only when it runs out of room
+TEST(ReadBufferTest, ConsumeInPlace) {
+    Protocol::ReadBuffer buffer;
+    buffer.Append("get a\r\nget b\r\nge", 16);
+
+    const char *start = buffer.Data();
+    buffer.Consume(7);
+    ASSERT_EQ(start + 7, buffer.Data());
+    ASSERT_EQ("get b\r\nge", std::string(buffer.Data(), buffer.Size()));
+
+    buffer.Consume(7);
+    buffer.Append("t c\r\n", 5);
+    ASSERT_EQ("get c\r\n", std::string(buffer.Data(), buffer.Size()));
+
+    buffer.Consume(7);
+    ASSERT_TRUE(buffer.Empty());
+    ASSERT_EQ(start, buffer.Data());
+}
+
+// Verify large value is held in one piece and buffer gets back to pooled size once it is consumed
+TEST(ReadBufferTest, GrowAndShrink) {
+    Protocol::ReadBuffer buffer;
+    buffer.Append("set", 3);
+    ASSERT_TRUE(buffer.Reserve(3 * Protocol::ReadBuffer::kPooledSize));
+
+    std::string value(3 * Protocol::ReadBuffer::kPooledSize - 3, 'v');
+    const char *start = buffer.Data();
+    buffer.Append(value.data(), value.size());
+    ASSERT_EQ(start, buffer.Data());
+    ASSERT_EQ("set" + value, std::string(buffer.Data(), buffer.Size()));
+
+    ASSERT_FALSE(buffer.Reserve(Protocol::ReadBuffer::kMaxSize + 1));
+
+    buffer.Consume(buffer.Size());
+    ASSERT_TRUE(buffer.Empty());
+    ASSERT_TRUE(buffer.Reserve(Protocol::ReadBuffer::kPooledSize));
+}
+
+// Verify reads come after the data and command longer than max size is rejected
+TEST(ReadBufferTest, Read) {
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+
+    Protocol::ReadBuffer buffer;
+    ASSERT_EQ(4, write(fds[1], "set ", 4));
+    ASSERT_EQ(4, buffer.Read(fds[0]));
+    ASSERT_EQ(4, write(fds[1], "foo ", 4));
+    ASSERT_EQ(4, buffer.Read(fds[0]));
+    ASSERT_EQ("set foo ", std::string(buffer.Data(), buffer.Size()));
+
+    close(fds[0]);
+    close(fds[1]);
+
+    std::string line(Protocol::ReadBuffer::kMaxSize - buffer.Size(), 'k');
+    buffer.Append(line.data(), line.size());
+    ASSERT_THROW(buffer.Append("x", 1), std::runtime_error);
+    ASSERT_THROW(buffer.Read(0), std::runtime_error);
+}
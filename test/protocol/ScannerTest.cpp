@@ -0,0 +1,32 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <protocol/Scanner.h>
+
+using namespace Afina;
+
+// Verify delimiter is found at any position against vector strides, and the first one wins
+TEST(ScannerTest, FindDelimiter) {
+    for (size_t size = 0; size < 100; size++) {
+        std::string input(size, 'x');
+        ASSERT_EQ(input.data() + size, Protocol::FindDelimiter(input.data(), input.data() + size));
+
+        for (size_t pos = 0; pos < size; pos++) {
+            input[pos] = (pos % 2) ? ' ' : '\r';
+            if (pos + 1 < size) {
+                input[pos + 1] = ' ';
+            }
+            ASSERT_EQ(input.data() + pos, Protocol::FindDelimiter(input.data(), input.data() + size));
+            input.assign(size, 'x');
+        }
+    }
+}
+
+// Verify bytes after the end are never reported
+TEST(ScannerTest, StopsAtEnd) {
+    std::string input(64, 'x');
+    input[40] = ' ';
+    ASSERT_EQ(input.data() + 33, Protocol::FindDelimiter(input.data() + 1, input.data() + 33));
+    ASSERT_EQ(input.data() + 40, Protocol::FindDelimiter(input.data() + 1, input.data() + 64));
+}
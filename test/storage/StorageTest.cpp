@@ -1,16 +1,29 @@
 #include "gtest/gtest.h"
+#include <atomic>
 #include <iomanip>
 #include <iostream>
+#include <memory>
+#include <new>
 #include <set>
+#include <thread>
 #include <vector>
 
+#include <afina/allocator/Pointer.h>
+#include <afina/allocator/Simple.h>
 #include <afina/execute/Add.h>
 #include <afina/execute/Append.h>
 #include <afina/execute/Delete.h>
 #include <afina/execute/Get.h>
 #include <afina/execute/Set.h>
 
+#include "storage/FlatCombinedLRU.h"
+#include "storage/FrequencySketch.h"
+#include "storage/RCUClock.h"
+#include "storage/ShardedLRU.h"
+#include "storage/SharedClockLRU.h"
 #include "storage/SimpleLRU.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+#include "storage/TinyLFU.h"
 
 using namespace Afina::Backend;
 using namespace Afina::Execute;
@@ -147,7 +160,8 @@ std::string pad_space(const std::string &s, size_t length) {
 
 TEST(StorageTest, BigTest) {
     const size_t length = 20;
-    SimpleLRU storage(2 * 100000 * length);
+    // Each item takes node header and allocator slack in addition to key and value
+    SimpleLRU storage(8 * 100000 * length);
 
     for (long i = 0; i < 100000; ++i) {
         auto key = pad_space("Key " + std::to_string(i), length);
@@ -166,32 +180,724 @@ TEST(StorageTest, BigTest) {
     }
 }
 
+// Number of items of the given size memory area of SimpleLRU keeps: every item takes a chunk and a handle
+size_t Capacity(size_t max_size, size_t item_size) {
+    std::unique_ptr<char[]> area(new char[max_size]);
+    Afina::Allocator::Simple allocator(area.get(), max_size);
+    size_t count = 0;
+    while (allocator.alloc(item_size, std::nothrow).get() != nullptr) {
+        count++;
+    }
+    return count;
+}
+
 TEST(StorageTest, MaxTest) {
     const size_t length = 20;
-    SimpleLRU storage(2 * 1000 * length);
-
-    std::stringstream ss;
+    SimpleLRU storage(4 * 1000 * length);
 
-    for (long i = 0; i < 1100; ++i) {
+    for (long i = 0; i < 2000; ++i) {
         auto key = pad_space("Key " + std::to_string(i), length);
         auto val = pad_space("Val " + std::to_string(i), length);
         EXPECT_TRUE(storage.Put(key, val));
     }
 
-    for (long i = 100; i < 1100; ++i) {
+    // All items are of the same size class, so storage is full of them and the oldest ones are gone
+    long first = 2000 - Capacity(4 * 1000 * length, storage.ItemSize(length, length));
+    ASSERT_GT(first, 0);
+
+    std::string res;
+    for (long i = 0; i < first; ++i) {
+        EXPECT_FALSE(storage.Get(pad_space("Key " + std::to_string(i), length), res));
+    }
+    for (long i = first; i < 2000; ++i) {
         auto key = pad_space("Key " + std::to_string(i), length);
         auto val = pad_space("Val " + std::to_string(i), length);
 
-        std::string res;
         EXPECT_TRUE(storage.Get(key, res));
-
         EXPECT_TRUE(val == res);
     }
+}
+
+// Item of the size class that has no pages yet takes a single page, even if LRU order is scattered over all of them
+TEST(StorageTest, NewSizeClassTakesOnePage) {
+    SimpleLRU storage(64 * 1024);
+    const int n = 2000;
+    for (int i = 0; i < n; i++) {
+        EXPECT_TRUE(storage.Put("Key " + std::to_string(i), pad_space("Val", 20)));
+    }
+
+    // Reads go across the pages, so that the oldest items are spread over all of them
+    auto resident = [&storage]() {
+        size_t found = 0;
+        std::string res;
+        for (int r = 0; r < 64; r++) {
+            for (int i = r; i < n; i += 64) {
+                found += storage.Get("Key " + std::to_string(i), res);
+            }
+        }
+        return found;
+    };
+    size_t before = resident();
+    ASSERT_GT(before, 100);
+
+    std::string res;
+    EXPECT_TRUE(storage.Put("Large", std::string(1000, 'x')));
+    EXPECT_TRUE(storage.Get("Large", res));
+    EXPECT_GE(resident(), before - before / 8);
+}
+
+TEST(StorageTest, GetRefreshesLRU) {
+    const size_t length = 20;
+    SimpleLRU storage(4 * 1000 * length);
+
+    std::string res;
+    for (long i = 0; i < 2000; ++i) {
+        EXPECT_TRUE(storage.Put(pad_space("Key " + std::to_string(i), length), pad_space("Val", length)));
+        // Read of the first key makes it the freshest one again
+        EXPECT_TRUE(storage.Get(pad_space("Key 0", length), res));
+    }
+    EXPECT_FALSE(storage.Get(pad_space("Key 1", length), res));
+}
+
+TEST(StorageTest, ClockPolicy) {
+    const size_t length = 20;
+    SimpleLRU storage(4 * 1000 * length, EvictionPolicy::Type::kCLOCK);
+
+    std::string res;
+    for (long i = 0; i < 2000; ++i) {
+        EXPECT_TRUE(storage.Put(pad_space("Key " + std::to_string(i), length), pad_space("Val", length)));
+        // Referenced items survive the hand
+        EXPECT_TRUE(storage.Get(pad_space("Key " + std::to_string(i % 10), length), res));
+    }
+
+    size_t found = 0;
+    for (long i = 0; i < 2000; ++i) {
+        found += storage.Get(pad_space("Key " + std::to_string(i), length), res);
+    }
+    EXPECT_GT(found, 10);
+    EXPECT_LT(found, 2000);
+    EXPECT_TRUE(storage.Get(pad_space("Key 1999", length), res));
+
+    EXPECT_TRUE(storage.Delete(pad_space("Key 1999", length)));
+    EXPECT_TRUE(storage.Put(pad_space("Key 5", length), pad_space("Longer value than before", 2 * length)));
+    EXPECT_TRUE(storage.Get(pad_space("Key 5", length), res));
+    EXPECT_TRUE(res == pad_space("Longer value than before", 2 * length));
+}
 
-    for (long i = 0; i < 100; ++i) {
+TEST(StorageTest, ShardedPutGetDelete) {
+    ShardedLRU storage(4 * 1024, 4);
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.PutIfAbsent("KEY2", "val2"));
+    EXPECT_FALSE(storage.PutIfAbsent("KEY2", "val3"));
+    EXPECT_TRUE(storage.Set("KEY1", "val11"));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_TRUE(value == "val11");
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_TRUE(value == "val2");
+
+    EXPECT_TRUE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Get("KEY1", value));
+}
+
+TEST(StorageTest, ShardedMaxSize) {
+    const size_t length = 20;
+    const size_t shards = 8;
+    ShardedLRU storage(4 * 1000 * length, shards);
+
+    for (long i = 0; i < 2000; ++i) {
         auto key = pad_space("Key " + std::to_string(i), length);
+        auto val = pad_space("Val " + std::to_string(i), length);
+        EXPECT_TRUE(storage.Put(key, val));
+    }
+
+    // Every shard gets far more keys than it holds, so each one is full with its part of the budget
+    const size_t shard_size = 4 * 1000 * length / shards;
+    const size_t per_shard = Capacity(shard_size, SimpleLRU(shard_size).ItemSize(length, length));
+    ASSERT_LT(per_shard * 2, 2000 / shards);
+
+    size_t found = 0;
+    std::string res;
+    for (long i = 0; i < 2000; ++i) {
+        found += storage.Get(pad_space("Key " + std::to_string(i), length), res);
+    }
+    EXPECT_EQ(shards * per_shard, found);
+
+    // No shard gets more than per_shard of the newest per_shard keys, so all of them survive
+    for (long i = 2000 - per_shard; i < 2000; ++i) {
+        EXPECT_TRUE(storage.Get(pad_space("Key " + std::to_string(i), length), res));
+    }
+}
+
+TEST(StorageTest, MemoryTooSmall) {
+    EXPECT_THROW(SimpleLRU(SimpleLRU::kMinSize - 1), std::invalid_argument);
+    EXPECT_THROW(ShardedLRU(1024, 32), std::invalid_argument);
+    EXPECT_THROW(TinyLFU(1024), std::invalid_argument);
+
+    // Smallest storage allowed keeps every shard usable
+    ShardedLRU storage(32 * SimpleLRU::kMinSize, 32);
+    for (int i = 0; i < 1000; i++) {
+        EXPECT_TRUE(storage.Put("Key " + std::to_string(i), "val"));
+    }
+    size_t found = 0;
+    for (int i = 0; i < 1000; i++) {
+        std::string value;
+        found += storage.Get("Key " + std::to_string(i), value);
+    }
+    EXPECT_GT(found, 32);
+}
+
+TEST(StorageTest, ShardedConcurrent) {
+    const int n_threads = 4;
+    const int n_keys = 1000;
+    ShardedLRU storage(n_threads * n_keys * 256, 16);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < n_threads; t++) {
+        threads.emplace_back([&storage, t]() {
+            for (int i = 0; i < n_keys; i++) {
+                std::string key = "Key " + std::to_string(t) + " " + std::to_string(i);
+                storage.Put(key, "Val " + std::to_string(i));
+                std::string value;
+                storage.Get(key, value);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    for (int t = 0; t < n_threads; t++) {
+        for (int i = 0; i < n_keys; i++) {
+            std::string value;
+            EXPECT_TRUE(storage.Get("Key " + std::to_string(t) + " " + std::to_string(i), value));
+            EXPECT_TRUE(value == "Val " + std::to_string(i));
+        }
+    }
+}
+
+TEST(StorageTest, FlatCombinedConcurrent) {
+    const int n_threads = 8;
+    const int n_keys = 1000;
+    FlatCombinedLRU storage(n_threads * n_keys * 256);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < n_threads; t++) {
+        threads.emplace_back([&storage, t]() {
+            for (int i = 0; i < n_keys; i++) {
+                std::string key = "Key " + std::to_string(t) + " " + std::to_string(i);
+                EXPECT_TRUE(storage.Put(key, "Val " + std::to_string(i)));
+                std::string value;
+                EXPECT_TRUE(storage.Get(key, value));
+                if (i % 2 == 1) {
+                    EXPECT_TRUE(storage.Delete(key));
+                }
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    for (int t = 0; t < n_threads; t++) {
+        for (int i = 0; i < n_keys; i++) {
+            std::string value;
+            EXPECT_EQ(i % 2 == 0, storage.Get("Key " + std::to_string(t) + " " + std::to_string(i), value));
+            EXPECT_TRUE(i % 2 == 1 || value == "Val " + std::to_string(i));
+        }
+    }
+}
+
+// Request that throws fails its own publisher only, the rest of the batch and later ones go on
+TEST(StorageTest, FlatCombinedThrows) {
+    const int n_threads = 4;
+    const int n_keys = 500;
+    FlatCombinedLRU storage(n_threads * n_keys * 256);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < n_threads; t++) {
+        threads.emplace_back([&storage, t]() {
+            for (int i = 0; i < n_keys; i++) {
+                std::string key = "Key " + std::to_string(t) + " " + std::to_string(i);
+                EXPECT_TRUE(storage.Put(key, "Val"));
+                EXPECT_THROW(storage.Modify(key,
+                                            [](std::string &) -> bool {
+                                                throw std::bad_alloc();
+                                            }),
+                             std::bad_alloc);
+                EXPECT_TRUE(storage.Modify(key, [](std::string &value) {
+                    value += "!";
+                    return true;
+                }));
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    for (int t = 0; t < n_threads; t++) {
+        for (int i = 0; i < n_keys; i++) {
+            std::string value;
+            EXPECT_TRUE(storage.Get("Key " + std::to_string(t) + " " + std::to_string(i), value));
+            EXPECT_EQ("Val!", value);
+        }
+    }
+}
+
+TEST(StorageTest, SharedClockReadsKeepItems) {
+    const size_t length = 20;
+    SharedClockLRU storage(4 * 1000 * length);
+
+    // Shared reads set reference bit just like exclusive ones, so read items survive the hand
+    std::string res;
+    for (long i = 0; i < 2000; ++i) {
+        EXPECT_TRUE(storage.Put(pad_space("Key " + std::to_string(i), length), pad_space("Val", length)));
+        EXPECT_TRUE(storage.Get(pad_space("Key " + std::to_string(i % 10), length), res));
+    }
+    for (long i = 0; i < 10; ++i) {
+        EXPECT_TRUE(storage.Get(pad_space("Key " + std::to_string(i), length), res));
+    }
+    EXPECT_FALSE(storage.Get(pad_space("Key 10", length), res));
 
+    // Expired item is invisible for reads until write removes it
+    EXPECT_TRUE(storage.Put("expired", "val", 0, -1));
+    EXPECT_FALSE(storage.Get("expired", res));
+    EXPECT_TRUE(storage.PutIfAbsent("expired", "val"));
+}
+
+TEST(StorageTest, SharedClockConcurrent) {
+    const int n_writers = 4;
+    const int n_readers = 4;
+    const int n_keys = 1000;
+    SharedClockLRU storage(n_writers * n_keys * 256);
+
+    std::atomic<int> writers_left(n_writers);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < n_writers; t++) {
+        threads.emplace_back([&storage, &writers_left, t]() {
+            for (int i = 0; i < n_keys; i++) {
+                std::string key = "Key " + std::to_string(t) + " " + std::to_string(i);
+                EXPECT_TRUE(storage.Put(key, "Val " + std::to_string(i)));
+                if (i % 2 == 1) {
+                    EXPECT_TRUE(storage.Delete(key));
+                }
+            }
+            writers_left--;
+        });
+    }
+    for (int t = 0; t < n_readers; t++) {
+        threads.emplace_back([&storage, &writers_left, t]() {
+            // Value is either missing or complete
+            std::string value;
+            for (int i = 0; writers_left.load() > 0; i = (i + 1) % n_keys) {
+                if (storage.Get("Key " + std::to_string(t) + " " + std::to_string(i), value)) {
+                    EXPECT_EQ("Val " + std::to_string(i), value);
+                }
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    for (int t = 0; t < n_writers; t++) {
+        for (int i = 0; i < n_keys; i++) {
+            std::string value;
+            EXPECT_EQ(i % 2 == 0, storage.Get("Key " + std::to_string(t) + " " + std::to_string(i), value));
+        }
+    }
+}
+
+TEST(StorageTest, DeleteReinsert) {
+    const size_t length = 20;
+    SimpleLRU storage(8 * 10000 * length);
+
+    for (long i = 0; i < 10000; ++i) {
+        EXPECT_TRUE(storage.Put(pad_space("Key " + std::to_string(i), length), pad_space("Val", length)));
+    }
+
+    // Removal shifts neighbours in the index, all of the rest must be reachable
+    for (long i = 0; i < 10000; i += 3) {
+        EXPECT_TRUE(storage.Delete(pad_space("Key " + std::to_string(i), length)));
+    }
+
+    for (long i = 0; i < 10000; ++i) {
+        std::string res;
+        EXPECT_EQ(i % 3 != 0, storage.Get(pad_space("Key " + std::to_string(i), length), res));
+    }
+
+    // Deleted entries must free space
+    for (long i = 0; i < 10000; i += 3) {
+        EXPECT_TRUE(storage.PutIfAbsent(pad_space("Key " + std::to_string(i), length), pad_space("Val", length)));
+    }
+
+    for (long i = 0; i < 10000; ++i) {
         std::string res;
-        EXPECT_FALSE(storage.Get(key, res));
+        EXPECT_TRUE(storage.Get(pad_space("Key " + std::to_string(i), length), res));
+    }
+}
+
+TEST(StorageTest, RCUPutGetDelete) {
+    RCUClock storage(1024);
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.PutIfAbsent("KEY2", "val2"));
+    EXPECT_FALSE(storage.PutIfAbsent("KEY2", "val3"));
+    EXPECT_TRUE(storage.Set("KEY1", "val11"));
+    EXPECT_FALSE(storage.Set("KEY3", "val3"));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_TRUE(value == "val11");
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_TRUE(value == "val2");
+
+    EXPECT_TRUE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Get("KEY1", value));
+    EXPECT_TRUE(storage.Get("KEY2", value));
+}
+
+TEST(StorageTest, RCUMaxSize) {
+    const size_t length = 20;
+    RCUClock storage(2 * 1000 * length);
+
+    for (long i = 0; i < 10000; ++i) {
+        auto key = pad_space("Key " + std::to_string(i), length);
+        auto val = pad_space("Val " + std::to_string(i), length);
+        EXPECT_TRUE(storage.Put(key, val));
+
+        // Keep first keys hot, CLOCK must give them second chance
+        std::string res;
+        storage.Get(pad_space("Key " + std::to_string(i % 10), length), res);
+    }
+
+    size_t found = 0, hot = 0;
+    for (long i = 0; i < 10000; ++i) {
+        std::string res;
+        if (storage.Get(pad_space("Key " + std::to_string(i), length), res)) {
+            EXPECT_TRUE(res == pad_space("Val " + std::to_string(i), length));
+            found++;
+            hot += i < 10;
+        }
+    }
+    EXPECT_LE(found, 1000);
+    EXPECT_GT(found, 0);
+    EXPECT_EQ(hot, 10);
+}
+
+TEST(StorageTest, RCUConcurrentReaders) {
+    const int n_readers = 4;
+    const int n_keys = 100;
+    RCUClock storage(n_keys * 64);
+
+    std::atomic<bool> stop(false);
+    std::atomic<long> broken(0);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < n_readers; t++) {
+        readers.emplace_back([&]() {
+            while (!stop.load()) {
+                for (int i = 0; i < n_keys; i++) {
+                    std::string key = "Key " + std::to_string(i);
+                    std::string value;
+                    // Value is replaced as a whole, so reader never sees a mix of versions
+                    if (storage.Get(key, value) && value.compare(0, key.size() + 1, key + ":") != 0) {
+                        broken++;
+                    }
+                }
+            }
+        });
+    }
+
+    // Writer overwrites, deletes and evicts under readers
+    for (int round = 0; round < 200; round++) {
+        for (int i = 0; i < n_keys; i++) {
+            std::string key = "Key " + std::to_string(i);
+            if ((i + round) % 7 == 0) {
+                storage.Delete(key);
+            } else {
+                storage.Put(key, key + ":" + std::string(round % 40, 'x'));
+            }
+        }
+    }
+    stop.store(true);
+    for (auto &t : readers) {
+        t.join();
+    }
+    EXPECT_EQ(broken.load(), 0);
+}
+
+TEST(StorageTest, TinyLFUPutGetDelete) {
+    TinyLFU storage(2 * 1024);
+
+    EXPECT_TRUE(storage.Put("KEY1", "val1"));
+    EXPECT_TRUE(storage.PutIfAbsent("KEY2", "val2"));
+    EXPECT_FALSE(storage.PutIfAbsent("KEY2", "val3"));
+    EXPECT_TRUE(storage.Set("KEY1", "val11"));
+    EXPECT_FALSE(storage.Set("KEY3", "val3"));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("KEY1", value));
+    EXPECT_TRUE(value == "val11");
+    EXPECT_TRUE(storage.Get("KEY2", value));
+    EXPECT_TRUE(value == "val2");
+
+    EXPECT_TRUE(storage.Delete("KEY1"));
+    EXPECT_FALSE(storage.Get("KEY1", value));
+}
+
+TEST(StorageTest, FrequencySketchRows) {
+    FrequencySketch sketch(1024);
+    for (int i = 0; i < 15; i++) {
+        sketch.Increment(1);
+    }
+    EXPECT_EQ(15, sketch.Frequency(1));
+
+    // Sharing a counter in one row doesn't make key share it in the others, so nobody inherits hot count
+    size_t inherited = 0;
+    for (uint64_t hash = 2; hash < 1000000; hash++) {
+        inherited += sketch.Frequency(hash) != 0;
+    }
+    EXPECT_EQ(0, inherited);
+}
+
+TEST(StorageTest, AdmissionSkipsUpdates) {
+    SimpleLRU storage(4 * 1024);
+    for (int i = 0; i < 100; i++) {
+        EXPECT_TRUE(storage.Put("Key " + std::to_string(i), "val"));
+    }
+    storage.SetAdmissionFilter([](const std::string &candidate, const std::string &victim) { return false; });
+
+    // Storage is full, so larger value of the existing key needs evictions that filter would reject
+    std::string value;
+    EXPECT_FALSE(storage.Put("New key", "val"));
+    EXPECT_TRUE(storage.Put("Key 99", std::string(500, 'x')));
+    EXPECT_TRUE(storage.Get("Key 99", value));
+    EXPECT_EQ(std::string(500, 'x'), value);
+    EXPECT_TRUE(storage.Set("Key 99", std::string(1000, 'y')));
+    EXPECT_TRUE(storage.Get("Key 99", value));
+    EXPECT_EQ(std::string(1000, 'y'), value);
+}
+
+TEST(StorageTest, TinyLFUScanResistance) {
+    const size_t length = 20;
+    const long hot = 200;
+    TinyLFU storage(8 * 1000 * length);
+
+    std::string res;
+    for (int round = 0; round < 5; round++) {
+        for (long i = 0; i < hot; ++i) {
+            auto key = pad_space("Hot " + std::to_string(i), length);
+            if (!storage.Get(key, res)) {
+                EXPECT_TRUE(storage.Put(key, pad_space("Val", length)));
+            }
+        }
+    }
+
+    // Single pass over cold keys must not wash out frequently used ones
+    for (long i = 0; i < 10000; ++i) {
+        EXPECT_TRUE(storage.Put(pad_space("Cold " + std::to_string(i), length), pad_space("Val", length)));
+    }
+
+    long found = 0;
+    for (long i = 0; i < hot; ++i) {
+        found += storage.Get(pad_space("Hot " + std::to_string(i), length), res);
+    }
+    EXPECT_GT(found, hot * 9 / 10);
+}
+
+TEST(StorageTest, ExpireRelative) {
+    uint32_t now = 1000;
+    SimpleLRU storage(1024 * 64);
+    storage.SetClock([&now]() { return now; });
+
+    EXPECT_TRUE(storage.Put("short", "val", 0, 10));
+    EXPECT_TRUE(storage.Put("long", "val", 0, 5000));
+    EXPECT_TRUE(storage.Put("forever", "val"));
+
+    std::string value;
+    now += 9;
+    EXPECT_TRUE(storage.Get("short", value));
+    now += 1;
+    EXPECT_FALSE(storage.Get("short", value));
+    EXPECT_FALSE(storage.Set("short", "val"));
+    EXPECT_TRUE(storage.PutIfAbsent("short", "val2"));
+    EXPECT_TRUE(storage.Get("short", value));
+    EXPECT_TRUE(value == "val2");
+
+    // Timer of the long key goes through upper levels of the wheel and must not fire early
+    now = 1000 + 4999;
+    EXPECT_EQ(0, storage.Reap(100));
+    EXPECT_TRUE(storage.Get("long", value));
+    now += 1;
+    EXPECT_EQ(1, storage.Reap(100));
+    EXPECT_FALSE(storage.Get("long", value));
+
+    now += 100000000;
+    EXPECT_TRUE(storage.Get("forever", value));
+}
+
+TEST(StorageTest, ExpireAbsoluteAndNegative) {
+    uint32_t now = 100000000;
+    SimpleLRU storage(1024 * 64);
+    storage.SetClock([&now]() { return now; });
+
+    EXPECT_TRUE(storage.Put("abs", "val", 0, now + 100));
+    EXPECT_TRUE(storage.Put("neg", "val"));
+    EXPECT_TRUE(storage.Put("neg", "val", 0, -1));
+
+    std::string value;
+    EXPECT_FALSE(storage.Get("neg", value));
+    EXPECT_TRUE(storage.Get("abs", value));
+    now += 100;
+    EXPECT_FALSE(storage.Get("abs", value));
+    EXPECT_FALSE(storage.Delete("abs"));
+}
+
+TEST(StorageTest, ExpireReap) {
+    uint32_t now = 1000;
+    SimpleLRU storage(1024 * 1024);
+    storage.SetClock([&now]() { return now; });
+
+    for (int i = 0; i < 1000; i++) {
+        EXPECT_TRUE(storage.Put("Key " + std::to_string(i), "val", 0, 1 + i % 100));
+    }
+
+    // Reaping is incremental: no more than requested at once
+    now += 200;
+    EXPECT_EQ(100, storage.Reap(100));
+    EXPECT_EQ(900, storage.Reap(10000));
+    EXPECT_EQ(0, storage.Reap(10000));
+}
+
+TEST(StorageTest, ExpireBackground) {
+    std::atomic<uint32_t> now(1000);
+    ThreadSafeSimplLRU storage(1024 * 1024);
+    storage.SetClock([&now]() { return now.load(); });
+
+    for (int i = 0; i < 1000; i++) {
+        EXPECT_TRUE(storage.Put("Key " + std::to_string(i), "val", 0, 10));
+    }
+    now += 10;
+
+    storage.Start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    storage.Stop();
+    EXPECT_EQ(0, storage.Reap(10000));
+}
+
+TEST(StorageTest, ThreadSafeShortForms) {
+    ThreadSafeSimplLRU storage(1024);
+    std::string value;
+
+    EXPECT_TRUE(storage.Put("key", "val"));
+    EXPECT_FALSE(storage.PutIfAbsent("key", "val"));
+    EXPECT_TRUE(storage.Set("key", "new"));
+    EXPECT_TRUE(storage.Get("key", value));
+    EXPECT_EQ("new", value);
+}
+
+TEST(StorageTest, ExpireOtherStorages) {
+    RCUClock rcu(1024);
+    ShardedLRU sharded(1024 * 64, 4);
+    TinyLFU tiny(1024 * 64);
+    SharedClockLRU shared(1024 * 64);
+
+    std::vector<Afina::Storage *> storages = {&rcu, &sharded, &tiny, &shared};
+    for (auto storage : storages) {
+        std::string value;
+        EXPECT_TRUE(storage->Put("key", "val", 0, 3600));
+        EXPECT_TRUE(storage->Get("key", value));
+        EXPECT_FALSE(storage->PutIfAbsent("key", "val", 0, 3600));
+
+        EXPECT_TRUE(storage->Set("key", "val", 0, -1));
+        EXPECT_FALSE(storage->Get("key", value));
+        EXPECT_TRUE(storage->PutIfAbsent("key", "val", 0, 3600));
+        EXPECT_TRUE(storage->Get("key", value));
+    }
+}
+
+TEST(StorageTest, Metadata) {
+    SimpleLRU simple(1024 * 64);
+    RCUClock rcu(1024);
+    ShardedLRU sharded(1024 * 64, 4);
+    TinyLFU tiny(1024 * 64);
+    SharedClockLRU shared(1024 * 64);
+
+    std::vector<Afina::Storage *> storages = {&simple, &rcu, &sharded, &tiny, &shared};
+    for (auto storage : storages) {
+        std::string value;
+        Afina::ItemMeta meta;
+        EXPECT_TRUE(storage->Put("key", "val", 0xdeadbeef, 3600));
+        EXPECT_TRUE(storage->Get("key", value, meta));
+        EXPECT_EQ(0xdeadbeef, meta.flags);
+        EXPECT_NE(0, meta.deadline);
+
+        // Every update gets a new version
+        uint64_t cas = meta.cas;
+        EXPECT_TRUE(storage->Set("key", "longer value", 7, 0));
+        EXPECT_TRUE(storage->Get("key", value, meta));
+        EXPECT_TRUE(value == "longer value");
+        EXPECT_EQ(7, meta.flags);
+        EXPECT_EQ(0, meta.deadline);
+        EXPECT_NE(cas, meta.cas);
+
+        // Plain Put drops flags
+        EXPECT_TRUE(storage->Put("key", "val"));
+        EXPECT_TRUE(storage->Get("key", value, meta));
+        EXPECT_EQ(0, meta.flags);
+    }
+}
+
+TEST(StorageTest, MetadataSurvivesAdmission) {
+    TinyLFU storage(1024 * 64);
+
+    // Push the key out of the window into the main storage
+    EXPECT_TRUE(storage.Put("key", "val", 42, 3600));
+    for (int i = 0; i < 200; i++) {
+        EXPECT_TRUE(storage.Put("Key " + std::to_string(i), "val"));
+    }
+
+    std::string value;
+    Afina::ItemMeta meta;
+    ASSERT_TRUE(storage.Get("key", value, meta));
+    EXPECT_EQ(42, meta.flags);
+    EXPECT_NE(0, meta.deadline);
+}
+
+TEST(StorageTest, MultiGet) {
+    SimpleLRU simple(1024 * 64);
+    ThreadSafeSimplLRU safe(1024 * 64);
+    ShardedLRU sharded(1024 * 64, 4);
+    RCUClock rcu(1024 * 64);
+    TinyLFU tiny(1024 * 64);
+    FlatCombinedLRU combined(1024 * 64);
+    SharedClockLRU shared(1024 * 64);
+
+    // Batch longer than prefetch distance, with misses and a duplicate
+    std::vector<std::string> keys;
+    for (int i = 0; i < 40; i++) {
+        keys.push_back("Key " + std::to_string(i));
+    }
+    keys.push_back("Key 3");
+
+    std::vector<Afina::Storage *> storages = {&simple, &safe, &sharded, &rcu, &tiny, &combined, &shared};
+    for (auto storage : storages) {
+        for (int i = 0; i < 40; i += 2) {
+            EXPECT_TRUE(storage->Put("Key " + std::to_string(i), "val" + std::to_string(i), i, 0));
+        }
+
+        std::vector<std::string> found(keys.size());
+        storage->MultiGet(keys.data(), keys.size(), [&](size_t i, Afina::ValueRef &value, const Afina::ItemMeta &meta) {
+            EXPECT_TRUE(found[i].empty());
+            found[i] = std::string(value.data(), value.size()) + "/" + std::to_string(meta.flags);
+        });
+        for (int i = 0; i < 40; i++) {
+            EXPECT_EQ(i % 2 == 0 ? "val" + std::to_string(i) + "/" + std::to_string(i) : "", found[i]);
+        }
+        EXPECT_EQ("", found[40]);
     }
 }